@@ -0,0 +1,70 @@
+/**
+ * HexCore Better-SQLite3 - Benchmark Harness
+ * Times individual operations and reports ops/sec, latency percentiles and RSS
+ */
+
+'use strict';
+
+const DEFAULT_DURATION_MS = 1000;
+// Untimed calls cover about this many operations (opsPerCall each), so
+// large cases are not warmed far longer than they are measured
+const WARMUP_OPS = 10000;
+const MIN_WARMUP = 3;
+
+const percentile = (sorted, p) => {
+	if (!sorted.length) return 0;
+	const idx = Math.min(sorted.length - 1, Math.ceil((p / 100) * sorted.length) - 1);
+	return sorted[Math.max(0, idx)];
+};
+
+/**
+ * Runs `fn` repeatedly for `durationMs` (after `warmup` untimed calls, by
+ * default enough for WARMUP_OPS operations) and returns a JSON-serializable
+ * result. `opsPerCall` scales throughput for
+ * cases where one call performs several logical operations (e.g. a batch).
+ */
+function measure(name, fn, options = {}) {
+	const durationMs = options.durationMs || DEFAULT_DURATION_MS;
+	const maxIterations = options.maxIterations || Infinity;
+	const opsPerCall = options.opsPerCall || 1;
+	const warmup = 'warmup' in options ? options.warmup : Math.max(MIN_WARMUP, Math.ceil(WARMUP_OPS / opsPerCall));
+
+	for (let i = 0; i < warmup; i++) fn(i);
+	if (global.gc) global.gc();
+
+	const rssBefore = process.memoryUsage().rss;
+	const samples = [];
+	const budget = BigInt(durationMs) * 1000000n;
+	const start = process.hrtime.bigint();
+	let elapsed = 0n;
+	let i = 0;
+	while (elapsed < budget && i < maxIterations) {
+		const t0 = process.hrtime.bigint();
+		fn(i++);
+		const t1 = process.hrtime.bigint();
+		samples.push(Number(t1 - t0));
+		elapsed = t1 - start;
+	}
+	const rssAfter = process.memoryUsage().rss;
+
+	samples.sort((a, b) => a - b);
+	const totalNs = Number(elapsed);
+	return {
+		name,
+		iterations: samples.length,
+		opsPerCall,
+		opsPerSec: totalNs > 0 ? (samples.length * opsPerCall) / (totalNs / 1e9) : 0,
+		latencyNs: {
+			p50: percentile(samples, 50),
+			p99: percentile(samples, 99),
+			min: samples[0] || 0,
+			max: samples[samples.length - 1] || 0,
+		},
+		rss: {
+			before: rssBefore,
+			after: rssAfter,
+		},
+	};
+}
+
+module.exports = { measure };
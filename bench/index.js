@@ -0,0 +1,156 @@
+/**
+ * HexCore Better-SQLite3 - Benchmark Suite
+ * Hot paths of the native binding; prints machine-readable JSON
+ *
+ * Usage: npm run bench [-- --filter <substring>] [--duration <ms>] [--out <file>]
+ */
+
+'use strict';
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { measure } = require('./harness');
+
+let sqlite;
+try {
+	sqlite = require('..');
+} catch (e) {
+	console.error('Native module not built yet. Run `npm run build` first.');
+	console.error('Error:', e.message);
+	process.exit(1);
+}
+
+const { openDatabase } = sqlite;
+
+// ---------------------------------------------------------------------------
+// Arguments
+// ---------------------------------------------------------------------------
+const args = process.argv.slice(2);
+const argValue = (flag, fallback) => {
+	const idx = args.indexOf(flag);
+	return idx >= 0 && idx + 1 < args.length ? args[idx + 1] : fallback;
+};
+const filter = argValue('--filter', '');
+const durationMs = Number(argValue('--duration', 1000));
+const outFile = argValue('--out', null);
+
+// ---------------------------------------------------------------------------
+// Fixtures
+// ---------------------------------------------------------------------------
+const TEXT_1K = 'x'.repeat(1024);
+const TEXT_1M = 'y'.repeat(1024 * 1024);
+const BLOB_1M = Buffer.alloc(1024 * 1024, 0xab);
+
+// WAL cases run on a temporary file (journal_mode has no effect in memory);
+// the directory is removed with the database
+function createDatabase(wal) {
+	const dir = wal ? fs.mkdtempSync(path.join(os.tmpdir(), 'hexcore-bench-')) : null;
+	const db = openDatabase(dir ? path.join(dir, 'bench.db') : ':memory:');
+	if (dir) db.exec('PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL');
+	db.exec(`
+		CREATE TABLE kv (id INTEGER PRIMARY KEY, category TEXT NOT NULL, value TEXT NOT NULL, n INTEGER NOT NULL);
+		CREATE TABLE blobs (id INTEGER PRIMARY KEY, data BLOB, body TEXT);
+	`);
+	return { db, dir };
+}
+
+function fill(db, rows) {
+	db.exec('DELETE FROM kv');
+	const insert = db.prepare('INSERT INTO kv (id, category, value, n) VALUES (?, ?, ?, ?)');
+	db.transaction(() => {
+		for (let i = 1; i <= rows; i++) insert.run(i, `cat${i % 16}`, `value-${i}`, i);
+	})();
+}
+
+// ---------------------------------------------------------------------------
+// Cases
+// ---------------------------------------------------------------------------
+const cases = [];
+const bench = (name, setup, options = {}) => cases.push({ name, setup, wal: !!options.wal });
+
+bench('run/insert-single', (db) => {
+	const stmt = db.prepare('INSERT INTO kv (category, value, n) VALUES (?, ?, ?)');
+	return { fn: (i) => stmt.run('cat', TEXT_1K.slice(0, 32), i) };
+}, { wal: true });
+
+bench('run/insert-batch-1000-tx', (db) => {
+	const stmt = db.prepare('INSERT INTO kv (category, value, n) VALUES (?, ?, ?)');
+	const batch = db.transaction((base) => {
+		for (let i = 0; i < 1000; i++) stmt.run('cat', 'value', base + i);
+	});
+	return { fn: (i) => batch(i * 1000), opsPerCall: 1000 };
+}, { wal: true });
+
+bench('get/primary-key', (db) => {
+	fill(db, 10000);
+	const stmt = db.prepare('SELECT * FROM kv WHERE id = ?');
+	return { fn: (i) => stmt.get((i % 10000) + 1) };
+});
+
+for (const rows of [10, 1000, 100000]) {
+	for (const raw of [false, true]) {
+		bench(`all/${rows}-rows-${raw ? 'raw' : 'object'}`, (db) => {
+			fill(db, rows);
+			const stmt = db.prepare('SELECT * FROM kv').raw(raw);
+			return { fn: () => stmt.all(), opsPerCall: rows, maxIterations: rows >= 100000 ? 50 : Infinity };
+		});
+	}
+}
+
+bench('get/blob-1mb', (db) => {
+	db.prepare('INSERT INTO blobs (id, data) VALUES (1, ?)').run(BLOB_1M);
+	const stmt = db.prepare('SELECT data FROM blobs WHERE id = 1');
+	return { fn: () => stmt.get() };
+});
+
+bench('get/text-1mb', (db) => {
+	db.prepare('INSERT INTO blobs (id, body) VALUES (1, ?)').run(TEXT_1M);
+	const stmt = db.prepare('SELECT body FROM blobs WHERE id = 1');
+	return { fn: () => stmt.get() };
+});
+
+bench('bind/positional', (db) => {
+	const stmt = db.prepare('SELECT ? AS a, ? AS b, ? AS c, ? AS d');
+	return { fn: (i) => stmt.get(i, 'text', 1.5, null) };
+});
+
+bench('bind/named', (db) => {
+	const stmt = db.prepare('SELECT @a AS a, @b AS b, @c AS c, @d AS d');
+	return { fn: (i) => stmt.get({ a: i, b: 'text', c: 1.5, d: null }) };
+});
+
+bench('prepare/simple', (db) => {
+	return { fn: () => db.prepare('SELECT id, value FROM kv WHERE category = ? AND n > ?') };
+});
+
+// ---------------------------------------------------------------------------
+// Run
+// ---------------------------------------------------------------------------
+const results = [];
+for (const { name, setup, wal } of cases) {
+	if (filter && !name.includes(filter)) continue;
+	const { db, dir } = createDatabase(wal);
+	try {
+		const { fn, opsPerCall, maxIterations } = setup(db);
+		results.push(measure(name, fn, { durationMs, opsPerCall, maxIterations }));
+	} finally {
+		db.close();
+		if (dir) fs.rmSync(dir, { recursive: true, force: true });
+	}
+	process.stderr.write(`${name} done\n`);
+}
+
+const report = {
+	timestamp: new Date().toISOString(),
+	node: process.version,
+	platform: `${process.platform}-${process.arch}`,
+	cpu: os.cpus()[0] ? os.cpus()[0].model : 'unknown',
+	native: sqlite.resolveNativeBinaryPath() || null,
+	durationMs,
+	results,
+};
+
+const json = JSON.stringify(report, null, 2);
+if (outFile) fs.writeFileSync(outFile, json + '\n');
+console.log(json);
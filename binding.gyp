@@ -1,9 +1,32 @@
 {
+  "variables": {
+    "hexcore_lto%": "false",
+    "hexcore_pgo%": "off",
+    "hexcore_pgo_clang%": "false",
+    "hexcore_pgo_dir%": "<(module_root_dir)/.pgo"
+  },
   "targets": [{
     "target_name": "hexcore_sqlite3",
     "sources": [
       "src/main.cpp",
-      "src/sqlite3_wrapper.cpp"
+      "src/sqlite3_wrapper.cpp",
+      "src/trace_hook.cpp",
+      "src/index_advisor.cpp",
+      "src/pool_allocator.cpp",
+      "src/memory_region.cpp",
+      "src/shared_pcache.cpp",
+      "src/uring_vfs.cpp",
+      "src/wal_checkpointer.cpp",
+      "src/interrupt_timer.cpp",
+      "src/dedup_filter.cpp",
+      "src/text_functions.cpp",
+      "src/ioc_tokenizer.cpp",
+      "src/bulk_importer.cpp",
+      "src/query_exporter.cpp",
+      "src/json_writer.cpp",
+      "src/json_codec.cpp",
+      "src/carray.cpp",
+      "src/connection_extensions.cpp"
     ],
     "include_dirs": [
       "<!@(node -p \"require('node-addon-api').include\")",
@@ -15,7 +38,9 @@
     "defines": [
       "NAPI_VERSION=8",
       "NAPI_CPP_EXCEPTIONS",
-      "NODE_ADDON_API_DISABLE_DEPRECATED"
+      "NODE_ADDON_API_DISABLE_DEPRECATED",
+      "SQLITE_ENABLE_PREUPDATE_HOOK",
+      "SQLITE_ENABLE_SESSION"
     ],
     "cflags!": ["-fno-exceptions"],
     "cflags_cc!": ["-fno-exceptions"],
@@ -51,6 +76,63 @@
           "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
           "MACOSX_DEPLOYMENT_TARGET": "10.15"
         }
+      }],
+      # Whole-program build: compile the amalgamation into the addon with LTO so
+      # sqlite3_step/sqlite3_column_* can be inlined into the wrapper.
+      # node-gyp rebuild --hexcore_lto=true  (requires deps/sqlite3/sqlite3.c)
+      ["hexcore_lto=='true'", {
+        "sources": [
+          "deps/sqlite3/sqlite3.c"
+        ],
+        "libraries!": [
+          "<(module_root_dir)/deps/sqlite3/sqlite3.lib",
+          "<(module_root_dir)/deps/sqlite3/libsqlite3.a"
+        ],
+        "defines": [
+          "<!@(node scripts/sqlite3-defines.js)"
+        ],
+        "cflags": ["-O3", "-flto"],
+        "cflags_c": ["-std=c99", "-w"],
+        "ldflags": ["-O3", "-flto"],
+        "msvs_settings": {
+          "VCCLCompilerTool": {
+            "WholeProgramOptimization": "true"
+          },
+          "VCLinkerTool": {
+            "LinkTimeCodeGeneration": 1
+          }
+        },
+        "xcode_settings": {
+          "GCC_OPTIMIZATION_LEVEL": "3",
+          "LLVM_LTO": "YES"
+        }
+      }],
+      # Profile-guided optimization, driven by scripts/build-pgo.js (GCC/Clang only)
+      ["hexcore_pgo=='generate' and OS!='win'", {
+        "cflags": ["-fprofile-generate=<(hexcore_pgo_dir)"],
+        "ldflags": ["-fprofile-generate=<(hexcore_pgo_dir)"],
+        "xcode_settings": {
+          "OTHER_CFLAGS": ["-fprofile-generate=<(hexcore_pgo_dir)"],
+          "OTHER_LDFLAGS": ["-fprofile-generate=<(hexcore_pgo_dir)"]
+        }
+      }],
+      ["hexcore_pgo=='use' and OS=='linux'", {
+        "cflags": ["-fprofile-use=<(hexcore_pgo_dir)"],
+        "ldflags": ["-fprofile-use=<(hexcore_pgo_dir)"],
+        "conditions": [
+          # Set by scripts/build-pgo.js when the training run left Clang profiles
+          ["hexcore_pgo_clang=='true'", {
+            "cflags": ["-Wno-profile-instr-unprofiled", "-Wno-profile-instr-out-of-date"]
+          }, {
+            "cflags": ["-fprofile-correction", "-Wno-missing-profile"]
+          }]
+        ]
+      }],
+      ["hexcore_pgo=='use' and OS=='mac'", {
+        "xcode_settings": {
+          "OTHER_CFLAGS": ["-fprofile-use=<(hexcore_pgo_dir)/default.profdata"],
+          "OTHER_LDFLAGS": ["-fprofile-use=<(hexcore_pgo_dir)/default.profdata"]
+        }
       }]
     ]
   }]
@@ -15,8 +15,77 @@ export interface DatabaseOptions {
 	readonly fileMustExist?: boolean;
 	/** Busy timeout in milliseconds. Default: 5000. */
 	readonly timeout?: number;
-	/** Called with every SQL string executed. */
-	readonly verbose?: (message: string, ...args: unknown[]) => void;
+	/**
+	 * Called with the expanded SQL of each (sampled) statement execution.
+	 * Events are collected natively by a trace hook and delivered in one
+	 * batch per event-loop turn, after the statements have completed.
+	 */
+	readonly verbose?: (message: string, details: VerboseDetails) => void;
+	/** Report only one in every N statement executions to `verbose`. Default: 1. */
+	readonly verboseSampleRate?: number;
+	/**
+	 * Statements whose single execution takes more than this many full-scan
+	 * steps (`SQLITE_STMTSTATUS_FULLSCAN_STEP`) are recorded as workload for
+	 * `adviseIndexes()`; `getMany()` averages the steps over its keys. 0
+	 * disables recording. Default: 1000.
+	 */
+	readonly fullScanThreshold?: number;
+	/**
+	 * Bytes of the database file to access through a memory mapping
+	 * (`PRAGMA mmap_size`), skipping read() for pages in the mapped range.
+	 * Works with WAL; the WAL file itself is never mapped. Capped by
+	 * SQLITE_MAX_MMAP_SIZE (1 TiB). Default: SQLite's default (0).
+	 */
+	readonly mmapSize?: number;
+	/**
+	 * Linux: perform database and WAL page I/O through io_uring, batching
+	 * WAL appends and checkpoint writes into single submissions. Falls back
+	 * to the default VFS when io_uring is unavailable (older kernels, seccomp
+	 * filters) or when `HEXCORE_SQLITE_IO_URING=off`. Default: false.
+	 */
+	readonly ioUring?: boolean;
+	/**
+	 * "wait" (default) sleeps inside the statement for up to `timeout` ms when
+	 * another connection or process holds the lock. "immediate" throws
+	 * SQLITE_BUSY at once so `retryOnBusy()` can back off on the event loop;
+	 * `timeout` then becomes its default retry budget.
+	 */
+	readonly busyMode?: 'wait' | 'immediate';
+	/**
+	 * Default deadline in milliseconds for every statement execution; a
+	 * native timer interrupts statements that run longer, which then throw
+	 * with code "SQLITE_INTERRUPT". Default: 0 (none).
+	 */
+	readonly queryTimeout?: number;
+	/**
+	 * Run WAL checkpoints on a native thread with its own connection instead
+	 * of inline in the committing statement. The thread wakes once the WAL
+	 * holds `threshold` frames (default 1000) and runs PASSIVE checkpoints;
+	 * after `escalateAfter` (default 4) passes that could not backfill the
+	 * whole log it uses `mode` ("restart" by default, or "truncate";
+	 * "passive" never escalates). Setting `PRAGMA wal_autocheckpoint`
+	 * afterwards hands checkpointing back to SQLite.
+	 */
+	readonly checkpointer?: boolean | { threshold?: number; mode?: 'passive' | 'restart' | 'truncate'; escalateAfter?: number };
+	/**
+	 * Per-connection lookaside allocator: `slots` buffers of `slotSize` bytes
+	 * used for small, short-lived allocations (SQLITE_DBCONFIG_LOOKASIDE).
+	 * SQLite's default is 100 slots of 1200 bytes; 0 slots disables lookaside.
+	 */
+	readonly lookaside?: { readonly slotSize: number; readonly slots: number };
+	/**
+	 * Preallocated page-cache region, shared by all connections of the
+	 * process and installed by the first database that passes it; pages that
+	 * do not fit spill over to the heap. With `HEXCORE_SQLITE_PCACHE=default`
+	 * it must be passed to the first database opened in the process.
+	 * `pageSize` defaults to 4096.
+	 */
+	readonly pageCache?: { readonly slots: number; readonly pageSize?: number };
+	/**
+	 * Back the lookaside and page-cache regions with huge pages (MAP_HUGETLB,
+	 * falling back to transparent huge pages) where available. Default: false.
+	 */
+	readonly hugePages?: boolean;
 	/**
 	 * Path to a custom native binding (.node file) or a pre-loaded addon object.
 	 * When omitted the standard HexCore fallback loading is used.
@@ -24,6 +93,14 @@ export interface DatabaseOptions {
 	readonly nativeBinding?: string | object;
 }
 
+/** Extra information passed to the `verbose` callback. */
+export interface VerboseDetails {
+	/** Wall-clock execution time of the statement in nanoseconds. */
+	readonly durationNs: number;
+	/** Events discarded because the native buffer was full (first event of a batch only). */
+	readonly dropped?: number;
+}
+
 /** Result of a statement that modifies data. */
 export interface RunResult {
 	/** Number of rows changed by the last INSERT, UPDATE, or DELETE. */
@@ -41,7 +118,74 @@ export interface ColumnDefinition {
 	readonly type: string | null;
 }
 
-/** A prepared SQL statement. */
+/** One row of EXPLAIN QUERY PLAN output. */
+export interface QueryPlanRow {
+	readonly id: number;
+	readonly parent: number;
+	readonly detail: string;
+}
+
+/** Index advice for a single query. */
+export interface QueryAdvice {
+	readonly sql: string;
+	/** Recommended CREATE INDEX statements used by this query's new plan. */
+	readonly indexes: string[];
+	/** Query plan against the current schema. */
+	readonly before: QueryPlanRow[];
+	/** Query plan with the candidate indexes in place. */
+	readonly after: QueryPlanRow[];
+	/** Why the query could not be analysed, or null. */
+	readonly error: string | null;
+}
+
+/** Result of `db.adviseIndexes()`. */
+export interface IndexAdvice {
+	/** All recommended CREATE INDEX statements, deduplicated. */
+	readonly indexes: string[];
+	readonly queries: QueryAdvice[];
+}
+
+/** A query plan element annotated with runtime counters by `stmt.profile()`. */
+export interface ProfileNode {
+	readonly id: number;
+	readonly parent: number;
+	/** EXPLAIN QUERY PLAN text for this element. */
+	readonly detail: string;
+	/** Table or index scanned, if this element is a loop. */
+	readonly name: string | null;
+	/** Number of times the loop ran. */
+	readonly loops: number | null;
+	/** Total rows examined over all iterations. */
+	readonly rowsVisited: number | null;
+	/** Planner estimate of rows output per iteration. */
+	readonly estimatedRows: number | null;
+	/** Measured rows per iteration (rowsVisited / loops). */
+	readonly actualRows: number | null;
+	/** CPU time-stamp-counter cycles spent in this element. */
+	readonly cycles: number | null;
+	readonly children: ProfileNode[];
+}
+
+/** Result of `stmt.profile()`. */
+export interface ProfileResult {
+	/** Number of result rows produced. */
+	readonly rows: number;
+	readonly durationNs: number;
+	/** Cycles for the whole statement. */
+	readonly cycles: number | null;
+	readonly plan: ProfileNode[];
+}
+
+/**
+ * A prepared SQL statement.
+ *
+ * In statements that call `carray()`, arrays and
+ * Float64Array/BigInt64Array/Int32Array/Uint32Array parameters bind as a
+ * single pointer for that table-valued function, e.g.
+ * `WHERE id IN carray(?)`; JS arrays hold only numbers/bigints or only
+ * strings (in json() mode, JS arrays are stored as JSONB instead). Other
+ * statements reject array parameters.
+ */
 export interface Statement<BindParameters extends unknown[] = unknown[]> {
 	/** Execute the statement and return run result (for INSERT/UPDATE/DELETE). */
 	run(...params: BindParameters): RunResult;
@@ -49,6 +193,27 @@ export interface Statement<BindParameters extends unknown[] = unknown[]> {
 	get(...params: BindParameters): unknown;
 	/** Execute the statement and return all matching rows. */
 	all(...params: BindParameters): unknown[];
+	/**
+	 * Like get(), but the row is serialized to JSON natively (honoring raw and
+	 * expand mode) and returned as one string, or undefined if there is none.
+	 * BLOBs become base64 strings; integers keep all their digits.
+	 */
+	getJSON(...params: BindParameters): string | Buffer | undefined;
+	/**
+	 * Like all(), but the rows are serialized to one JSON array natively,
+	 * without creating row objects: `JSON.parse(stmt.allJSON())` equals
+	 * `stmt.all()` apart from BLOBs (base64 strings) and BigInts.
+	 */
+	allJSON(...params: BindParameters): string | Buffer;
+	/**
+	 * Run get() once per element of `keys` (a single value, an array of
+	 * positional values or an object of named ones) in one native call. The
+	 * result is aligned with `keys`: rows ("row", the default) or their first
+	 * column ("pluck"), undefined where nothing matched; "exists" returns
+	 * 1/0 flags without converting any column. A failure carries `index`.
+	 */
+	getMany(keys: unknown[], options?: { mode?: 'row' | 'pluck' }): unknown[];
+	getMany(keys: unknown[], options: { mode: 'exists' }): Uint8Array;
 	/** Iterate over result rows. */
 	iterate(...params: BindParameters): IterableIterator<unknown>;
 	/** Return column metadata for the prepared statement. */
@@ -59,8 +224,53 @@ export interface Statement<BindParameters extends unknown[] = unknown[]> {
 	safeIntegers(toggle?: boolean): this;
 	/** Enable or disable raw array mode (rows as arrays instead of objects). */
 	raw(toggle?: boolean): this;
+	/**
+	 * JSON mode. Columns declared `JSON` or `JSONB` (or the named result
+	 * columns) are decoded natively from JSON text or JSONB into JS values,
+	 * and objects/arrays bound as parameters are stored as JSONB, with
+	 * JSON.stringify() semantics. Values that are not valid JSON are returned
+	 * unchanged. Integers follow safeIntegers(). `false` turns it off.
+	 */
+	json(toggle?: boolean | string[]): this;
+	/** Make getJSON()/allJSON() return UTF-8 Buffers instead of strings. */
+	jsonBuffer(toggle?: boolean): this;
 	/** Enable or disable expand mode (rows grouped by table). */
 	expand(toggle?: boolean): this;
+	/**
+	 * Execute the statement to completion and return its query plan annotated
+	 * with per-element loop, row and cycle counters (sqlite3_stmt_scanstatus_v2).
+	 * Rows are discarded.
+	 */
+	profile(...params: BindParameters): ProfileResult;
+	/**
+	 * Interrupt executions of this statement that run longer than `ms`
+	 * (error code "SQLITE_INTERRUPT"); `null` inherits `queryTimeout`.
+	 */
+	timeout(ms: number | null): this;
+	/**
+	 * Attach a Bloom filter over the key columns of a UNIQUE constraint to an
+	 * INSERT OR IGNORE (or ON CONFLICT DO NOTHING without a target) statement;
+	 * `columns` must be exactly the key of a UNIQUE index or the PRIMARY KEY,
+	 * under the columns' own collations. Runs whose key is already in the
+	 * table are skipped before the row is bound (`changes: 0`); filter hits
+	 * are confirmed with a key-only lookup, so results never differ from
+	 * SQLite's.
+	 * The filter is built from the table when attached and updated on inserts.
+	 * `table` and `params` (bind position or name per column) default to the
+	 * statement's INSERT column list; `bits` defaults to ~24 per existing row.
+	 * Pass `null` to detach.
+	 */
+	dedupFilter(options: { columns: string[]; table?: string; params?: Array<number | string>; bits?: number; hashes?: number } | null): this;
+	/** Counters of the attached dedup filter, or null. */
+	dedupStats(): DedupStats | null;
+	/**
+	 * Run this read-only query on a worker thread and stream the rows to a
+	 * file (created or truncated) or an open file descriptor (left open) as
+	 * NDJSON or CSV. The query uses a separate read-only connection, so the
+	 * database must be on disk and only committed data is exported. BLOBs are
+	 * written as base64. Resolves with the row and byte counts.
+	 */
+	exportTo(target: string | number, options?: ExportOptions): Promise<ExportResult>;
 	/** The source SQL string. */
 	readonly source: string;
 	/** Whether the statement is read-only. */
@@ -92,6 +302,17 @@ export interface Database {
 		immediate: F;
 		exclusive: F;
 	};
+	/**
+	 * Run several prepared statements of this database back to back in one
+	 * native call and return their results in order: `run()` info, a row (or
+	 * undefined), an array of rows, or JSON text for "getJSON"/"allJSON". The
+	 * mode defaults to "all" for statements that return data, else "run".
+	 * Params are an array of positional values or an object of named ones.
+	 * The first failing step stops the pipeline; its error carries `index`.
+	 * With `transaction` the steps run in one savepoint, rolled back on
+	 * failure.
+	 */
+	pipeline(steps: PipelineStep[], options?: { transaction?: boolean }): unknown[];
 	/** Execute a PRAGMA statement. */
 	pragma(sql: string, options?: { simple?: boolean }): unknown;
 	/** Register a custom SQL function. */
@@ -113,6 +334,66 @@ export interface Database {
 	defaultSafeIntegers(toggle?: boolean): this;
 	/** Enable or disable unsafe mode. */
 	unsafeMode(toggle?: boolean): this;
+	/**
+	 * Propose missing indexes for a workload (sqlite3expert algorithm).
+	 * @param sqlList - Queries to analyse. Defaults to the statements recorded
+	 * through the `fullScanThreshold` option.
+	 */
+	adviseIndexes(sqlList?: string[]): IndexAdvice;
+	/**
+	 * Page-cache counters of this connection, summed over its attached
+	 * databases. `reset` zeroes the hit/miss/write/spill counters.
+	 */
+	cacheStats(options?: { reset?: boolean }): CacheStats;
+	/**
+	 * Run `fn` with a deadline covering every statement it executes, including
+	 * across awaits when it returns a promise. Aborting `signal` interrupts
+	 * the running statement and fails the remaining ones with
+	 * "SQLITE_INTERRUPT". Scopes apply to the whole connection.
+	 */
+	withDeadline<T>(options: number | { timeout?: number; signal?: AbortSignal }, fn: () => T): T;
+	/**
+	 * Run `fn`, retrying it after SQLITE_BUSY errors with exponential backoff
+	 * and jitter (`initialDelay` doubling up to `maxDelay` ms) until `maxWait`
+	 * ms (default: the `timeout` option) have passed. Pair with
+	 * `busyMode: "immediate"`; `fn` should be a statement call or a whole
+	 * transaction function.
+	 */
+	retryOnBusy<T>(fn: () => T, options?: { maxWait?: number; initialDelay?: number; maxDelay?: number }): Promise<T>;
+	/** Interrupt whatever this connection is executing (sqlite3_interrupt). */
+	interrupt(): this;
+	/**
+	 * Register the native IOC tokenizer with FTS5 (default name "hexioc"):
+	 * `CREATE VIRTUAL TABLE t USING fts5(ctx, tokenize = 'hexioc')`. Quote
+	 * URLs, paths and domains in MATCH queries to search them as phrases.
+	 * The connections of later importFile() and exportTo() calls get it too.
+	 */
+	registerTokenizer(name?: string): this;
+	/**
+	 * Load an NDJSON or CSV file into `options.table` on a native worker
+	 * thread with its own connection (on-disk databases only). Rows commit in
+	 * transactions of `batchSize`; on failure the promise rejects with an
+	 * error carrying `line`, and earlier batches stay committed.
+	 */
+	importFile(path: string, options: ImportOptions): Promise<ImportResult>;
+	/** Background checkpointer counters, or null without the `checkpointer` option. */
+	checkpointStats(): CheckpointStats | null;
+	/**
+	 * Open a BLOB for incremental I/O (sqlite3_blob_open). Writes happen in
+	 * place and cannot change the blob's size; allocate it with zeroblob(N).
+	 */
+	openBlob(table: string, column: string, rowid: number | bigint, options?: { readonly?: boolean; attached?: string }): Blob;
+	/**
+	 * Start recording changes (session extension). Only tables with a PRIMARY
+	 * KEY are recorded; `tables` defaults to all of them.
+	 */
+	createSession(tables?: string[] | null, options?: { attached?: string }): Session;
+	/**
+	 * Apply a changeset or patchset produced by a session. `onConflict` is a
+	 * policy for every conflict or a function choosing one per conflict
+	 * (default "abort", which rolls the whole changeset back).
+	 */
+	applyChangeset(changeset: Buffer, options?: { onConflict?: ConflictPolicy | ((conflict: ChangesetConflict) => ConflictPolicy) }): { conflicts: number };
 	/** Serialize the database to a Buffer. */
 	serialize(attachedName?: string): Buffer;
 	/** Back up the database to a file. */
@@ -158,12 +439,214 @@ export declare function openDatabase(filename: string, options?: DatabaseOptions
 /** Resolve the path to the loaded native binary. */
 export declare function resolveNativeBinaryPath(): string | undefined;
 
+/** Statistics for one size class of the SQLite pool allocator. */
+export interface AllocatorClassStats {
+	/** Usable bytes per block. */
+	readonly size: number;
+	/** Blocks currently in use by SQLite. */
+	readonly inUse: number;
+	/** Free blocks held in per-thread pools and arena chunks. */
+	readonly cached: number;
+	/** Allocations served since the addon was loaded. */
+	readonly total: number;
+}
+
+/** Incremental BLOB handle returned by `db.openBlob()`. */
+export interface Blob {
+	readonly database: Database;
+	/** Size of the blob in bytes. */
+	readonly length: number;
+	readonly readonly: boolean;
+	readonly open: boolean;
+	/** Read up to `length` bytes at `offset`, into `target` when given. */
+	read(offset?: number, length?: number, target?: Buffer): Buffer;
+	/** Overwrite bytes at `offset`. */
+	write(offset: number, data: ArrayBufferView): this;
+	/** Point the handle at another row of the same table and column. */
+	reopen(rowid: number | bigint): this;
+	close(): this;
+	/** Stream the blob in `highWaterMark`-sized chunks (default 64 KiB); `end` is inclusive. */
+	createReadStream(options?: { start?: number; end?: number; highWaterMark?: number }): import('stream').Readable;
+	/** Stream data into the blob in place, starting at `start`. */
+	createWriteStream(options?: { start?: number }): import('stream').Writable;
+}
+
+/** Change recorder returned by `db.createSession()`. */
+export interface Session {
+	readonly database: Database;
+	/** Whether no changes have been recorded yet. */
+	readonly empty: boolean;
+	readonly open: boolean;
+	/** Recorded changes with full old/new row images. */
+	changeset(): Buffer;
+	/** Compact form carrying only primary keys and new values; conflicts are detected less precisely. */
+	patchset(): Buffer;
+	/** Pause or resume recording. */
+	enable(toggle?: boolean): this;
+	close(): this;
+}
+
+export type ConflictPolicy = 'omit' | 'replace' | 'abort';
+
+/** Conflict passed to an `applyChangeset()` handler. "replace" is only honoured for "data" and "conflict". */
+export interface ChangesetConflict {
+	readonly type: 'data' | 'notfound' | 'conflict' | 'constraint' | 'foreign_key';
+	readonly table: string;
+	readonly operation: 'insert' | 'update' | 'delete';
+}
+
+/** Result of `db.checkpointStats()`. */
+export interface CheckpointStats {
+	readonly checkpoints: number;
+	/** Checkpoints run in the escalated RESTART/TRUNCATE mode. */
+	readonly escalations: number;
+	/** Checkpoints that returned SQLITE_BUSY. */
+	readonly busy: number;
+	readonly lastDurationNs: number;
+	readonly maxDurationNs: number;
+	readonly totalDurationNs: number;
+	/** Frames in the WAL after the most recent commit. */
+	readonly walFrames: number;
+	/** Frames copied into the database by the last checkpoint. */
+	readonly backfilledFrames: number;
+	/** Size of the WAL file after the last checkpoint. */
+	readonly walBytes: number;
+}
+
+/** One `db.pipeline()` step: a statement, its parameters and how to run it. */
+export type PipelineStep = [
+	statement: Statement,
+	params?: any[] | Record<string, any> | null,
+	mode?: 'run' | 'get' | 'all' | 'getJSON' | 'allJSON',
+];
+
+export interface ExportOptions {
+	/** Output format; defaults to "csv" for paths ending in .csv, otherwise "ndjson". */
+	format?: 'ndjson' | 'csv';
+	/** CSV only: write a header line with the column names (default true). */
+	header?: boolean;
+	/** Positional (array) or named (object) parameters for the query. */
+	params?: any[] | Record<string, any>;
+}
+
+export interface ExportResult {
+	rows: number;
+	bytes: number;
+}
+
+export interface ImportOptions {
+	table: string;
+	/** Default: "csv" for *.csv files, otherwise "ndjson". */
+	format?: 'ndjson' | 'csv';
+	/** Target columns: NDJSON keys, or CSV fields in order. Default: the first object's keys / the CSV header. */
+	columns?: string[];
+	/** CSV only: the first record is a header (default true). */
+	header?: boolean;
+	/** INSERT OR ... policy (default "abort"). */
+	onConflict?: 'abort' | 'ignore' | 'replace';
+	/** Rows per transaction (default 10000). */
+	batchSize?: number;
+	/** Skip rows that fail to parse or violate a constraint instead of stopping (default false). */
+	skipErrors?: boolean;
+	/** Called after every committed batch; throwing stops the import. */
+	onProgress?: (progress: ImportProgress) => void;
+}
+
+export interface ImportProgress {
+	readonly rows: number;
+	readonly lines: number;
+	readonly bytes: number;
+	readonly totalBytes: number;
+}
+
+export interface ImportResult {
+	readonly rows: number;
+	readonly lines: number;
+	readonly skipped: number;
+	/** The first 100 skipped rows. */
+	readonly errors: ReadonlyArray<{ readonly line: number; readonly message: string }>;
+}
+
+/** Result of `stmt.dedupStats()`. */
+export interface DedupStats {
+	/** Keys added from the table and from successful inserts. */
+	readonly keys: number;
+	readonly bits: number;
+	readonly hashes: number;
+	/** Filter hits checked against the table. */
+	readonly probes: number;
+	/** Runs skipped as duplicates. */
+	readonly rejected: number;
+	/** Filter hits that turned out to be new keys. */
+	readonly falsePositives: number;
+}
+
+/** Result of `db.cacheStats()`. */
+export interface CacheStats {
+	readonly hits: number;
+	readonly misses: number;
+	readonly writes: number;
+	readonly spills: number;
+	/** Approximate heap bytes used by this connection's page caches. */
+	readonly bytes: number;
+}
+
+/** Result of `pageCacheStats()`. */
+export interface PageCacheStats {
+	/** "shared", or "default" when HEXCORE_SQLITE_PCACHE=default is set. */
+	readonly pageCache: 'shared' | 'default';
+	/** Global budget in bytes; 0 means unlimited. */
+	readonly budget: number;
+	/** Bytes held by on-disk databases, counted against the budget. */
+	readonly bytes: number;
+	/** Cached pages, including in-memory databases. */
+	readonly pages: number;
+	readonly pinned: number;
+	/** Open pager caches (one per attached database per connection). */
+	readonly caches: number;
+	readonly hits: number;
+	readonly misses: number;
+	/** Pages evicted across connections to stay within the budget. */
+	readonly evictions: number;
+}
+
+/** Report process-wide counters of the shared page cache. */
+export declare function pageCacheStats(): PageCacheStats;
+
+/**
+ * Cap the memory cached by all on-disk databases of the process, in bytes
+ * (0 = unlimited, the default). The least recently used pages of any
+ * connection are evicted first; each connection's cache_size still applies.
+ * Returns false if the shared page cache is disabled.
+ */
+export declare function setPageCacheBudget(bytes: number): boolean;
+
+/** Result of `allocatorStats()`. */
+export interface AllocatorStats {
+	/** "pool", or "system" when HEXCORE_SQLITE_MALLOC=system is set. */
+	readonly allocator: 'pool' | 'system';
+	/** Bytes reserved in arena chunks for size-class blocks. */
+	readonly arenaBytes: number;
+	/** Allocations above 2 KiB, served by the system allocator. */
+	readonly large: { readonly inUse: number; readonly bytes: number; readonly total: number };
+	readonly classes: AllocatorClassStats[];
+}
+
+/**
+ * Report SQLite memory usage per allocator size class. All counters are
+ * zero when the system allocator is in use.
+ */
+export declare function allocatorStats(): AllocatorStats;
+
 declare const _default: DatabaseConstructor & {
 	default: DatabaseConstructor;
 	Database: DatabaseConstructor;
 	SqliteError: SqliteError;
 	openDatabase: typeof openDatabase;
 	resolveNativeBinaryPath: typeof resolveNativeBinaryPath;
+	allocatorStats: typeof allocatorStats;
+	pageCacheStats: typeof pageCacheStats;
+	setPageCacheBudget: typeof setPageCacheBudget;
 };
 
 export = _default;
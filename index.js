@@ -64,6 +64,19 @@ function openDatabase(filename, options) {
 	return new Database(filename, options);
 }
 
+function allocatorStats() {
+	return nativeAddon.allocatorStats();
+}
+
+function pageCacheStats() {
+	return nativeAddon.pageCacheStats();
+}
+
+function setPageCacheBudget(bytes) {
+	if (!Number.isSafeInteger(bytes) || bytes < 0) throw new TypeError('Expected budget to be a non-negative integer number of bytes');
+	return nativeAddon.setPageCacheBudget(bytes);
+}
+
 function resolveNativeBinaryPath() {
 	const fs = require('fs');
 	const candidates = [
@@ -80,3 +93,6 @@ module.exports.Database = Database;
 module.exports.SqliteError = SqliteError;
 module.exports.openDatabase = openDatabase;
 module.exports.resolveNativeBinaryPath = resolveNativeBinaryPath;
+module.exports.allocatorStats = allocatorStats;
+module.exports.pageCacheStats = pageCacheStats;
+module.exports.setPageCacheBudget = setPageCacheBudget;
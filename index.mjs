@@ -14,6 +14,9 @@ export const {
 	SqliteError,
 	openDatabase,
 	resolveNativeBinaryPath,
+	allocatorStats,
+	pageCacheStats,
+	setPageCacheBudget,
 } = binding;
 
 export default binding;
@@ -32,14 +32,49 @@ function Database(filenameGiven, options) {
 	const readonly = util.getBooleanOption(options, 'readonly');
 	const fileMustExist = util.getBooleanOption(options, 'fileMustExist');
 	const timeout = 'timeout' in options ? options.timeout : 5000;
+	const busyMode = 'busyMode' in options ? options.busyMode : 'wait';
 	const verbose = 'verbose' in options ? options.verbose : null;
+	const verboseSampleRate = 'verboseSampleRate' in options ? options.verboseSampleRate : 1;
+	const fullScanThreshold = 'fullScanThreshold' in options ? options.fullScanThreshold : 1000;
+	const lookaside = 'lookaside' in options ? options.lookaside : null;
+	const pageCache = 'pageCache' in options ? options.pageCache : null;
+	const hugePages = util.getBooleanOption(options, 'hugePages');
+	const mmapSize = 'mmapSize' in options ? options.mmapSize : null;
+	const ioUring = util.getBooleanOption(options, 'ioUring');
+	const checkpointer = 'checkpointer' in options ? options.checkpointer : null;
+	const queryTimeout = 'queryTimeout' in options ? options.queryTimeout : 0;
 	const nativeBinding = 'nativeBinding' in options ? options.nativeBinding : null;
 
 	// Validate interpreted options
 	if (readonly && anonymous && !buffer) throw new TypeError('In-memory/temporary databases cannot be readonly');
 	if (!Number.isInteger(timeout) || timeout < 0) throw new TypeError('Expected the "timeout" option to be a positive integer');
 	if (timeout > 0x7fffffff) throw new RangeError('Option "timeout" cannot be greater than 2147483647');
+	if (busyMode !== 'wait' && busyMode !== 'immediate') throw new TypeError('Expected the "busyMode" option to be "wait" or "immediate"');
 	if (verbose != null && typeof verbose !== 'function') throw new TypeError('Expected the "verbose" option to be a function');
+	if (!Number.isInteger(verboseSampleRate) || verboseSampleRate < 1) throw new TypeError('Expected the "verboseSampleRate" option to be a positive integer');
+	if (verboseSampleRate > 0xffffffff) throw new RangeError('Option "verboseSampleRate" cannot be greater than 4294967295');
+	if (!Number.isSafeInteger(fullScanThreshold) || fullScanThreshold < 0) throw new TypeError('Expected the "fullScanThreshold" option to be a non-negative integer');
+	if (!Number.isInteger(queryTimeout) || queryTimeout < 0) throw new TypeError('Expected the "queryTimeout" option to be a non-negative integer');
+	if (queryTimeout > 0x7fffffff) throw new RangeError('Option "queryTimeout" cannot be greater than 2147483647');
+	if (mmapSize != null && (!Number.isSafeInteger(mmapSize) || mmapSize < 0)) throw new TypeError('Expected the "mmapSize" option to be a non-negative integer');
+	if (lookaside != null) {
+		if (typeof lookaside !== 'object') throw new TypeError('Expected the "lookaside" option to be an object');
+		if (!Number.isInteger(lookaside.slotSize) || lookaside.slotSize < 8 || lookaside.slotSize > 65536) throw new RangeError('Expected "lookaside.slotSize" to be an integer between 8 and 65536');
+		if (!Number.isInteger(lookaside.slots) || lookaside.slots < 0 || lookaside.slotSize * lookaside.slots > 0x7fffffff) throw new RangeError('Expected "lookaside.slots" to be a non-negative integer within a 2 GiB region');
+	}
+	if (pageCache != null) {
+		if (typeof pageCache !== 'object') throw new TypeError('Expected the "pageCache" option to be an object');
+		const pageSize = 'pageSize' in pageCache ? pageCache.pageSize : 4096;
+		if (!Number.isInteger(pageSize) || pageSize < 512 || pageSize > 65536 || (pageSize & (pageSize - 1))) throw new RangeError('Expected "pageCache.pageSize" to be a power of two between 512 and 65536');
+		if (!Number.isInteger(pageCache.slots) || pageCache.slots < 1 || pageCache.slots * pageSize > 0x7fffffff) throw new RangeError('Expected "pageCache.slots" to be a positive integer within a 2 GiB region');
+	}
+	let checkpointerOptions = null;
+	if (checkpointer != null && checkpointer !== false) {
+		if (checkpointer !== true && typeof checkpointer !== 'object') throw new TypeError('Expected the "checkpointer" option to be a boolean or an object');
+		if (anonymous) throw new TypeError('The "checkpointer" option requires an on-disk database');
+		if (readonly) throw new TypeError('The "checkpointer" option cannot be used with a readonly database');
+		checkpointerOptions = interpretCheckpointer(checkpointer === true ? {} : checkpointer);
+	}
 	if (nativeBinding != null && typeof nativeBinding !== 'string' && typeof nativeBinding !== 'object') throw new TypeError('Expected the "nativeBinding" option to be a string or addon object');
 
 	// Load the native addon
@@ -70,13 +105,38 @@ function Database(filenameGiven, options) {
 		throw new TypeError('Cannot open database because the directory does not exist');
 	}
 
+	// HexCore-specific options are passed to the addon as one trailing object
+	const nativeOptions = { verboseSampleRate, fullScanThreshold, hugePages, ioUring, queryTimeout, busyImmediate: busyMode === 'immediate' };
+	if (mmapSize != null) nativeOptions.mmapSize = mmapSize;
+	if (checkpointerOptions != null) nativeOptions.checkpointer = checkpointerOptions;
+	if (lookaside != null) {
+		nativeOptions.lookasideSlotSize = lookaside.slotSize;
+		nativeOptions.lookasideSlots = lookaside.slots;
+	}
+	if (pageCache != null) {
+		nativeOptions.pageCachePageSize = 'pageSize' in pageCache ? pageCache.pageSize : 4096;
+		nativeOptions.pageCacheSlots = pageCache.slots;
+	}
+
 	Object.defineProperties(this, {
-		[util.cppdb]: { value: new addon.Database(filename, filenameGiven, anonymous, readonly, fileMustExist, timeout, verbose || null, buffer || null) },
+		[util.cppdb]: { value: new addon.Database(filename, filenameGiven, anonymous, readonly, fileMustExist, timeout, verbose || null, buffer || null, nativeOptions) },
+		[util.busyTimeout]: { value: timeout },
 		...wrappers.getters,
 	});
 }
 
+function interpretCheckpointer(options) {
+	const threshold = 'threshold' in options ? options.threshold : 1000;
+	const mode = 'mode' in options ? options.mode : 'restart';
+	const escalateAfter = 'escalateAfter' in options ? options.escalateAfter : 4;
+	if (!Number.isInteger(threshold) || threshold < 1 || threshold > 0x7fffffff) throw new RangeError('Expected "checkpointer.threshold" to be a positive integer');
+	if (mode !== 'passive' && mode !== 'restart' && mode !== 'truncate') throw new TypeError('Expected "checkpointer.mode" to be "passive", "restart" or "truncate"');
+	if (!Number.isInteger(escalateAfter) || escalateAfter < 0 || escalateAfter > 0x7fffffff) throw new RangeError('Expected "checkpointer.escalateAfter" to be a non-negative integer');
+	return { threshold, mode, escalateAfter };
+}
+
 const wrappers = require('./methods/wrappers');
+const session = require('./methods/session');
 Database.prototype.prepare = wrappers.prepare;
 Database.prototype.transaction = require('./methods/transaction');
 Database.prototype.pragma = require('./methods/pragma');
@@ -85,10 +145,22 @@ Database.prototype.serialize = require('./methods/serialize');
 Database.prototype.function = require('./methods/function');
 Database.prototype.aggregate = require('./methods/aggregate');
 Database.prototype.table = require('./methods/table');
+Database.prototype.adviseIndexes = require('./methods/advise');
+Database.prototype.openBlob = require('./methods/blob');
+Database.prototype.createSession = session.createSession;
+Database.prototype.applyChangeset = session.applyChangeset;
+Database.prototype.withDeadline = require('./methods/deadline');
+Database.prototype.retryOnBusy = require('./methods/retry');
+Database.prototype.importFile = require('./methods/import');
+Database.prototype.interrupt = wrappers.interrupt;
+Database.prototype.registerTokenizer = wrappers.registerTokenizer;
+Database.prototype.pipeline = wrappers.pipeline;
 Database.prototype.loadExtension = wrappers.loadExtension;
 Database.prototype.exec = wrappers.exec;
 Database.prototype.close = wrappers.close;
 Database.prototype.defaultSafeIntegers = wrappers.defaultSafeIntegers;
+Database.prototype.cacheStats = wrappers.cacheStats;
+Database.prototype.checkpointStats = wrappers.checkpointStats;
 Database.prototype.unsafeMode = wrappers.unsafeMode;
 Database.prototype[util.inspect] = require('./methods/inspect');
 
@@ -0,0 +1,14 @@
+'use strict';
+const { cppdb } = require('../util');
+
+module.exports = function adviseIndexes(sqlList) {
+	// Validate arguments
+	if (sqlList != null) {
+		if (!Array.isArray(sqlList) || !sqlList.every(x => typeof x === 'string')) {
+			throw new TypeError('Expected first argument to be an array of SQL strings');
+		}
+	}
+
+	// Without a list the native workload recorded via "fullScanThreshold" is used
+	return this[cppdb].adviseIndexes(sqlList == null ? null : [...sqlList]);
+};
@@ -0,0 +1,113 @@
+'use strict';
+const { Readable, Writable } = require('stream');
+const { cppdb } = require('../util');
+
+module.exports = function openBlob(table, column, rowid, options) {
+	if (options == null) options = {};
+
+	// Validate arguments
+	if (typeof table !== 'string') throw new TypeError('Expected first argument to be a string');
+	if (typeof column !== 'string') throw new TypeError('Expected second argument to be a string');
+	if (!Number.isInteger(rowid) && typeof rowid !== 'bigint') throw new TypeError('Expected third argument to be an integer rowid');
+	if (typeof options !== 'object') throw new TypeError('Expected fourth argument to be an options object');
+
+	// Interpret options
+	const readonly = 'readonly' in options ? options.readonly : true;
+	const attachedName = 'attached' in options ? options.attached : 'main';
+
+	// Validate interpreted options
+	if (typeof readonly !== 'boolean') throw new TypeError('Expected the "readonly" option to be a boolean');
+	if (typeof attachedName !== 'string' || !attachedName) throw new TypeError('Expected the "attached" option to be a non-empty string');
+
+	return new Blob(this, this[cppdb].openBlob(table, column, rowid, readonly, attachedName));
+};
+
+class Blob {
+	constructor(db, handle) {
+		this.database = db;
+		this._handle = handle;
+	}
+
+	get length() { return this._handle.length; }
+	get readonly() { return this._handle.readonly; }
+	get open() { return this._handle.open; }
+
+	// Reads up to `length` bytes at `offset` into `target` (or a new Buffer)
+	read(offset = 0, length = this.length - offset, target = null) {
+		if (!Number.isInteger(offset) || offset < 0) throw new TypeError('Expected offset to be a non-negative integer');
+		if (!Number.isInteger(length) || length < 0) throw new TypeError('Expected length to be a non-negative integer');
+		if (target == null) target = Buffer.allocUnsafe(Math.max(0, Math.min(length, this.length - offset)));
+		else if (!Buffer.isBuffer(target)) throw new TypeError('Expected target to be a Buffer');
+		const bytesRead = this._handle.read(target, 0, Math.min(length, target.length), offset);
+		return bytesRead === target.length ? target : target.subarray(0, bytesRead);
+	}
+
+	write(offset, buffer) {
+		if (!Number.isInteger(offset) || offset < 0) throw new TypeError('Expected offset to be a non-negative integer');
+		if (!ArrayBuffer.isView(buffer)) throw new TypeError('Expected a Buffer or TypedArray');
+		this._handle.write(Buffer.from(buffer.buffer, buffer.byteOffset, buffer.byteLength), offset);
+		return this;
+	}
+
+	reopen(rowid) {
+		if (!Number.isInteger(rowid) && typeof rowid !== 'bigint') throw new TypeError('Expected an integer rowid');
+		this._handle.reopen(rowid);
+		return this;
+	}
+
+	close() {
+		this._handle.close();
+		return this;
+	}
+
+	createReadStream(options) {
+		if (options == null) options = {};
+		const start = 'start' in options ? options.start : 0;
+		const end = 'end' in options ? Math.min(options.end + 1, this.length) : this.length;
+		const highWaterMark = 'highWaterMark' in options ? options.highWaterMark : 64 * 1024;
+		if (!Number.isInteger(start) || start < 0) throw new TypeError('Expected the "start" option to be a non-negative integer');
+		if (!Number.isInteger(end)) throw new TypeError('Expected the "end" option to be an integer');
+
+		let position = start;
+		const handle = this._handle;
+		return new Readable({
+			highWaterMark,
+			read(size) {
+				try {
+					const length = Math.min(size, end - position);
+					if (length <= 0) return void this.push(null);
+					const chunk = Buffer.allocUnsafe(length);
+					const bytesRead = handle.read(chunk, 0, length, position);
+					// Only the bytes read are initialized; nothing read means the end
+					if (bytesRead <= 0) return void this.push(null);
+					position += bytesRead;
+					this.push(bytesRead < length ? chunk.subarray(0, bytesRead) : chunk);
+				} catch (err) {
+					this.destroy(err);
+				}
+			},
+		});
+	}
+
+	// Writes in place; the blob must already be large enough (see zeroblob())
+	createWriteStream(options) {
+		if (options == null) options = {};
+		const start = 'start' in options ? options.start : 0;
+		if (!Number.isInteger(start) || start < 0) throw new TypeError('Expected the "start" option to be a non-negative integer');
+
+		let position = start;
+		const handle = this._handle;
+		return new Writable({
+			write(chunk, encoding, callback) {
+				try {
+					position += handle.write(chunk, position);
+					callback();
+				} catch (err) {
+					callback(err);
+				}
+			},
+		});
+	}
+}
+
+module.exports.Blob = Blob;
@@ -0,0 +1,47 @@
+'use strict';
+const { cppdb } = require('../util');
+const SqliteError = require('../sqlite-error');
+
+module.exports = function withDeadline(options, fn) {
+	if (typeof options === 'number') options = { timeout: options };
+
+	// Validate arguments
+	if (options == null || typeof options !== 'object') throw new TypeError('Expected first argument to be a timeout or an options object');
+	if (typeof fn !== 'function') throw new TypeError('Expected second argument to be a function');
+
+	// Interpret and validate options
+	const timeout = 'timeout' in options ? options.timeout : null;
+	const signal = 'signal' in options ? options.signal : null;
+	if (timeout != null && (!Number.isInteger(timeout) || timeout < 0 || timeout > 0x7fffffff)) throw new TypeError('Expected the "timeout" option to be a non-negative integer');
+	if (signal != null && (typeof signal.aborted !== 'boolean' || typeof signal.addEventListener !== 'function')) throw new TypeError('Expected the "signal" option to be an AbortSignal');
+	if (signal && signal.aborted) throw new SqliteError('interrupted', 'SQLITE_INTERRUPT');
+
+	// Statements run while the scope is active (including across awaits) are
+	// bounded by its deadline; an abort expires it and interrupts the connection.
+	// Each deadline is removed by its own token, so overlapping async scopes
+	// can finish in any order
+	const db = this[cppdb];
+	const tokens = timeout != null ? [db.pushDeadline(timeout)] : [];
+	const onAbort = () => {
+		db.interrupt();
+		tokens.push(db.pushDeadline(0));
+	};
+	if (signal) signal.addEventListener('abort', onAbort, { once: true });
+	const finish = () => {
+		if (signal) signal.removeEventListener('abort', onAbort);
+		for (const token of tokens) db.popDeadline(token);
+	};
+
+	let result;
+	try {
+		result = fn.call(this);
+	} catch (err) {
+		finish();
+		throw err;
+	}
+	if (result != null && typeof result.then === 'function') {
+		return Promise.resolve(result).finally(finish);
+	}
+	finish();
+	return result;
+};
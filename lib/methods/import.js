@@ -0,0 +1,40 @@
+'use strict';
+const { cppdb } = require('../util');
+
+// Loads an NDJSON or CSV file into a table on a native worker thread, using
+// a second connection to the same database file. Resolves with
+// { rows, lines, skipped, errors: [{ line, message }] }.
+module.exports = function importFile(file, options) {
+	// Validate arguments
+	if (typeof file !== 'string') throw new TypeError('Expected first argument to be a string');
+	if (options == null || typeof options !== 'object') throw new TypeError('Expected second argument to be an options object');
+
+	// Interpret and validate options
+	const table = options.table;
+	const format = 'format' in options ? options.format : (/\.csv$/i.test(file) ? 'csv' : 'ndjson');
+	const columns = 'columns' in options ? options.columns : null;
+	const header = 'header' in options ? options.header : true;
+	const onConflict = 'onConflict' in options ? options.onConflict : 'abort';
+	const batchSize = 'batchSize' in options ? options.batchSize : 10000;
+	const skipErrors = 'skipErrors' in options ? options.skipErrors : false;
+	const onProgress = 'onProgress' in options ? options.onProgress : null;
+	if (typeof table !== 'string' || !table) throw new TypeError('Expected the "table" option to be a string');
+	if (format !== 'ndjson' && format !== 'csv') throw new TypeError('Expected the "format" option to be "ndjson" or "csv"');
+	if (columns != null && (!Array.isArray(columns) || !columns.length || !columns.every(x => typeof x === 'string'))) throw new TypeError('Expected the "columns" option to be a non-empty array of strings');
+	if (typeof header !== 'boolean') throw new TypeError('Expected the "header" option to be a boolean');
+	if (onConflict !== 'abort' && onConflict !== 'ignore' && onConflict !== 'replace') throw new TypeError('Expected the "onConflict" option to be "abort", "ignore" or "replace"');
+	if (!Number.isInteger(batchSize) || batchSize < 1) throw new TypeError('Expected the "batchSize" option to be a positive integer');
+	if (typeof skipErrors !== 'boolean') throw new TypeError('Expected the "skipErrors" option to be a boolean');
+	if (onProgress != null && typeof onProgress !== 'function') throw new TypeError('Expected the "onProgress" option to be a function');
+
+	return this[cppdb].importFile(file, {
+		table,
+		format,
+		columns,
+		header,
+		conflict: onConflict === 'abort' ? '' : onConflict.toUpperCase(),
+		batchSize,
+		skipErrors,
+		onProgress,
+	});
+};
@@ -0,0 +1,40 @@
+'use strict';
+const { busyTimeout } = require('../util');
+
+// Runs fn, retrying it after SQLITE_BUSY with exponential backoff and full
+// jitter on the event loop. fn is the unit of retry: a statement or a whole
+// transaction function (a busy transaction has already been rolled back).
+module.exports = function retryOnBusy(fn, options) {
+	if (options == null) options = {};
+
+	// Validate arguments
+	if (typeof fn !== 'function') throw new TypeError('Expected first argument to be a function');
+	if (typeof options !== 'object') throw new TypeError('Expected second argument to be an options object');
+
+	// Interpret and validate options
+	const maxWait = 'maxWait' in options ? options.maxWait : this[busyTimeout];
+	const initialDelay = 'initialDelay' in options ? options.initialDelay : 2;
+	const maxDelay = 'maxDelay' in options ? options.maxDelay : 200;
+	if (!Number.isInteger(maxWait) || maxWait < 0) throw new TypeError('Expected the "maxWait" option to be a non-negative integer');
+	if (!Number.isInteger(initialDelay) || initialDelay < 1) throw new TypeError('Expected the "initialDelay" option to be a positive integer');
+	if (!Number.isInteger(maxDelay) || maxDelay < initialDelay) throw new TypeError('Expected the "maxDelay" option to be an integer no smaller than "initialDelay"');
+
+	const deadline = Date.now() + maxWait;
+	return new Promise((resolve, reject) => {
+		let delay = initialDelay;
+		const attempt = () => {
+			let result;
+			try {
+				result = fn.call(this);
+			} catch (err) {
+				const remaining = deadline - Date.now();
+				if (err == null || err.code !== 'SQLITE_BUSY' || remaining <= 0) return void reject(err);
+				setTimeout(attempt, Math.min(remaining, Math.ceil(Math.random() * delay)));
+				delay = Math.min(maxDelay, delay * 2);
+				return;
+			}
+			resolve(result);
+		};
+		attempt();
+	});
+};
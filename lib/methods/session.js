@@ -0,0 +1,69 @@
+'use strict';
+const { cppdb } = require('../util');
+
+const POLICIES = ['omit', 'replace', 'abort'];
+
+exports.createSession = function createSession(tables, options) {
+	if (tables != null && !Array.isArray(tables) && typeof tables === 'object') {
+		options = tables;
+		tables = null;
+	}
+	if (options == null) options = {};
+
+	// Validate arguments
+	if (tables != null) {
+		if (!Array.isArray(tables)) throw new TypeError('Expected first argument to be an array of table names');
+		for (const table of tables) {
+			if (typeof table !== 'string') throw new TypeError('Expected every table name to be a string');
+		}
+	}
+	if (typeof options !== 'object') throw new TypeError('Expected second argument to be an options object');
+
+	// Interpret and validate options
+	const attachedName = 'attached' in options ? options.attached : 'main';
+	if (typeof attachedName !== 'string' || !attachedName) throw new TypeError('Expected the "attached" option to be a non-empty string');
+
+	return new Session(this, this[cppdb].createSession(tables == null ? null : tables, attachedName));
+};
+
+exports.applyChangeset = function applyChangeset(changeset, options) {
+	if (options == null) options = {};
+
+	// Validate arguments
+	if (!Buffer.isBuffer(changeset)) throw new TypeError('Expected first argument to be a Buffer');
+	if (typeof options !== 'object') throw new TypeError('Expected second argument to be an options object');
+
+	// Interpret and validate options
+	const onConflict = 'onConflict' in options ? options.onConflict : 'abort';
+	if (typeof onConflict !== 'function' && !POLICIES.includes(onConflict)) {
+		throw new TypeError('Expected the "onConflict" option to be "omit", "replace", "abort" or a function');
+	}
+
+	return this[cppdb].applyChangeset(changeset, onConflict);
+};
+
+class Session {
+	constructor(db, handle) {
+		this.database = db;
+		this._handle = handle;
+	}
+
+	get empty() { return this._handle.empty; }
+	get open() { return this._handle.open; }
+
+	changeset() { return this._handle.changeset(); }
+	patchset() { return this._handle.patchset(); }
+
+	enable(toggle = true) {
+		if (typeof toggle !== 'boolean') throw new TypeError('Expected first argument to be a boolean');
+		this._handle.enable(toggle);
+		return this;
+	}
+
+	close() {
+		this._handle.close();
+		return this;
+	}
+}
+
+exports.Session = Session;
@@ -25,6 +25,35 @@ exports.defaultSafeIntegers = function defaultSafeIntegers(...args) {
 	return this;
 };
 
+exports.cacheStats = function cacheStats(options) {
+	const reset = options != null && typeof options === 'object' && options.reset === true;
+	return this[cppdb].cacheStats(reset);
+};
+
+exports.checkpointStats = function checkpointStats() {
+	return this[cppdb].checkpointStats();
+};
+
+exports.interrupt = function interrupt() {
+	this[cppdb].interrupt();
+	return this;
+};
+
+exports.registerTokenizer = function registerTokenizer(name) {
+	this[cppdb].registerTokenizer(name);
+	return this;
+};
+
+// Runs [statement, params, mode] steps in one native call; with
+// { transaction: true } they share one savepoint
+exports.pipeline = function pipeline(steps, options) {
+	if (!Array.isArray(steps)) throw new TypeError('Expected first argument to be an array of pipeline steps');
+	if (options != null && typeof options !== 'object') throw new TypeError('Expected second argument to be an options object');
+	const transaction = options != null && 'transaction' in options ? options.transaction : false;
+	if (typeof transaction !== 'boolean') throw new TypeError('Expected the "transaction" option to be a boolean');
+	return this[cppdb].pipeline(steps, transaction);
+};
+
 exports.unsafeMode = function unsafeMode(...args) {
 	this[cppdb].unsafeMode(...args);
 	return this;
@@ -9,4 +9,5 @@ exports.getBooleanOption = (options, key) => {
 };
 
 exports.cppdb = Symbol();
+exports.busyTimeout = Symbol();
 exports.inspect = Symbol.for('nodejs.util.inspect.custom');
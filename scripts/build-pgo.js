@@ -0,0 +1,76 @@
+/**
+ * Profile-guided build of the N-API wrapper (GCC/Clang).
+ *
+ *   1. Rebuild with -fprofile-generate (instrumented addon).
+ *   2. Run the training workload: the IOC integration test pattern plus a
+ *      short pass over the benchmark suite, which together exercise the
+ *      prepare/bind/step/column hot paths.
+ *   3. Rebuild with -fprofile-use.
+ *
+ * When deps/sqlite3/sqlite3.c is present the amalgamation is compiled into
+ * the addon with LTO (hexcore_lto=true), so SQLite itself is profiled and
+ * optimized together with the wrapper; otherwise only src/*.cpp benefit.
+ *
+ * Usage: node scripts/build-pgo.js [--no-lto]
+ */
+
+'use strict';
+
+const { execFileSync } = require('child_process');
+const path = require('path');
+const fs = require('fs');
+
+const rootDir = path.resolve(__dirname, '..');
+const pgoDir = path.join(rootDir, '.pgo');
+const amalgamation = path.join(rootDir, 'deps', 'sqlite3', 'sqlite3.c');
+
+if (process.platform === 'win32') {
+	console.error('PGO builds are only supported with GCC/Clang. Use `npm run build:lto` on Windows.');
+	process.exit(1);
+}
+
+const lto = !process.argv.includes('--no-lto') && fs.existsSync(amalgamation);
+const nodeGyp = require.resolve('node-gyp/bin/node-gyp.js');
+
+function rebuild(pgoMode, clang = false) {
+	const args = [nodeGyp, 'rebuild', `--hexcore_pgo=${pgoMode}`, `--hexcore_lto=${lto}`, `--hexcore_pgo_clang=${clang}`];
+	console.log(`\n> node-gyp rebuild (pgo=${pgoMode}, lto=${lto})`);
+	execFileSync(process.execPath, args, { stdio: 'inherit', cwd: rootDir });
+}
+
+function train() {
+	const workloads = [
+		[path.join(rootDir, 'test', 'test_ioc.js')],
+		[path.join(rootDir, 'test', 'test.js')],
+		[path.join(rootDir, 'bench', 'index.js'), '--duration', '200'],
+	];
+	for (const args of workloads) {
+		console.log(`\n> training: ${path.relative(rootDir, args[0])}`);
+		execFileSync(process.execPath, args, { stdio: ['ignore', 'ignore', 'inherit'], cwd: rootDir });
+	}
+}
+
+// Clang writes raw profiles that must be merged before they can be used;
+// returns whether there were any (i.e. the compiler is Clang)
+function mergeClangProfiles() {
+	const raw = fs.readdirSync(pgoDir).filter(f => f.endsWith('.profraw')).map(f => path.join(pgoDir, f));
+	if (!raw.length) return false;
+	const profdata = process.platform === 'darwin' ? ['xcrun', ['llvm-profdata']] : ['llvm-profdata', []];
+	console.log('\n> merging clang profiles');
+	execFileSync(profdata[0], [...profdata[1], 'merge', '-output=' + path.join(pgoDir, 'default.profdata'), ...raw], { stdio: 'inherit' });
+	return true;
+}
+
+fs.rmSync(pgoDir, { recursive: true, force: true });
+fs.mkdirSync(pgoDir, { recursive: true });
+
+if (!lto) {
+	console.log('deps/sqlite3/sqlite3.c not found (or --no-lto): profiling the wrapper only.');
+}
+
+rebuild('generate');
+train();
+const clang = mergeClangProfiles();
+rebuild('use', clang);
+
+console.log('\nDone! Compare with `npm run bench -- --out bench.json` against a regular build.');
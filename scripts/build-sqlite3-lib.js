@@ -37,39 +37,8 @@ for (const header of ['sqlite3.h', 'sqlite3ext.h']) {
 	}
 }
 
-// SQLite compile-time defines (matching the original defines.gypi)
-const defines = [
-	'HAVE_STDINT_H=1',
-	'HAVE_USLEEP=1',
-	'SQLITE_DEFAULT_CACHE_SIZE=-16000',
-	'SQLITE_DEFAULT_FOREIGN_KEYS=1',
-	'SQLITE_DEFAULT_MEMSTATUS=0',
-	'SQLITE_DEFAULT_WAL_SYNCHRONOUS=1',
-	'SQLITE_DQS=0',
-	'SQLITE_ENABLE_COLUMN_METADATA',
-	'SQLITE_ENABLE_DBSTAT_VTAB',
-	'SQLITE_ENABLE_DESERIALIZE',
-	'SQLITE_ENABLE_FTS3',
-	'SQLITE_ENABLE_FTS3_PARENTHESIS',
-	'SQLITE_ENABLE_FTS4',
-	'SQLITE_ENABLE_FTS5',
-	'SQLITE_ENABLE_GEOPOLY',
-	'SQLITE_ENABLE_JSON1',
-	'SQLITE_ENABLE_MATH_FUNCTIONS',
-	'SQLITE_ENABLE_RTREE',
-	'SQLITE_ENABLE_STAT4',
-	'SQLITE_ENABLE_UPDATE_DELETE_LIMIT',
-	'SQLITE_LIKE_DOESNT_MATCH_BLOBS',
-	'SQLITE_OMIT_DEPRECATED',
-	'SQLITE_OMIT_PROGRESS_CALLBACK',
-	'SQLITE_OMIT_SHARED_CACHE',
-	'SQLITE_OMIT_TCL_VARIABLE',
-	'SQLITE_SOUNDEX',
-	'SQLITE_THREADSAFE=2',
-	'SQLITE_TRACE_SIZE_LIMIT=32',
-	'SQLITE_USE_URI=0',
-	'NDEBUG',
-];
+// SQLite compile-time defines (shared with the LTO build in binding.gyp)
+const defines = require('./sqlite3-defines');
 
 const defineFlags = defines.map(d => `-D${d}`);
 
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Generates src/unicode_case_table.h, the case mapping tables behind the
+hex_lower() and hex_casefold() SQL functions, from the Unicode database
+bundled with Python 3.
+
+Usage: python3 scripts/gen-unicode-case.py > src/unicode_case_table.h
+
+Lowercase uses the simple (one code point) mapping. Case folding uses full
+folding (CaseFolding.txt statuses C and F), so a few code points expand,
+e.g. U+00DF -> "ss".
+"""
+
+import sys
+import unicodedata
+
+
+def code_points():
+    for cp in range(0x80, 0x110000):
+        if 0xD800 <= cp < 0xE000:
+            continue
+        yield cp
+
+
+def ranges(mapping):
+    # Compresses (cp -> target) pairs into runs of equal delta, stride 1 or 2
+    items = sorted(mapping.items())
+    out = []
+    i = 0
+    while i < len(items):
+        first, target = items[i]
+        delta = target - first
+        best = (1, 1)
+        for stride in (1, 2):
+            n = 1
+            while (i + n < len(items) and items[i + n][0] == first + n * stride
+                   and items[i + n][1] - items[i + n][0] == delta and n < 0xFFFF):
+                n += 1
+            if n > best[0]:
+                best = (n, stride)
+        count, stride = best
+        out.append((first, count, stride, delta))
+        i += count
+    # The lookup finds the last run starting at or before a code point, so
+    # runs must not interleave
+    for a, b in zip(out, out[1:]):
+        assert a[0] + (a[1] - 1) * a[2] < b[0], hex(b[0])
+    return out
+
+
+def main():
+    lower = {}
+    fold = {}
+    expand = {}
+    for cp in code_points():
+        ch = chr(cp)
+        low = ch.lower()
+        if low != ch:
+            # U+0130 is the only code point whose full mapping has extra marks
+            lower[cp] = ord(low[0])
+        folded = ch.casefold()
+        if len(folded) == 1:
+            if folded != ch:
+                fold[cp] = ord(folded)
+        else:
+            expand[cp] = [ord(c) for c in folded]
+
+    w = sys.stdout.write
+    w('/*\n')
+    w(' * HexCore SQLite3 - Native Node.js Bindings\n')
+    w(' * Unicode Case Tables (generated by scripts/gen-unicode-case.py, Unicode %s)\n' % unicodedata.unidata_version)
+    w(' * Copyright (c) HikariSystem. All rights reserved.\n')
+    w(' * Licensed under MIT License.\n')
+    w(' */\n\n')
+    w('#ifndef UNICODE_CASE_TABLE_H\n#define UNICODE_CASE_TABLE_H\n\n')
+    w('#include <cstdint>\n\n')
+    w('// Runs of code points [first, first + count * stride) mapped by + delta\n')
+    w('struct CaseRange {\n\tuint32_t first;\n\tuint16_t count;\n\tuint8_t stride;\n\tint32_t delta;\n};\n\n')
+    w('struct CaseExpansion {\n\tuint32_t cp;\n\tuint32_t to[3];\n};\n\n')
+    for name, table in (('kLowerRanges', ranges(lower)), ('kFoldRanges', ranges(fold))):
+        w('static const CaseRange %s[] = {\n' % name)
+        for first, count, stride, delta in table:
+            w('\t{ 0x%04X, %d, %d, %d },\n' % (first, count, stride, delta))
+        w('};\n\n')
+    w('static const CaseExpansion kFoldExpansions[] = {\n')
+    for cp in sorted(expand):
+        to = expand[cp] + [0] * (3 - len(expand[cp]))
+        w('\t{ 0x%04X, { 0x%04X, 0x%04X, 0x%04X } },\n' % (cp, to[0], to[1], to[2]))
+    w('};\n\n')
+    w('#endif // UNICODE_CASE_TABLE_H\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,54 @@
+/**
+ * SQLite compile-time defines shared by every way of building the engine:
+ * scripts/build-sqlite3-lib.js (pre-built static library) and the
+ * whole-program LTO/PGO configuration in binding.gyp, which compiles the
+ * amalgamation together with the wrapper.
+ *
+ * Usage: require('./sqlite3-defines') -> string[]
+ *        node scripts/sqlite3-defines.js  (prints one define per line, for gyp)
+ */
+
+'use strict';
+
+const defines = [
+	'HAVE_STDINT_H=1',
+	'HAVE_USLEEP=1',
+	'SQLITE_DEFAULT_CACHE_SIZE=-16000',
+	'SQLITE_DEFAULT_FOREIGN_KEYS=1',
+	'SQLITE_DEFAULT_MEMSTATUS=0',
+	'SQLITE_DEFAULT_WAL_SYNCHRONOUS=1',
+	'SQLITE_DQS=0',
+	'SQLITE_ENABLE_COLUMN_METADATA',
+	'SQLITE_ENABLE_DBSTAT_VTAB',
+	'SQLITE_ENABLE_DESERIALIZE',
+	'SQLITE_ENABLE_FTS3',
+	'SQLITE_ENABLE_FTS3_PARENTHESIS',
+	'SQLITE_ENABLE_FTS4',
+	'SQLITE_ENABLE_FTS5',
+	'SQLITE_ENABLE_GEOPOLY',
+	'SQLITE_ENABLE_JSON1',
+	'SQLITE_ENABLE_MATH_FUNCTIONS',
+	'SQLITE_ENABLE_PREUPDATE_HOOK',
+	'SQLITE_ENABLE_RTREE',
+	'SQLITE_ENABLE_SESSION',
+	'SQLITE_ENABLE_STAT4',
+	'SQLITE_ENABLE_STMT_SCANSTATUS',
+	'SQLITE_ENABLE_UPDATE_DELETE_LIMIT',
+	'SQLITE_LIKE_DOESNT_MATCH_BLOBS',
+	'SQLITE_MAX_MMAP_SIZE=0x10000000000',
+	'SQLITE_OMIT_DEPRECATED',
+	'SQLITE_OMIT_PROGRESS_CALLBACK',
+	'SQLITE_OMIT_SHARED_CACHE',
+	'SQLITE_OMIT_TCL_VARIABLE',
+	'SQLITE_SOUNDEX',
+	'SQLITE_THREADSAFE=2',
+	'SQLITE_TRACE_SIZE_LIMIT=32',
+	'SQLITE_USE_URI=0',
+	'NDEBUG',
+];
+
+module.exports = defines;
+
+if (require.main === module) {
+	console.log(defines.join('\n'));
+}
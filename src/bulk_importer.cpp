@@ -0,0 +1,708 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Bulk NDJSON/CSV Importer Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "bulk_importer.h"
+#include "connection_extensions.h"
+#include "dedup_filter.h"
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEX_IMPORT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Read size; records longer than this grow the buffer
+const size_t kChunk = 4 << 20;
+
+struct Field {
+	int type;           // SQLITE_NULL, _INTEGER, _FLOAT or _TEXT
+	const char* data;   // TEXT in the read buffer, unless scratch >= 0
+	size_t length;
+	int scratch;        // index of the unescaped copy in the scratch list
+	int64_t integer;
+	double real;
+};
+
+const Field kNullField = { SQLITE_NULL, nullptr, 0, -1, 0, 0 };
+
+enum class Status { Record, Blank, NeedMore, Error };
+
+// First byte in [p, end) equal to a, b or c, or end
+const char* FindFirstOf(const char* p, const char* end, char a, char b, char c) {
+#ifdef HEX_IMPORT_SSE2
+	const __m128i va = _mm_set1_epi8(a);
+	const __m128i vb = _mm_set1_epi8(b);
+	const __m128i vc = _mm_set1_epi8(c);
+	while (end - p >= 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)), _mm_cmpeq_epi8(v, vc));
+		unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+		if (mask) {
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return p + index;
+#else
+			return p + __builtin_ctz(mask);
+#endif
+		}
+		p += 16;
+	}
+#endif
+	while (p < end && *p != a && *p != b && *p != c) p++;
+	return p;
+}
+
+size_t CountNewlines(const char* p, const char* end) {
+	size_t count = 0;
+	while ((p = static_cast<const char*>(memchr(p, '\n', end - p))) != nullptr) {
+		count++;
+		p++;
+	}
+	return count;
+}
+
+// Sliding window over the input file; keeps a NUL after the data so number
+// parsing can never run past the buffer
+class Reader {
+public:
+	bool Open(const std::string& path, std::string& error) {
+		std::error_code ec;
+		std::filesystem::path fsPath = std::filesystem::u8path(path);
+		totalBytes_ = std::filesystem::file_size(fsPath, ec);
+		file_.open(fsPath, std::ios::binary);
+		if (ec || !file_) {
+			error = "Cannot open " + path;
+			return false;
+		}
+		buffer_.resize(kChunk + 1);
+		return true;
+	}
+
+	const char* Begin() const { return buffer_.data() + start_; }
+	const char* End() const { return buffer_.data() + end_; }
+	bool Eof() const { return eof_; }
+	uint64_t Consumed() const { return consumed_; }
+	uint64_t TotalBytes() const { return totalBytes_; }
+
+	void Consume(const char* to) {
+		size_t count = static_cast<size_t>(to - Begin());
+		start_ += count;
+		consumed_ += count;
+	}
+
+	// Moves the unconsumed tail to the front and appends the next chunk
+	bool Refill(std::string& error) {
+		size_t pending = end_ - start_;
+		memmove(&buffer_[0], buffer_.data() + start_, pending);
+		start_ = 0;
+		end_ = pending;
+		if (buffer_.size() - 1 - end_ < kChunk / 2) buffer_.resize(buffer_.size() * 2);
+		file_.read(&buffer_[end_], static_cast<std::streamsize>(buffer_.size() - 1 - end_));
+		size_t count = static_cast<size_t>(file_.gcount());
+		if (file_.bad()) {
+			error = "Read error";
+			return false;
+		}
+		if (count == 0) eof_ = true;
+		// UTF-8 byte order mark
+		if (consumed_ == 0 && pending == 0 && count >= 3 && memcmp(buffer_.data(), "\xEF\xBB\xBF", 3) == 0) {
+			start_ = 3;
+			consumed_ = 3;
+		}
+		end_ += count;
+		buffer_[end_] = '\0';
+		return true;
+	}
+
+private:
+	std::ifstream file_;
+	std::vector<char> buffer_;
+	size_t start_ = 0;
+	size_t end_ = 0;
+	bool eof_ = false;
+	uint64_t consumed_ = 0;
+	uint64_t totalBytes_ = 0;
+};
+
+void AppendUtf8(std::string& out, uint32_t cp) {
+	if (cp < 0x80) {
+		out += static_cast<char>(cp);
+	} else if (cp < 0x800) {
+		out += static_cast<char>(0xC0 | (cp >> 6));
+		out += static_cast<char>(0x80 | (cp & 0x3F));
+	} else if (cp < 0x10000) {
+		out += static_cast<char>(0xE0 | (cp >> 12));
+		out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (cp & 0x3F));
+	} else {
+		out += static_cast<char>(0xF0 | (cp >> 18));
+		out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+}
+
+/**
+ * One NDJSON line: a flat object whose values become fields. Strings
+ * without escapes point into the line; nested objects and arrays are bound
+ * as their JSON text.
+ */
+class JsonLine {
+public:
+	JsonLine(const char* p, const char* end, std::vector<std::string>& scratch)
+		: p_(p), end_(end), scratch_(scratch) {}
+
+	// learn: append unknown keys to columns instead of ignoring them
+	bool Parse(std::vector<std::string>& columns, bool learn, std::vector<Field>& fields, std::string& error) {
+		fields.assign(columns.size(), kNullField);
+		SkipSpace();
+		if (!Expect('{')) return Fail(error, "expected a JSON object");
+		SkipSpace();
+		if (Peek() == '}') return true;
+		std::string key;
+		for (;;) {
+			SkipSpace();
+			Field name;
+			if (Peek() != '"' || !ParseString(name)) return Fail(error, "expected a string key");
+			key.assign(Resolve(name), name.length);
+			SkipSpace();
+			if (!Expect(':')) return Fail(error, "expected ':' after key");
+			SkipSpace();
+			Field value;
+			if (!ParseValue(value)) return Fail(error, "invalid value for \"" + key + "\"");
+
+			size_t index = 0;
+			while (index < columns.size() && columns[index] != key) index++;
+			if (index == columns.size() && learn) {
+				columns.push_back(key);
+				fields.push_back(kNullField);
+			}
+			if (index < columns.size()) fields[index] = value;
+
+			SkipSpace();
+			if (Expect(',')) continue;
+			if (Expect('}')) break;
+			return Fail(error, "expected ',' or '}'");
+		}
+		SkipSpace();
+		return p_ == end_ || Fail(error, "unexpected data after the object");
+	}
+
+	const char* Resolve(const Field& field) const {
+		return field.scratch >= 0 ? scratch_[field.scratch].data() : field.data;
+	}
+
+private:
+	char Peek() const { return p_ < end_ ? *p_ : '\0'; }
+
+	bool Expect(char c) {
+		if (p_ < end_ && *p_ == c) {
+			p_++;
+			return true;
+		}
+		return false;
+	}
+
+	void SkipSpace() {
+		while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\r' || *p_ == '\n')) p_++;
+	}
+
+	static bool Fail(std::string& error, const std::string& message) {
+		error = message;
+		return false;
+	}
+
+	bool ParseValue(Field& field) {
+		field = kNullField;
+		char c = Peek();
+		if (c == '"') return ParseString(field);
+		if (c == '-' || (c >= '0' && c <= '9')) return ParseNumber(field);
+		if (c == '{' || c == '[') return ParseNested(field);
+		if (end_ - p_ >= 4 && memcmp(p_, "true", 4) == 0) {
+			field.type = SQLITE_INTEGER;
+			field.integer = 1;
+			p_ += 4;
+			return true;
+		}
+		if (end_ - p_ >= 5 && memcmp(p_, "false", 5) == 0) {
+			field.type = SQLITE_INTEGER;
+			field.integer = 0;
+			p_ += 5;
+			return true;
+		}
+		if (end_ - p_ >= 4 && memcmp(p_, "null", 4) == 0) {
+			p_ += 4;
+			return true;
+		}
+		return false;
+	}
+
+	bool ParseString(Field& field) {
+		p_++; // opening quote
+		const char* start = p_;
+		const char* stop = FindFirstOf(p_, end_, '"', '\\', '"');
+		field.type = SQLITE_TEXT;
+		field.scratch = -1;
+		if (stop < end_ && *stop == '"') {
+			field.data = start;
+			field.length = static_cast<size_t>(stop - start);
+			p_ = stop + 1;
+			return true;
+		}
+
+		// Escapes: decode into a scratch string
+		scratch_.emplace_back(start, stop);
+		std::string& out = scratch_.back();
+		p_ = stop;
+		while (p_ < end_) {
+			char c = *p_++;
+			if (c == '"') {
+				field.scratch = static_cast<int>(scratch_.size() - 1);
+				field.length = out.size();
+				return true;
+			}
+			if (c != '\\') {
+				out += c;
+				continue;
+			}
+			if (p_ >= end_) return false;
+			switch (c = *p_++) {
+				case '"': case '\\': case '/': out += c; break;
+				case 'b': out += '\b'; break;
+				case 'f': out += '\f'; break;
+				case 'n': out += '\n'; break;
+				case 'r': out += '\r'; break;
+				case 't': out += '\t'; break;
+				case 'u': {
+					uint32_t cp;
+					if (!ParseHex4(cp)) return false;
+					if (cp >= 0xD800 && cp < 0xDC00 && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+						const char* saved = p_;
+						p_ += 2;
+						uint32_t low;
+						if (ParseHex4(low) && low >= 0xDC00 && low < 0xE000) {
+							cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+						} else {
+							p_ = saved;
+						}
+					}
+					// Lone surrogates become U+FFFD
+					if (cp >= 0xD800 && cp < 0xE000) cp = 0xFFFD;
+					AppendUtf8(out, cp);
+					break;
+				}
+				default: return false;
+			}
+		}
+		return false;
+	}
+
+	bool ParseHex4(uint32_t& cp) {
+		if (end_ - p_ < 4) return false;
+		cp = 0;
+		for (int i = 0; i < 4; i++) {
+			char c = *p_++;
+			cp <<= 4;
+			if (c >= '0' && c <= '9') cp |= c - '0';
+			else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') cp |= (c | 0x20) - 'a' + 10;
+			else return false;
+		}
+		return true;
+	}
+
+	bool ParseNumber(Field& field) {
+		const char* start = p_;
+		bool negative = Expect('-');
+		uint64_t magnitude = 0;
+		bool overflow = false;
+		const char* digits = p_;
+		while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+			unsigned digit = static_cast<unsigned>(*p_++ - '0');
+			if (magnitude > (UINT64_MAX - digit) / 10) overflow = true;
+			else magnitude = magnitude * 10 + digit;
+		}
+		if (p_ == digits) return false;
+		bool fraction = p_ < end_ && (*p_ == '.' || *p_ == 'e' || *p_ == 'E');
+		uint64_t limit = negative ? static_cast<uint64_t>(INT64_MAX) + 1 : static_cast<uint64_t>(INT64_MAX);
+		if (!fraction && !overflow && magnitude <= limit) {
+			field.type = SQLITE_INTEGER;
+			field.integer = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+			return true;
+		}
+		// The read buffer is NUL-terminated, so strtod stops inside it
+		char* stop = nullptr;
+		field.type = SQLITE_FLOAT;
+		field.real = strtod(start, &stop);
+		if (stop <= start || stop > end_) return false;
+		p_ = stop;
+		return true;
+	}
+
+	bool ParseNested(Field& field) {
+		const char* start = p_;
+		int depth = 0;
+		while (p_ < end_) {
+			char c = *p_++;
+			if (c == '"') {
+				while (p_ < end_ && *p_ != '"') p_ += *p_ == '\\' ? 2 : 1;
+				if (p_ >= end_) return false;
+				p_++;
+			} else if (c == '{' || c == '[') {
+				depth++;
+			} else if ((c == '}' || c == ']') && --depth == 0) {
+				field.type = SQLITE_TEXT;
+				field.data = start;
+				field.length = static_cast<size_t>(p_ - start);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const char* p_;
+	const char* end_;
+	std::vector<std::string>& scratch_;
+};
+
+Status ParseNdjson(const char* p, const char* end, bool eof, std::vector<std::string>& columns, bool learn,
+	std::vector<Field>& fields, std::vector<std::string>& scratch, const char*& next, std::string& error) {
+	const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+	if (!newline && !eof) return Status::NeedMore;
+	const char* lineEnd = newline ? newline : end;
+	next = newline ? newline + 1 : end;
+
+	const char* q = p;
+	while (q < lineEnd && (*q == ' ' || *q == '\t' || *q == '\r')) q++;
+	if (q == lineEnd) return Status::Blank;
+
+	scratch.clear();
+	JsonLine line(q, lineEnd, scratch);
+	return line.Parse(columns, learn, fields, error) ? Status::Record : Status::Error;
+}
+
+// RFC 4180 record; quoted fields may span lines. Empty unquoted fields are
+// NULL, "" is an empty string.
+Status ParseCsv(const char* p, const char* end, bool eof, std::vector<Field>& fields,
+	std::vector<std::string>& scratch, const char*& next, size_t& newlines, std::string& error) {
+	fields.clear();
+	scratch.clear();
+	newlines = 0;
+	const char* q = p;
+	if (*q == '\n' || (*q == '\r' && q + 1 < end && q[1] == '\n')) {
+		next = q + (*q == '\r' ? 2 : 1);
+		newlines = 1;
+		return Status::Blank;
+	}
+
+	for (;;) {
+		Field field = kNullField;
+		if (q < end && *q == '"') {
+			const char* start = ++q;
+			bool escaped = false;
+			for (;;) {
+				const char* quote = static_cast<const char*>(memchr(q, '"', end - q));
+				if (!quote) {
+					if (!eof) return Status::NeedMore;
+					error = "unterminated quoted field";
+					newlines += CountNewlines(start, end);
+					next = end;
+					return Status::Error;
+				}
+				// A quote at the buffer end may be the first half of ""
+				if (quote + 1 >= end && !eof) return Status::NeedMore;
+				if (quote + 1 < end && quote[1] == '"') {
+					escaped = true;
+					q = quote + 2;
+					continue;
+				}
+				newlines += CountNewlines(start, quote);
+				field.type = SQLITE_TEXT;
+				if (escaped) {
+					scratch.emplace_back();
+					std::string& out = scratch.back();
+					for (const char* c = start; c < quote; c++) {
+						out += *c;
+						if (*c == '"') c++;
+					}
+					field.scratch = static_cast<int>(scratch.size() - 1);
+					field.length = out.size();
+				} else {
+					field.data = start;
+					field.length = static_cast<size_t>(quote - start);
+				}
+				q = quote + 1;
+				break;
+			}
+		} else {
+			const char* stop = FindFirstOf(q, end, ',', '\n', '\r');
+			if (stop == end && !eof) return Status::NeedMore;
+			if (stop > q) {
+				field.type = SQLITE_TEXT;
+				field.data = q;
+				field.length = static_cast<size_t>(stop - q);
+			}
+			q = stop;
+		}
+		fields.push_back(field);
+
+		if (q < end && *q == ',') {
+			q++;
+			continue;
+		}
+		if (q + 1 < end && q[0] == '\r' && q[1] == '\n') q++;
+		if (q < end && *q == '\n') {
+			next = q + 1;
+			newlines++;
+			return Status::Record;
+		}
+		if (q >= end) {
+			if (!eof) return Status::NeedMore;
+			next = q;
+			newlines++;
+			return Status::Record;
+		}
+
+		// Text after a closing quote, or a bare CR: skip the rest of the line
+		const char* newline = static_cast<const char*>(memchr(q, '\n', end - q));
+		if (!newline && !eof) return Status::NeedMore;
+		next = newline ? newline + 1 : end;
+		newlines++;
+		error = "unexpected character after field " + std::to_string(fields.size());
+		return Status::Error;
+	}
+}
+
+// Errors a skipped row can cause without affecting the rest of the batch
+bool IsRowError(int rc) {
+	switch (rc & 0xff) {
+		case SQLITE_CONSTRAINT:
+		case SQLITE_MISMATCH:
+		case SQLITE_TOOBIG:
+		case SQLITE_RANGE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+std::string QuoteTable(const std::string& table) {
+	size_t dot = table.find('.');
+	return dot == std::string::npos
+		? DedupFilter::QuoteIdentifier(table)
+		: DedupFilter::QuoteIdentifier(table.substr(0, dot)) + "." + DedupFilter::QuoteIdentifier(table.substr(dot + 1));
+}
+
+class Import {
+public:
+	Import(const BulkImporter::Options& options, const std::function<bool(const BulkImporter::Progress&)>& progress,
+		BulkImporter::Result& result)
+		: options_(options), progress_(progress), result_(result), columns_(options.columns) {}
+
+	~Import() {
+		sqlite3_finalize(insert_);
+		if (inTransaction_) sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+		sqlite3_close(db_);
+	}
+
+	void Run() {
+		int rc = sqlite3_open_v2(options_.database.c_str(), &db_, SQLITE_OPEN_READWRITE,
+			options_.vfs.empty() ? nullptr : options_.vfs.c_str());
+		if (rc != SQLITE_OK) return Fail(rc, 0, db_ ? sqlite3_errmsg(db_) : sqlite3_errstr(rc));
+		sqlite3_extended_result_codes(db_, 1);
+		sqlite3_busy_timeout(db_, options_.busyTimeout);
+		// Triggers, generated columns and indexes may use the addon's SQL
+		// functions, carray() or an IOC tokenizer
+		std::string error;
+		rc = ConnectionExtensions::Register(db_, options_.tokenizers, error);
+		if (rc != SQLITE_OK) return Fail(rc, 0, error);
+
+		if (!reader_.Open(options_.path, error)) return Fail(SQLITE_CANTOPEN, 0, error);
+
+		bool csv = options_.format == BulkImporter::Format::Csv;
+		bool header = csv && options_.header;
+		uint64_t line = 0;
+		for (;;) {
+			const char* p = reader_.Begin();
+			const char* end = reader_.End();
+			if (p == end) {
+				if (reader_.Eof()) break;
+				if (!reader_.Refill(error)) return Fail(SQLITE_IOERR, line, error);
+				continue;
+			}
+
+			const char* next = end;
+			size_t newlines = 1;
+			Status status = csv
+				? ParseCsv(p, end, reader_.Eof(), fields_, scratch_, next, newlines, error)
+				: ParseNdjson(p, end, reader_.Eof(), columns_, insert_ == nullptr && options_.columns.empty(),
+					fields_, scratch_, next, error);
+			if (status == Status::NeedMore) {
+				if (!reader_.Refill(error)) return Fail(SQLITE_IOERR, line, error);
+				continue;
+			}
+			uint64_t recordLine = line + 1;
+			line += newlines;
+			result_.lines = line;
+
+			if (status == Status::Record && header) {
+				header = false;
+				if (columns_.empty()) {
+					for (const Field& field : fields_) {
+						columns_.push_back(field.type == SQLITE_TEXT ? std::string(Text(field), field.length) : std::string());
+					}
+				}
+			} else if (status == Status::Record) {
+				if (!insert_ && !Prepare()) return;
+				if (csv && fields_.size() != columns_.size()) {
+					status = Status::Error;
+					error = "expected " + std::to_string(columns_.size()) + " fields, found " + std::to_string(fields_.size());
+				} else if (!Insert(recordLine)) {
+					return;
+				}
+			}
+			if (status == Status::Error && !RowFailed(SQLITE_OK, recordLine, error)) return;
+
+			// Bound pointers into the buffer are dead once the step is done
+			reader_.Consume(next);
+			if (batched_ >= options_.batchSize && !Commit()) return;
+		}
+		Commit();
+	}
+
+private:
+	const char* Text(const Field& field) const {
+		return field.scratch >= 0 ? scratch_[field.scratch].data() : field.data;
+	}
+
+	void Fail(int rc, uint64_t line, const std::string& message) {
+		result_.failed = true;
+		result_.code = rc == SQLITE_OK ? SQLITE_ERROR : rc;
+		result_.line = line;
+		result_.error = line ? "line " + std::to_string(line) + ": " + message : message;
+	}
+
+	// Records a row that could not be imported; false when the import stops.
+	// Parse errors (rc == SQLITE_OK) are always row errors.
+	bool RowFailed(int rc, uint64_t line, const std::string& message) {
+		if (!options_.skipErrors || (rc != SQLITE_OK && !IsRowError(rc))) {
+			Fail(rc, line, message);
+			return false;
+		}
+		result_.skipped++;
+		if (result_.errors.size() < BulkImporter::kMaxErrors) {
+			result_.errors.push_back(BulkImporter::LineError{ line, message });
+		}
+		return true;
+	}
+
+	bool Prepare() {
+		if (columns_.empty()) {
+			Fail(SQLITE_ERROR, 0, "No columns to import");
+			return false;
+		}
+		std::string names;
+		std::string params;
+		for (size_t i = 0; i < columns_.size(); i++) {
+			names += (i ? ", " : "") + DedupFilter::QuoteIdentifier(columns_[i]);
+			params += i ? ", ?" : "?";
+		}
+		std::string sql = "INSERT " + (options_.conflict.empty() ? std::string() : "OR " + options_.conflict + " ") +
+			"INTO " + QuoteTable(options_.table) + " (" + names + ") VALUES (" + params + ")";
+		int rc = sqlite3_prepare_v3(db_, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &insert_, nullptr);
+		if (rc != SQLITE_OK) {
+			Fail(rc, 0, sqlite3_errmsg(db_));
+			return false;
+		}
+		return true;
+	}
+
+	bool Insert(uint64_t line) {
+		if (!inTransaction_) {
+			int rc = sqlite3_exec(db_, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
+			if (rc != SQLITE_OK) {
+				Fail(rc, line, sqlite3_errmsg(db_));
+				return false;
+			}
+			inTransaction_ = true;
+		}
+
+		for (size_t i = 0; i < columns_.size(); i++) {
+			const Field& field = i < fields_.size() ? fields_[i] : kNullField;
+			int index = static_cast<int>(i) + 1;
+			switch (field.type) {
+				case SQLITE_INTEGER: sqlite3_bind_int64(insert_, index, field.integer); break;
+				case SQLITE_FLOAT: sqlite3_bind_double(insert_, index, field.real); break;
+				case SQLITE_TEXT:
+					sqlite3_bind_text64(insert_, index, Text(field), field.length, SQLITE_STATIC, SQLITE_UTF8);
+					break;
+				default: sqlite3_bind_null(insert_, index); break;
+			}
+		}
+		int rc = sqlite3_step(insert_);
+		sqlite3_reset(insert_);
+		batched_++;
+		if (rc != SQLITE_DONE) return RowFailed(rc, line, sqlite3_errmsg(db_));
+		// OR IGNORE skips rows without an error; only count what went in
+		pending_ += sqlite3_changes(db_);
+		return true;
+	}
+
+	bool Commit() {
+		if (inTransaction_) {
+			int rc = sqlite3_exec(db_, "COMMIT", nullptr, nullptr, nullptr);
+			if (rc != SQLITE_OK) {
+				Fail(rc, result_.lines, sqlite3_errmsg(db_));
+				return false;
+			}
+			inTransaction_ = false;
+			result_.rows += static_cast<uint64_t>(pending_);
+			pending_ = 0;
+			batched_ = 0;
+		}
+		if (!progress_(BulkImporter::Progress{ result_.rows, result_.lines, reader_.Consumed(), reader_.TotalBytes() })) {
+			Fail(SQLITE_INTERRUPT, 0, "Import cancelled");
+			return false;
+		}
+		return true;
+	}
+
+	const BulkImporter::Options& options_;
+	const std::function<bool(const BulkImporter::Progress&)>& progress_;
+	BulkImporter::Result& result_;
+	std::vector<std::string> columns_;
+	sqlite3* db_ = nullptr;
+	sqlite3_stmt* insert_ = nullptr;
+	bool inTransaction_ = false;
+	int64_t batched_ = 0;    // records stepped in the open transaction
+	int64_t pending_ = 0;    // rows they inserted, counted on commit
+	Reader reader_;
+	std::vector<Field> fields_;
+	std::vector<std::string> scratch_;
+};
+
+} // namespace
+
+void BulkImporter::Run(const Options& options, const std::function<bool(const Progress&)>& progress, Result& result) {
+	try {
+		Import(options, progress, result).Run();
+	} catch (const std::bad_alloc&) {
+		result.failed = true;
+		result.code = SQLITE_NOMEM;
+		result.error = sqlite3_errstr(SQLITE_NOMEM);
+	}
+}
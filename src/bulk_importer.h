@@ -0,0 +1,82 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Bulk NDJSON/CSV Importer Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef BULK_IMPORTER_H
+#define BULK_IMPORTER_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * BulkImporter - loads an NDJSON or CSV file into a table on the calling
+ * (worker) thread
+ *
+ * The importer opens its own connection to the database file (same VFS),
+ * so the JS thread keeps its connection while an import runs; writers
+ * serialize on the database lock as usual. The file is read in large
+ * chunks and scanned in place: fields without escapes are bound with
+ * SQLITE_STATIC pointers into the read buffer, and rows are inserted with
+ * one prepared statement inside transactions of batchSize rows.
+ *
+ * Committed batches stay committed when a later row fails; with
+ * skipErrors the failing row is recorded by line number and skipped.
+ */
+class BulkImporter {
+public:
+	enum class Format { Ndjson, Csv };
+
+	struct Options {
+		std::string database; // main database file of the importing connection
+		std::string vfs;      // its VFS name ("" = default)
+		std::string path;
+		std::string table;
+		Format format;
+		std::vector<std::string> columns; // empty = first NDJSON object / CSV header
+		bool header;                      // CSV: first record names the columns
+		std::string conflict;             // "", "IGNORE" or "REPLACE" (INSERT OR ...)
+		int64_t batchSize;
+		bool skipErrors;
+		int busyTimeout;
+		std::vector<std::string> tokenizers; // IOC tokenizers to register
+	};
+
+	struct Progress {
+		uint64_t rows;       // rows inserted so far
+		uint64_t lines;      // input lines consumed
+		uint64_t bytes;      // input bytes consumed
+		uint64_t totalBytes; // file size
+	};
+
+	struct LineError {
+		uint64_t line;
+		std::string message;
+	};
+
+	struct Result {
+		uint64_t rows = 0;
+		uint64_t lines = 0;
+		uint64_t skipped = 0;
+		std::vector<LineError> errors; // first kMaxErrors skipped rows
+		// Set when the import stopped early
+		bool failed = false;
+		int code = SQLITE_OK;
+		uint64_t line = 0; // 0 = not tied to an input line
+		std::string error;
+	};
+
+	static const size_t kMaxErrors = 100;
+
+	// Progress is reported after every committed batch; returning false from
+	// the callback stops the import there. Never throws; failures land in result.
+	static void Run(const Options& options,
+		const std::function<bool(const Progress&)>& progress, Result& result);
+};
+
+#endif // BULK_IMPORTER_H
@@ -0,0 +1,139 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * carray() Table-Valued Function Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "carray.h"
+
+const char* const CArray::kPointerType = "hexcore-carray";
+
+namespace {
+
+enum Column { kValue = 0, kPointer = 1 };
+
+struct Cursor {
+	sqlite3_vtab_cursor base;
+	const CArray::Values* values;
+	size_t row;
+	size_t count;
+};
+
+int Connect(sqlite3* db, void*, int, const char* const*, sqlite3_vtab** vtab, char**) {
+	int rc = sqlite3_declare_vtab(db, "CREATE TABLE x(value, pointer HIDDEN)");
+	if (rc != SQLITE_OK) return rc;
+	*vtab = static_cast<sqlite3_vtab*>(sqlite3_malloc(sizeof(sqlite3_vtab)));
+	if (!*vtab) return SQLITE_NOMEM;
+	**vtab = sqlite3_vtab();
+	sqlite3_vtab_config(db, SQLITE_VTAB_INNOCUOUS);
+	return SQLITE_OK;
+}
+
+int Disconnect(sqlite3_vtab* vtab) {
+	sqlite3_free(vtab);
+	return SQLITE_OK;
+}
+
+// The array argument is required: without a usable pointer = ? constraint
+// the plan is rejected so the planner puts carray() where it is bound
+int BestIndex(sqlite3_vtab*, sqlite3_index_info* info) {
+	for (int i = 0; i < info->nConstraint; i++) {
+		const auto& constraint = info->aConstraint[i];
+		if (constraint.iColumn != kPointer || constraint.op != SQLITE_INDEX_CONSTRAINT_EQ) continue;
+		if (!constraint.usable) return SQLITE_CONSTRAINT;
+		info->aConstraintUsage[i].argvIndex = 1;
+		info->aConstraintUsage[i].omit = 1;
+		info->estimatedCost = 1;
+		info->estimatedRows = 100;
+		return SQLITE_OK;
+	}
+	return SQLITE_CONSTRAINT;
+}
+
+int Open(sqlite3_vtab*, sqlite3_vtab_cursor** cursor) {
+	Cursor* c = static_cast<Cursor*>(sqlite3_malloc(sizeof(Cursor)));
+	if (!c) return SQLITE_NOMEM;
+	*c = Cursor();
+	*cursor = &c->base;
+	return SQLITE_OK;
+}
+
+int Close(sqlite3_vtab_cursor* cursor) {
+	sqlite3_free(cursor);
+	return SQLITE_OK;
+}
+
+int Filter(sqlite3_vtab_cursor* cursor, int, const char*, int argc, sqlite3_value** argv) {
+	Cursor* c = reinterpret_cast<Cursor*>(cursor);
+	c->values = argc > 0 ? static_cast<const CArray::Values*>(sqlite3_value_pointer(argv[0], CArray::kPointerType)) : nullptr;
+	c->count = c->values ? c->values->Size() : 0;
+	c->row = 0;
+	return SQLITE_OK;
+}
+
+int Next(sqlite3_vtab_cursor* cursor) {
+	reinterpret_cast<Cursor*>(cursor)->row++;
+	return SQLITE_OK;
+}
+
+int Eof(sqlite3_vtab_cursor* cursor) {
+	Cursor* c = reinterpret_cast<Cursor*>(cursor);
+	return c->row >= c->count;
+}
+
+int ColumnValue(sqlite3_vtab_cursor* cursor, sqlite3_context* ctx, int column) {
+	Cursor* c = reinterpret_cast<Cursor*>(cursor);
+	if (column != kValue) return SQLITE_OK;  // pointer reads as NULL
+	const CArray::Values& values = *c->values;
+	switch (values.type) {
+		case SQLITE_INTEGER: sqlite3_result_int64(ctx, values.integers[c->row]); break;
+		case SQLITE_FLOAT: sqlite3_result_double(ctx, values.reals[c->row]); break;
+		default: {
+			// The binding (and so the text) outlives every step of the statement
+			const std::string& text = values.texts[c->row];
+			sqlite3_result_text64(ctx, text.data(), text.size(), SQLITE_STATIC, SQLITE_UTF8);
+			break;
+		}
+	}
+	return SQLITE_OK;
+}
+
+int Rowid(sqlite3_vtab_cursor* cursor, sqlite3_int64* rowid) {
+	*rowid = static_cast<sqlite3_int64>(reinterpret_cast<Cursor*>(cursor)->row) + 1;
+	return SQLITE_OK;
+}
+
+void DestroyValues(void* values) {
+	delete static_cast<CArray::Values*>(values);
+}
+
+sqlite3_module MakeModule() {
+	sqlite3_module module = {};
+	module.iVersion = 0;
+	module.xCreate = nullptr;  // eponymous only: carray(...) cannot be CREATEd
+	module.xConnect = Connect;
+	module.xBestIndex = BestIndex;
+	module.xDisconnect = Disconnect;
+	module.xOpen = Open;
+	module.xClose = Close;
+	module.xFilter = Filter;
+	module.xNext = Next;
+	module.xEof = Eof;
+	module.xColumn = ColumnValue;
+	module.xRowid = Rowid;
+	return module;
+}
+
+const sqlite3_module kModule = MakeModule();
+
+} // namespace
+
+int CArray::Register(sqlite3* db) {
+	return sqlite3_create_module(db, "carray", &kModule, nullptr);
+}
+
+int CArray::Bind(sqlite3_stmt* stmt, int index, Values* values) {
+	// sqlite3_bind_pointer() calls the destructor itself if binding fails
+	return sqlite3_bind_pointer(stmt, index, values, kPointerType, DestroyValues);
+}
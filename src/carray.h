@@ -0,0 +1,52 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * carray() Table-Valued Function Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef CARRAY_H
+#define CARRAY_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * CArray - eponymous virtual table carray(?) over an array bound with
+ * sqlite3_bind_pointer()
+ *
+ *   SELECT * FROM ioc WHERE value IN carray(?)
+ *   SELECT ioc.* FROM carray(?) AS k JOIN ioc ON ioc.id = k.value
+ *
+ * The bound array is copied once into a Values block owned by the binding
+ * (freed by SQLite when the parameter is rebound or the statement is
+ * finalized), so one prepared statement serves any batch size without an
+ * SQL value or parameter slot per element. A carray() whose argument is not
+ * such a pointer (NULL, or a plain value) has no rows.
+ */
+class CArray {
+public:
+	// sqlite3_bind_pointer() type tag; values of other types are ignored
+	static const char* const kPointerType;
+
+	struct Values {
+		int type = SQLITE_INTEGER;        // SQLITE_INTEGER, _FLOAT or _TEXT
+		std::vector<int64_t> integers;
+		std::vector<double> reals;
+		std::vector<std::string> texts;
+
+		size_t Size() const {
+			return type == SQLITE_INTEGER ? integers.size() : type == SQLITE_FLOAT ? reals.size() : texts.size();
+		}
+	};
+
+	// Registers the carray module on a connection; returns an SQLite result code
+	static int Register(sqlite3* db);
+
+	// Binds values to parameter index; takes ownership even when binding fails
+	static int Bind(sqlite3_stmt* stmt, int index, Values* values);
+};
+
+#endif // CARRAY_H
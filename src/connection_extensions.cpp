@@ -0,0 +1,27 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Per-Connection Extensions Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "connection_extensions.h"
+#include "carray.h"
+#include "ioc_tokenizer.h"
+#include "text_functions.h"
+
+int ConnectionExtensions::Register(sqlite3* db, const std::vector<std::string>& tokenizers, std::string& error) {
+	// Native normalization functions (hex_lower, hex_casefold, ...)
+	int rc = TextFunctions::Register(db);
+	// carray(?) over arrays bound as pointers
+	if (rc == SQLITE_OK) rc = CArray::Register(db);
+	if (rc != SQLITE_OK) {
+		error = sqlite3_errmsg(db);
+		return rc;
+	}
+	for (const std::string& name : tokenizers) {
+		rc = IocTokenizer::Register(db, name, error);
+		if (rc != SQLITE_OK) return rc;
+	}
+	return SQLITE_OK;
+}
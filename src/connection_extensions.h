@@ -0,0 +1,29 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Per-Connection Extensions Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef CONNECTION_EXTENSIONS_H
+#define CONNECTION_EXTENSIONS_H
+
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+
+/**
+ * ConnectionExtensions - everything the addon registers on a connection
+ *
+ * The text functions, the carray() module and any IOC tokenizers registered
+ * with db.registerTokenizer(). The JS connection and the worker connections
+ * of importFile() and exportTo() all go through Register(), so triggers,
+ * generated columns, views and queries resolve the same way on each.
+ */
+class ConnectionExtensions {
+public:
+	// Returns an SQLite result code; on failure error holds the message
+	static int Register(sqlite3* db, const std::vector<std::string>& tokenizers, std::string& error);
+};
+
+#endif // CONNECTION_EXTENSIONS_H
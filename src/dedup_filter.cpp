@@ -0,0 +1,405 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Insert Dedup Filter Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "dedup_filter.h"
+#include <initializer_list>
+#include <cctype>
+#include <cstring>
+
+namespace {
+
+const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+
+inline uint64_t Rotl(uint64_t x, int r) {
+	return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t Mix(uint64_t h) {
+	h ^= h >> 33;
+	h *= kPrime2;
+	h ^= h >> 29;
+	h *= kPrime1;
+	h ^= h >> 32;
+	return h;
+}
+
+uint64_t HashBytes(uint64_t h, const void* data, size_t len) {
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+	while (len >= 8) {
+		uint64_t word;
+		memcpy(&word, p, 8);
+		h = Rotl(h ^ (word * kPrime2), 31) * kPrime1;
+		p += 8;
+		len -= 8;
+	}
+	uint64_t tail = 0;
+	memcpy(&tail, p, len);
+	h = Rotl(h ^ (tail * kPrime2), 31) * kPrime1;
+	return h;
+}
+
+uint64_t NextPowerOfTwo(uint64_t n) {
+	uint64_t p = 64;
+	while (p < n) p <<= 1;
+	return p;
+}
+
+DedupFilter::Value ColumnValue(sqlite3_stmt* stmt, int col) {
+	DedupFilter::Value value{ sqlite3_column_type(stmt, col), 0, 0, std::string() };
+	switch (value.type) {
+		case SQLITE_INTEGER: value.integer = sqlite3_column_int64(stmt, col); break;
+		case SQLITE_FLOAT: value.real = sqlite3_column_double(stmt, col); break;
+		case SQLITE_TEXT:
+			value.bytes.assign(reinterpret_cast<const char*>(sqlite3_column_text(stmt, col)),
+				static_cast<size_t>(sqlite3_column_bytes(stmt, col)));
+			break;
+		case SQLITE_BLOB:
+			value.bytes.assign(static_cast<const char*>(sqlite3_column_blob(stmt, col)),
+				static_cast<size_t>(sqlite3_column_bytes(stmt, col)));
+			break;
+	}
+	return value;
+}
+
+// Reads one identifier (bare or "..", `..`, [..] quoted); returns its end
+size_t ReadIdentifier(const std::string& sql, size_t i, std::string& out) {
+	out.clear();
+	if (i >= sql.size()) return i;
+	char open = sql[i];
+	char close = open == '[' ? ']' : open;
+	if (open == '"' || open == '`' || open == '[') {
+		for (i++; i < sql.size(); i++) {
+			if (sql[i] == close) {
+				if (close != ']' && i + 1 < sql.size() && sql[i + 1] == close) {
+					out += close;
+					i++;
+					continue;
+				}
+				return i + 1;
+			}
+			out += sql[i];
+		}
+		return i;
+	}
+	while (i < sql.size() && (isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '_' || sql[i] == '$')) {
+		out += sql[i++];
+	}
+	return i;
+}
+
+size_t SkipSpace(const std::string& sql, size_t i) {
+	while (i < sql.size() && isspace(static_cast<unsigned char>(sql[i]))) i++;
+	return i;
+}
+
+// Upper-cased bare words of a statement, skipping comments and string
+// literals; a quoted identifier appears as an empty word
+std::vector<std::string> Keywords(const std::string& sql) {
+	std::vector<std::string> words;
+	size_t i = 0;
+	while ((i = SkipSpace(sql, i)) < sql.size()) {
+		char c = sql[i];
+		if (c == '-' && i + 1 < sql.size() && sql[i + 1] == '-') {
+			i = sql.find('\n', i);
+			if (i == std::string::npos) break;
+		} else if (c == '/' && i + 1 < sql.size() && sql[i + 1] == '*') {
+			i = sql.find("*/", i + 2);
+			if (i == std::string::npos) break;
+			i += 2;
+		} else if (c == '\'') {
+			// '' inside a literal reads as two adjacent literals
+			i = sql.find('\'', i + 1);
+			if (i == std::string::npos) break;
+			i++;
+		} else {
+			std::string word;
+			size_t end = ReadIdentifier(sql, i, word);
+			if (end == i) {
+				i++;
+				continue;
+			}
+			if (c == '"' || c == '`' || c == '[') word.clear();
+			for (char& ch : word) ch = static_cast<char>(toupper(static_cast<unsigned char>(ch)));
+			words.push_back(word);
+			i = end;
+		}
+	}
+	return words;
+}
+
+bool HasSequence(const std::vector<std::string>& words, std::initializer_list<const char*> sequence) {
+	for (size_t i = 0; i + sequence.size() <= words.size(); i++) {
+		size_t n = 0;
+		for (const char* expected : sequence) {
+			if (words[i + n] != expected) break;
+			n++;
+		}
+		if (n == sequence.size()) return true;
+	}
+	return false;
+}
+
+} // namespace
+
+DedupFilter::DedupFilter(uint64_t bits, int hashes, size_t columns)
+	: words_(bits / 64, 0)
+	, mask_(bits - 1)
+	, hashes_(hashes)
+	, columns_(columns)
+	, probe_(nullptr)
+	, keys_(0)
+	, probes_(0)
+	, rejected_(0)
+	, falsePositives_(0)
+{}
+
+DedupFilter::~DedupFilter() {
+	sqlite3_finalize(probe_);
+}
+
+DedupFilter* DedupFilter::Create(sqlite3* db, const std::string& table,
+	const std::vector<std::string>& columns, uint64_t bits, int hashes, std::string& error) {
+	std::string quotedTable;
+	{
+		// "schema.table" is quoted part by part
+		size_t dot = table.find('.');
+		quotedTable = dot == std::string::npos
+			? QuoteIdentifier(table)
+			: QuoteIdentifier(table.substr(0, dot)) + "." + QuoteIdentifier(table.substr(dot + 1));
+	}
+	std::string select;
+	std::string where;
+	for (size_t i = 0; i < columns.size(); i++) {
+		select += (i ? ", " : "") + QuoteIdentifier(columns[i]);
+		where += (i ? " AND " : "") + QuoteIdentifier(columns[i]) + " = ?";
+	}
+
+	if (bits == 0) {
+		sqlite3_stmt* count = nullptr;
+		int64_t rows = 0;
+		if (sqlite3_prepare_v2(db, ("SELECT count(*) FROM " + quotedTable).c_str(), -1, &count, nullptr) == SQLITE_OK &&
+			sqlite3_step(count) == SQLITE_ROW) {
+			rows = sqlite3_column_int64(count, 0);
+		}
+		sqlite3_finalize(count);
+		bits = static_cast<uint64_t>(rows) * 2 * 12;
+		if (bits < (1u << 20)) bits = 1u << 20;
+	}
+
+	DedupFilter* filter = new DedupFilter(NextPowerOfTwo(bits), hashes, columns.size());
+	std::string probeSql = "SELECT 1 FROM " + quotedTable + " WHERE " + where + " LIMIT 1";
+	int rc = sqlite3_prepare_v3(db, probeSql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &filter->probe_, nullptr);
+
+	// Load existing keys; the planner scans the covering UNIQUE index
+	sqlite3_stmt* scan = nullptr;
+	if (rc == SQLITE_OK) {
+		rc = sqlite3_prepare_v2(db, ("SELECT " + select + " FROM " + quotedTable).c_str(), -1, &scan, nullptr);
+	}
+	if (rc == SQLITE_OK) {
+		Key key(columns.size());
+		while ((rc = sqlite3_step(scan)) == SQLITE_ROW) {
+			for (size_t i = 0; i < columns.size(); i++) key[i] = ColumnValue(scan, static_cast<int>(i));
+			filter->Add(key);
+		}
+		if (rc == SQLITE_DONE) rc = SQLITE_OK;
+	}
+	sqlite3_finalize(scan);
+
+	if (rc != SQLITE_OK) {
+		error = sqlite3_errmsg(db);
+		delete filter;
+		return nullptr;
+	}
+	return filter;
+}
+
+uint64_t DedupFilter::Hash(const Key& key) {
+	uint64_t h = kPrime1 ^ key.size();
+	for (const Value& value : key) {
+		h = Mix(h ^ static_cast<uint64_t>(value.type));
+		switch (value.type) {
+			case SQLITE_INTEGER: h = HashBytes(h, &value.integer, sizeof(value.integer)); break;
+			case SQLITE_FLOAT: h = HashBytes(h, &value.real, sizeof(value.real)); break;
+			case SQLITE_TEXT:
+			case SQLITE_BLOB: h = HashBytes(h ^ value.bytes.size(), value.bytes.data(), value.bytes.size()); break;
+		}
+	}
+	return Mix(h);
+}
+
+// Kirsch-Mitzenmacher: k probes from two halves of one 64-bit hash
+bool DedupFilter::MayContain(uint64_t hash) const {
+	uint64_t h1 = hash;
+	uint64_t h2 = Rotl(hash, 32) | 1;
+	for (int i = 0; i < hashes_; i++) {
+		uint64_t bit = (h1 + i * h2) & mask_;
+		if (!(words_[bit >> 6] & (1ULL << (bit & 63)))) return false;
+	}
+	return true;
+}
+
+void DedupFilter::Insert(uint64_t hash) {
+	uint64_t h1 = hash;
+	uint64_t h2 = Rotl(hash, 32) | 1;
+	for (int i = 0; i < hashes_; i++) {
+		uint64_t bit = (h1 + i * h2) & mask_;
+		words_[bit >> 6] |= 1ULL << (bit & 63);
+	}
+}
+
+void DedupFilter::Add(const Key& key) {
+	// NULLs never conflict with a UNIQUE constraint, so such keys are not tracked
+	for (const Value& value : key) {
+		if (value.type == SQLITE_NULL) return;
+	}
+	Insert(Hash(key));
+	keys_++;
+}
+
+bool DedupFilter::IsDuplicate(const Key& key) {
+	for (const Value& value : key) {
+		if (value.type == SQLITE_NULL) return false;
+	}
+	if (!MayContain(Hash(key))) return false;
+
+	probes_++;
+	for (size_t i = 0; i < key.size(); i++) {
+		const Value& value = key[i];
+		int index = static_cast<int>(i) + 1;
+		switch (value.type) {
+			case SQLITE_INTEGER: sqlite3_bind_int64(probe_, index, value.integer); break;
+			case SQLITE_FLOAT: sqlite3_bind_double(probe_, index, value.real); break;
+			case SQLITE_TEXT: sqlite3_bind_text(probe_, index, value.bytes.data(), static_cast<int>(value.bytes.size()), SQLITE_STATIC); break;
+			case SQLITE_BLOB: sqlite3_bind_blob(probe_, index, value.bytes.data(), static_cast<int>(value.bytes.size()), SQLITE_STATIC); break;
+		}
+	}
+	// A failed probe counts as "not found": the INSERT decides
+	bool found = sqlite3_step(probe_) == SQLITE_ROW;
+	sqlite3_reset(probe_);
+	sqlite3_clear_bindings(probe_);
+	if (found) {
+		rejected_++;
+	} else {
+		falsePositives_++;
+	}
+	return found;
+}
+
+DedupFilter::Stats DedupFilter::GetStats() const {
+	return Stats{ keys_, mask_ + 1, hashes_, probes_, rejected_, falsePositives_ };
+}
+
+std::string DedupFilter::QuoteIdentifier(const std::string& name) {
+	std::string quoted = "\"";
+	for (char c : name) {
+		if (c == '"') quoted += '"';
+		quoted += c;
+	}
+	return quoted + "\"";
+}
+
+bool DedupFilter::IgnoresConflicts(const std::string& sql) {
+	std::vector<std::string> words = Keywords(sql);
+	return HasSequence(words, { "INSERT", "OR", "IGNORE" }) || HasSequence(words, { "ON", "CONFLICT", "DO", "NOTHING" });
+}
+
+bool DedupFilter::IsUniqueKey(sqlite3* db, const std::string& table, const std::vector<std::string>& columns) {
+	size_t dot = table.find('.');
+	std::string schema = dot == std::string::npos ? "main" : table.substr(0, dot);
+	std::string name = dot == std::string::npos ? table : table.substr(dot + 1);
+
+	// The probe compares with =, i.e. with each column's own collation
+	std::vector<std::string> collations;
+	bool rowidAlias = false;
+	for (const auto& column : columns) {
+		const char* type = nullptr;
+		const char* collation = nullptr;
+		int primaryKey = 0;
+		if (sqlite3_table_column_metadata(db, schema.c_str(), name.c_str(), column.c_str(),
+			&type, &collation, nullptr, &primaryKey, nullptr) != SQLITE_OK) {
+			return false;
+		}
+		collations.push_back(collation ? collation : "BINARY");
+		rowidAlias = columns.size() == 1 && primaryKey && type && sqlite3_stricmp(type, "INTEGER") == 0;
+	}
+
+	sqlite3_stmt* indexes = nullptr;
+	if (sqlite3_prepare_v2(db, "SELECT name FROM pragma_index_list(?1, ?2) WHERE \"unique\" AND NOT partial",
+		-1, &indexes, nullptr) != SQLITE_OK) {
+		return false;
+	}
+	sqlite3_bind_text(indexes, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+	sqlite3_bind_text(indexes, 2, schema.c_str(), -1, SQLITE_TRANSIENT);
+	sqlite3_stmt* info = nullptr;
+	sqlite3_prepare_v2(db, "SELECT name, coll FROM pragma_index_xinfo(?1, ?2) WHERE key", -1, &info, nullptr);
+
+	bool unique = false;
+	while (!unique && info && sqlite3_step(indexes) == SQLITE_ROW) {
+		sqlite3_bind_text(info, 1, reinterpret_cast<const char*>(sqlite3_column_text(indexes, 0)), -1, SQLITE_TRANSIENT);
+		sqlite3_bind_text(info, 2, schema.c_str(), -1, SQLITE_TRANSIENT);
+		// Same column set, each indexed under the collation the probe uses
+		size_t matched = 0;
+		bool exact = true;
+		while (sqlite3_step(info) == SQLITE_ROW) {
+			const char* column = reinterpret_cast<const char*>(sqlite3_column_text(info, 0));
+			const char* collation = reinterpret_cast<const char*>(sqlite3_column_text(info, 1));
+			size_t c = 0;
+			while (c < columns.size() && !(column && sqlite3_stricmp(columns[c].c_str(), column) == 0)) c++;
+			if (c == columns.size() || !collation || sqlite3_stricmp(collations[c].c_str(), collation) != 0) exact = false;
+			matched++;
+		}
+		sqlite3_reset(info);
+		unique = exact && matched == columns.size();
+	}
+	sqlite3_finalize(info);
+	sqlite3_finalize(indexes);
+
+	// An INTEGER PRIMARY KEY of a rowid table is the rowid and has no index
+	return unique || rowidAlias;
+}
+
+bool DedupFilter::ParseInsert(const std::string& sql, std::string& table, std::vector<std::string>& columns) {
+	// Locate the INTO keyword outside of identifiers
+	size_t i = 0;
+	for (;;) {
+		i = SkipSpace(sql, i);
+		if (i >= sql.size()) return false;
+		std::string word;
+		size_t end = ReadIdentifier(sql, i, word);
+		if (end == i) {
+			i++;
+			continue;
+		}
+		i = end;
+		if (word.size() == 4 && sqlite3_strnicmp(word.c_str(), "into", 4) == 0) break;
+	}
+
+	i = ReadIdentifier(sql, SkipSpace(sql, i), table);
+	if (table.empty()) return false;
+	if (i < sql.size() && sql[i] == '.') {
+		std::string name;
+		i = ReadIdentifier(sql, i + 1, name);
+		table += "." + name;
+	}
+
+	i = SkipSpace(sql, i);
+	if (i >= sql.size() || sql[i] != '(') return false;
+	columns.clear();
+	for (i++;;) {
+		std::string column;
+		i = ReadIdentifier(sql, SkipSpace(sql, i), column);
+		if (column.empty()) return false;
+		columns.push_back(column);
+		i = SkipSpace(sql, i);
+		if (i < sql.size() && sql[i] == ',') {
+			i++;
+			continue;
+		}
+		return i < sql.size() && sql[i] == ')';
+	}
+}
@@ -0,0 +1,95 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Insert Dedup Filter Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef DEDUP_FILTER_H
+#define DEDUP_FILTER_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * DedupFilter - Bloom filter over the key columns of a UNIQUE constraint,
+ * attached to an INSERT OR IGNORE statement
+ *
+ * A run whose key the filter has never seen is definitely new and goes
+ * straight to the INSERT. A key the filter may contain is confirmed with a
+ * read-only probe that binds only the key columns; confirmed duplicates are
+ * skipped without binding the full row or opening a write transaction.
+ * Filter misses are always safe (SQLite still enforces the constraint), so
+ * rows deleted or inserted elsewhere only cost extra probes.
+ *
+ * The filter is built from the table (covered by the UNIQUE index) when it is
+ * attached, which is how it persists across restarts, and grows with every
+ * successful insert.
+ */
+class DedupFilter {
+public:
+	// One key column value, typed the way it is bound
+	struct Value {
+		int type;            // SQLITE_INTEGER, _FLOAT, _TEXT, _BLOB or _NULL
+		int64_t integer;
+		double real;
+		std::string bytes;   // TEXT / BLOB payload
+	};
+	typedef std::vector<Value> Key;
+
+	struct Stats {
+		uint64_t keys;            // keys added (loaded + inserted)
+		uint64_t bits;
+		int hashes;
+		uint64_t probes;          // filter hits confirmed against the table
+		uint64_t rejected;        // duplicates skipped
+		uint64_t falsePositives;  // filter hits the table did not contain
+	};
+
+	// Builds the filter from `table`; returns nullptr and fills error on failure.
+	// bits == 0 sizes the filter from the current row count (~12 bits per key,
+	// with room to double).
+	static DedupFilter* Create(sqlite3* db, const std::string& table,
+		const std::vector<std::string>& columns, uint64_t bits, int hashes, std::string& error);
+	~DedupFilter();
+
+	// True if the key is in the table already (filter hit confirmed by a probe)
+	bool IsDuplicate(const Key& key);
+	// Records a key that is now in the table
+	void Add(const Key& key);
+
+	Stats GetStats() const;
+	size_t ColumnCount() const { return columns_; }
+
+	// True for INSERT OR IGNORE and ON CONFLICT DO NOTHING, where a skipped
+	// duplicate reports the same result as SQLite would
+	static bool IgnoresConflicts(const std::string& sql);
+	// True if columns are exactly the key of a UNIQUE index (or the PRIMARY
+	// KEY) of table, indexed under the collations the probe compares with
+	static bool IsUniqueKey(sqlite3* db, const std::string& table, const std::vector<std::string>& columns);
+	// Finds the table and column list of an "INSERT ... INTO table (cols...)"
+	static bool ParseInsert(const std::string& sql, std::string& table, std::vector<std::string>& columns);
+	static std::string QuoteIdentifier(const std::string& name);
+
+private:
+	DedupFilter(uint64_t bits, int hashes, size_t columns);
+
+	static uint64_t Hash(const Key& key);
+	bool MayContain(uint64_t hash) const;
+	void Insert(uint64_t hash);
+
+	std::vector<uint64_t> words_;
+	uint64_t mask_;          // bits - 1 (bits is a power of two)
+	int hashes_;
+	size_t columns_;
+	sqlite3_stmt* probe_;
+
+	uint64_t keys_;
+	uint64_t probes_;
+	uint64_t rejected_;
+	uint64_t falsePositives_;
+};
+
+#endif // DEDUP_FILTER_H
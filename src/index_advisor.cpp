@@ -0,0 +1,586 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Index Advisor Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "index_advisor.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <unordered_set>
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Workload capture
+// ----------------------------------------------------------------------------
+
+struct ColumnSpec {
+	int column;
+	std::string collation;
+	bool desc;
+};
+
+struct Scan {
+	size_t table;
+	size_t query;
+	std::vector<ColumnSpec> eq;
+	std::vector<ColumnSpec> range;
+	std::vector<ColumnSpec> order;
+};
+
+struct TableInfo {
+	std::string name;
+	std::vector<std::string> columns;
+	std::vector<std::string> collations;
+};
+
+struct AdvisorState {
+	std::vector<TableInfo> tables;
+	std::vector<Scan> scans;
+	size_t currentQuery;
+};
+
+struct ExpertVtab {
+	sqlite3_vtab base;
+	AdvisorState* state;
+	size_t table;
+};
+
+struct ExpertCursor {
+	sqlite3_vtab_cursor base;
+};
+
+std::string QuoteId(const std::string& id) {
+	std::string out = "\"";
+	for (char c : id) {
+		if (c == '"') out += '"';
+		out += c;
+	}
+	out += '"';
+	return out;
+}
+
+int ExpertConnect(sqlite3* db, void* aux, int argc, const char* const* argv, sqlite3_vtab** ppVtab, char** pzErr) {
+	AdvisorState* state = static_cast<AdvisorState*>(aux);
+	if (argc < 4) {
+		*pzErr = sqlite3_mprintf("hexcore_expert: missing table index");
+		return SQLITE_ERROR;
+	}
+	size_t table = static_cast<size_t>(strtoul(argv[3], nullptr, 10));
+	if (table >= state->tables.size()) {
+		*pzErr = sqlite3_mprintf("hexcore_expert: bad table index");
+		return SQLITE_ERROR;
+	}
+
+	const TableInfo& info = state->tables[table];
+	std::string decl = "CREATE TABLE x(";
+	for (size_t i = 0; i < info.columns.size(); i++) {
+		if (i) decl += ", ";
+		decl += QuoteId(info.columns[i]);
+		if (!info.collations[i].empty()) {
+			decl += " COLLATE " + QuoteId(info.collations[i]);
+		}
+	}
+	decl += ")";
+
+	int rc = sqlite3_declare_vtab(db, decl.c_str());
+	if (rc != SQLITE_OK) return rc;
+
+	ExpertVtab* vtab = static_cast<ExpertVtab*>(sqlite3_malloc(sizeof(ExpertVtab)));
+	if (!vtab) return SQLITE_NOMEM;
+	memset(vtab, 0, sizeof(ExpertVtab));
+	vtab->state = state;
+	vtab->table = table;
+	*ppVtab = &vtab->base;
+	return SQLITE_OK;
+}
+
+int ExpertDisconnect(sqlite3_vtab* vtab) {
+	sqlite3_free(vtab);
+	return SQLITE_OK;
+}
+
+void AddUnique(std::vector<ColumnSpec>& list, const ColumnSpec& spec) {
+	for (const auto& c : list) {
+		if (c.column == spec.column) return;
+	}
+	list.push_back(spec);
+}
+
+int ExpertBestIndex(sqlite3_vtab* base, sqlite3_index_info* info) {
+	ExpertVtab* vtab = reinterpret_cast<ExpertVtab*>(base);
+	Scan scan;
+	scan.table = vtab->table;
+	scan.query = vtab->state->currentQuery;
+
+	int argv = 0;
+	for (int i = 0; i < info->nConstraint; i++) {
+		const auto& c = info->aConstraint[i];
+		if (!c.usable || c.iColumn < 0) continue;
+		const char* coll = sqlite3_vtab_collation(info, i);
+		ColumnSpec spec{ c.iColumn, coll && sqlite3_stricmp(coll, "BINARY") != 0 ? coll : "", false };
+		switch (c.op) {
+			case SQLITE_INDEX_CONSTRAINT_EQ:
+			case SQLITE_INDEX_CONSTRAINT_IS:
+				AddUnique(scan.eq, spec);
+				// Claim equality constraints so join orders look like they would with an index
+				info->aConstraintUsage[i].argvIndex = ++argv;
+				break;
+			case SQLITE_INDEX_CONSTRAINT_GT:
+			case SQLITE_INDEX_CONSTRAINT_GE:
+			case SQLITE_INDEX_CONSTRAINT_LT:
+			case SQLITE_INDEX_CONSTRAINT_LE:
+				AddUnique(scan.range, spec);
+				break;
+			default:
+				break;
+		}
+	}
+	for (int i = 0; i < info->nOrderBy; i++) {
+		const auto& o = info->aOrderBy[i];
+		if (o.iColumn < 0) break;
+		scan.order.push_back(ColumnSpec{ o.iColumn, vtab->state->tables[vtab->table].collations[o.iColumn], o.desc != 0 });
+	}
+
+	info->estimatedCost = 1000000.0 / (argv + 1);
+	if (!scan.eq.empty() || !scan.range.empty() || !scan.order.empty()) {
+		vtab->state->scans.push_back(std::move(scan));
+	}
+	return SQLITE_OK;
+}
+
+int ExpertOpen(sqlite3_vtab*, sqlite3_vtab_cursor** ppCursor) {
+	ExpertCursor* cur = static_cast<ExpertCursor*>(sqlite3_malloc(sizeof(ExpertCursor)));
+	if (!cur) return SQLITE_NOMEM;
+	memset(cur, 0, sizeof(ExpertCursor));
+	*ppCursor = &cur->base;
+	return SQLITE_OK;
+}
+
+int ExpertClose(sqlite3_vtab_cursor* cur) {
+	sqlite3_free(cur);
+	return SQLITE_OK;
+}
+
+// The workload is only ever prepared against the expert tables, never stepped
+int ExpertFilter(sqlite3_vtab_cursor*, int, const char*, int, sqlite3_value**) { return SQLITE_OK; }
+int ExpertNext(sqlite3_vtab_cursor*) { return SQLITE_OK; }
+int ExpertEof(sqlite3_vtab_cursor*) { return 1; }
+int ExpertColumn(sqlite3_vtab_cursor*, sqlite3_context*, int) { return SQLITE_OK; }
+int ExpertRowid(sqlite3_vtab_cursor*, sqlite3_int64* rowid) { *rowid = 0; return SQLITE_OK; }
+
+sqlite3_module MakeExpertModule() {
+	sqlite3_module module = {};
+	module.iVersion = 0;
+	module.xCreate = ExpertConnect;
+	module.xConnect = ExpertConnect;
+	module.xBestIndex = ExpertBestIndex;
+	module.xDisconnect = ExpertDisconnect;
+	module.xDestroy = ExpertDisconnect;
+	module.xOpen = ExpertOpen;
+	module.xClose = ExpertClose;
+	module.xFilter = ExpertFilter;
+	module.xNext = ExpertNext;
+	module.xEof = ExpertEof;
+	module.xColumn = ExpertColumn;
+	module.xRowid = ExpertRowid;
+	return module;
+}
+
+const sqlite3_module kExpertModule = MakeExpertModule();
+
+// ----------------------------------------------------------------------------
+// Helpers
+// ----------------------------------------------------------------------------
+
+struct SchemaObject {
+	std::string type;
+	std::string name;
+	std::string table;
+	std::string sql;
+};
+
+int ExecAll(sqlite3* db, const std::string& sql, std::string& error) {
+	char* msg = nullptr;
+	int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &msg);
+	if (rc != SQLITE_OK) {
+		error = msg ? msg : sqlite3_errstr(rc);
+	}
+	sqlite3_free(msg);
+	return rc;
+}
+
+// Runs a query returning a single integer (e.g. a count)
+int64_t QueryInt(sqlite3* db, const std::string& sql) {
+	sqlite3_stmt* stmt = nullptr;
+	int64_t result = -1;
+	if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+		result = sqlite3_column_int64(stmt, 0);
+	}
+	sqlite3_finalize(stmt);
+	return result;
+}
+
+const char* ColumnText(sqlite3_stmt* stmt, int col) {
+	const unsigned char* text = sqlite3_column_text(stmt, col);
+	return text ? reinterpret_cast<const char*>(text) : "";
+}
+
+int LoadSchema(sqlite3* db, std::vector<SchemaObject>& objects, std::unordered_set<std::string>& virtualTables, std::string& error) {
+	std::unordered_set<std::string> shadow;
+	sqlite3_stmt* stmt = nullptr;
+	int rc = sqlite3_prepare_v2(db, "SELECT name, type FROM pragma_table_list WHERE schema = 'main'", -1, &stmt, nullptr);
+	if (rc != SQLITE_OK) {
+		error = sqlite3_errmsg(db);
+		return rc;
+	}
+	while (sqlite3_step(stmt) == SQLITE_ROW) {
+		std::string type = ColumnText(stmt, 1);
+		if (type == "shadow") shadow.insert(ColumnText(stmt, 0));
+		else if (type == "virtual") virtualTables.insert(ColumnText(stmt, 0));
+	}
+	sqlite3_finalize(stmt);
+
+	rc = sqlite3_prepare_v2(db,
+		"SELECT type, name, tbl_name, sql FROM main.sqlite_schema "
+		"WHERE sql IS NOT NULL AND type IN ('table', 'index', 'view') AND name NOT LIKE 'sqlite_%' "
+		"ORDER BY CASE type WHEN 'table' THEN 0 WHEN 'index' THEN 1 ELSE 2 END, rowid",
+		-1, &stmt, nullptr);
+	if (rc != SQLITE_OK) {
+		error = sqlite3_errmsg(db);
+		return rc;
+	}
+	while (sqlite3_step(stmt) == SQLITE_ROW) {
+		SchemaObject obj{ ColumnText(stmt, 0), ColumnText(stmt, 1), ColumnText(stmt, 2), ColumnText(stmt, 3) };
+		if (shadow.count(obj.table)) continue;
+		objects.push_back(std::move(obj));
+	}
+	sqlite3_finalize(stmt);
+	return SQLITE_OK;
+}
+
+int LoadTable(sqlite3* db, const std::string& name, TableInfo& table) {
+	table.name = name;
+	sqlite3_stmt* stmt = nullptr;
+	std::string sql = "SELECT name FROM pragma_table_xinfo(" + QuoteId(name) + ", 'main')";
+	int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+	if (rc != SQLITE_OK) return rc;
+	while (sqlite3_step(stmt) == SQLITE_ROW) {
+		std::string column = ColumnText(stmt, 0);
+		const char* collation = nullptr;
+		sqlite3_table_column_metadata(db, "main", name.c_str(), column.c_str(), nullptr, &collation, nullptr, nullptr, nullptr);
+		table.columns.push_back(column);
+		table.collations.push_back(collation && sqlite3_stricmp(collation, "BINARY") != 0 ? collation : "");
+	}
+	return sqlite3_finalize(stmt);
+}
+
+// Key columns (by name) of every existing index, grouped by table
+std::map<std::string, std::vector<std::vector<std::string>>> LoadIndexColumns(sqlite3* db) {
+	std::map<std::string, std::vector<std::vector<std::string>>> result;
+	sqlite3_stmt* stmt = nullptr;
+	const char* sql =
+		"SELECT m.name, l.name, i.name FROM main.sqlite_schema m, pragma_index_list(m.name, 'main') l, "
+		"pragma_index_info(l.name, 'main') i WHERE m.type = 'table' ORDER BY m.name, l.name, i.seqno";
+	if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return result;
+
+	std::string currentIndex;
+	while (sqlite3_step(stmt) == SQLITE_ROW) {
+		std::string table = ColumnText(stmt, 0);
+		std::string index = ColumnText(stmt, 1);
+		auto& indexes = result[table];
+		if (index != currentIndex || indexes.empty()) {
+			indexes.emplace_back();
+			currentIndex = index;
+		}
+		indexes.back().push_back(ColumnText(stmt, 2));
+	}
+	sqlite3_finalize(stmt);
+	return result;
+}
+
+uint32_t Fnv1a(const std::string& s) {
+	uint32_t h = 2166136261u;
+	for (unsigned char c : s) {
+		h ^= c;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+struct Candidate {
+	std::string name;
+	std::string table;
+	std::string sql;
+	std::vector<ColumnSpec> columns;
+};
+
+std::string ColumnDefinition(const TableInfo& table, const ColumnSpec& spec) {
+	std::string def = QuoteId(table.columns[spec.column]);
+	if (!spec.collation.empty()) def += " COLLATE " + spec.collation;
+	if (spec.desc) def += " DESC";
+	return def;
+}
+
+bool IsCoveredByExisting(const TableInfo& table, const std::vector<ColumnSpec>& columns,
+	const std::vector<std::vector<std::string>>& existing) {
+	for (const auto& index : existing) {
+		if (index.size() < columns.size()) continue;
+		bool prefix = true;
+		for (size_t i = 0; i < columns.size() && prefix; i++) {
+			prefix = sqlite3_stricmp(index[i].c_str(), table.columns[columns[i].column].c_str()) == 0;
+		}
+		if (prefix) return true;
+	}
+	return false;
+}
+
+void AddCandidate(const TableInfo& table, std::vector<ColumnSpec> columns,
+	const std::vector<std::vector<std::string>>& existing, std::map<std::string, Candidate>& candidates) {
+	if (columns.empty() || IsCoveredByExisting(table, columns, existing)) return;
+
+	std::string defs;
+	for (size_t i = 0; i < columns.size(); i++) {
+		if (i) defs += ", ";
+		defs += ColumnDefinition(table, columns[i]);
+	}
+	char suffix[16];
+	snprintf(suffix, sizeof(suffix), "_idx_%08x", Fnv1a(table.name + "(" + defs + ")"));
+	std::string name = table.name + suffix;
+	if (candidates.count(name)) return;
+
+	Candidate c;
+	c.name = name;
+	c.table = table.name;
+	c.sql = "CREATE INDEX " + QuoteId(name) + " ON " + QuoteId(table.name) + "(" + defs + ")";
+	c.columns = std::move(columns);
+	candidates.emplace(name, std::move(c));
+}
+
+// Equality columns first, then either one range column or the ORDER BY terms
+void CandidatesForScan(const TableInfo& table, const Scan& scan,
+	const std::vector<std::vector<std::string>>& existing, std::map<std::string, Candidate>& candidates) {
+	if (scan.range.empty()) {
+		AddCandidate(table, scan.eq, existing, candidates);
+	}
+	for (const auto& r : scan.range) {
+		std::vector<ColumnSpec> cols = scan.eq;
+		AddUnique(cols, r);
+		AddCandidate(table, cols, existing, candidates);
+	}
+	if (!scan.order.empty()) {
+		std::vector<ColumnSpec> cols = scan.eq;
+		for (const auto& o : scan.order) AddUnique(cols, o);
+		AddCandidate(table, cols, existing, candidates);
+	}
+}
+
+// Rows read per table when estimating how many rows share an index prefix
+const int64_t kStatSampleRows = 100000;
+
+// Seeds sqlite_stat1 in the scratch schema from the live data so the planner
+// weighs candidates against realistic selectivities. Only tables the workload
+// scans are measured, and distinct counts come from a sample of their rows
+void PopulateStat1(sqlite3* live, sqlite3* scratch, const std::vector<TableInfo>& tables, const std::vector<Scan>& scans) {
+	// The scratch tables are empty, so ANALYZE only creates sqlite_stat1 for us
+	std::string ignored;
+	if (ExecAll(scratch, "ANALYZE; DELETE FROM sqlite_stat1", ignored) != SQLITE_OK) return;
+
+	sqlite3_stmt* insert = nullptr;
+	if (sqlite3_prepare_v2(scratch, "INSERT INTO sqlite_stat1(tbl, idx, stat) VALUES (?, ?, ?)", -1, &insert, nullptr) != SQLITE_OK) {
+		return;
+	}
+
+	std::vector<bool> scanned(tables.size(), false);
+	for (const auto& scan : scans) scanned[scan.table] = true;
+
+	for (size_t t = 0; t < tables.size(); t++) {
+		if (!scanned[t]) continue;
+		const TableInfo& table = tables[t];
+		int64_t rows = QueryInt(live, "SELECT count(*) FROM main." + QuoteId(table.name));
+		// Empty tables keep the planner's default assumptions
+		if (rows <= 0) continue;
+		int64_t sampled = rows < kStatSampleRows ? rows : kStatSampleRows;
+		std::string sample = "(SELECT * FROM main." + QuoteId(table.name) + " LIMIT " + std::to_string(sampled) + ")";
+
+		sqlite3_stmt* indexes = nullptr;
+		std::string sql = "SELECT name FROM pragma_index_list(" + QuoteId(table.name) + ")";
+		if (sqlite3_prepare_v2(scratch, sql.c_str(), -1, &indexes, nullptr) != SQLITE_OK) continue;
+
+		bool any = false;
+		while (sqlite3_step(indexes) == SQLITE_ROW) {
+			std::string index = ColumnText(indexes, 0);
+			sqlite3_stmt* info = nullptr;
+			std::string infoSql = "SELECT name, coll FROM pragma_index_xinfo(" + QuoteId(index) + ") WHERE key = 1";
+			if (sqlite3_prepare_v2(scratch, infoSql.c_str(), -1, &info, nullptr) != SQLITE_OK) continue;
+
+			std::string stat = std::to_string(rows);
+			std::string prefix;
+			bool expression = false;
+			while (sqlite3_step(info) == SQLITE_ROW) {
+				if (sqlite3_column_type(info, 0) == SQLITE_NULL) { expression = true; break; }
+				if (!prefix.empty()) prefix += ", ";
+				prefix += QuoteId(ColumnText(info, 0)) + " COLLATE " + ColumnText(info, 1);
+				int64_t distinct = QueryInt(live, "SELECT count(*) FROM (SELECT DISTINCT " + prefix + " FROM " + sample + ")");
+				int64_t avg = distinct > 0 ? (sampled + distinct - 1) / distinct : sampled;
+				stat += " " + std::to_string(avg);
+			}
+			sqlite3_finalize(info);
+			if (expression) continue;
+
+			sqlite3_bind_text(insert, 1, table.name.c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_text(insert, 2, index.c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_text(insert, 3, stat.c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_step(insert);
+			sqlite3_reset(insert);
+			any = true;
+		}
+		sqlite3_finalize(indexes);
+
+		if (!any) {
+			std::string stat = std::to_string(rows);
+			sqlite3_bind_text(insert, 1, table.name.c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_null(insert, 2);
+			sqlite3_bind_text(insert, 3, stat.c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_step(insert);
+			sqlite3_reset(insert);
+		}
+	}
+	sqlite3_finalize(insert);
+
+	// Reload the statistics into the scratch schema
+	ExecAll(scratch, "ANALYZE sqlite_schema", ignored);
+}
+
+// Extracts the index name from an EXPLAIN QUERY PLAN detail ("... USING [COVERING] INDEX name ...")
+std::string IndexFromDetail(const std::string& detail) {
+	static const char marker[] = "INDEX ";
+	size_t pos = detail.find(marker);
+	if (pos == std::string::npos) return std::string();
+	pos += sizeof(marker) - 1;
+	size_t end = detail.find(' ', pos);
+	return detail.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+}
+
+struct ScratchDb {
+	sqlite3* db = nullptr;
+	~ScratchDb() { if (db) sqlite3_close(db); }
+};
+
+} // namespace
+
+// ============================================================================
+// IndexAdvisor
+// ============================================================================
+
+int IndexAdvisor::QueryPlan(sqlite3* db, const std::string& sql, std::vector<PlanRow>& rows) {
+	sqlite3_stmt* stmt = nullptr;
+	std::string eqp = "EXPLAIN QUERY PLAN " + sql;
+	int rc = sqlite3_prepare_v2(db, eqp.c_str(), -1, &stmt, nullptr);
+	if (rc != SQLITE_OK) return rc;
+	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+		rows.push_back(PlanRow{ sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1), ColumnText(stmt, 3) });
+	}
+	sqlite3_finalize(stmt);
+	return rc == SQLITE_DONE ? SQLITE_OK : rc;
+}
+
+int IndexAdvisor::Advise(sqlite3* db, const std::vector<std::string>& workload, Report& report, std::string& error) {
+	std::vector<SchemaObject> schema;
+	std::unordered_set<std::string> virtualTables;
+	int rc = LoadSchema(db, schema, virtualTables, error);
+	if (rc != SQLITE_OK) return rc;
+
+	AdvisorState state;
+	state.currentQuery = 0;
+
+	ScratchDb expert, scratch;
+	const int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_MEMORY;
+	if ((rc = sqlite3_open_v2(":memory:", &expert.db, flags, nullptr)) != SQLITE_OK ||
+		(rc = sqlite3_open_v2(":memory:", &scratch.db, flags, nullptr)) != SQLITE_OK) {
+		error = "Failed to open scratch database for index advisor";
+		return rc;
+	}
+	rc = sqlite3_create_module(expert.db, "hexcore_expert", &kExpertModule, &state);
+	if (rc != SQLITE_OK) {
+		error = sqlite3_errmsg(expert.db);
+		return rc;
+	}
+
+	// Mirror the schema: expert vtabs for ordinary tables, verbatim for the rest.
+	// Objects whose module is unavailable are skipped; queries using them report an error.
+	std::string ignored;
+	for (const auto& obj : schema) {
+		ExecAll(scratch.db, obj.sql, ignored);
+		if (obj.type == "table" && !virtualTables.count(obj.name)) {
+			TableInfo table;
+			if (LoadTable(db, obj.name, table) != SQLITE_OK) continue;
+			std::string sql = "CREATE VIRTUAL TABLE " + QuoteId(obj.name) + " USING hexcore_expert(" + std::to_string(state.tables.size()) + ")";
+			state.tables.push_back(std::move(table));
+			if (ExecAll(expert.db, sql, ignored) != SQLITE_OK) state.tables.pop_back();
+		} else if (obj.type != "index") {
+			ExecAll(expert.db, obj.sql, ignored);
+		}
+	}
+
+	// Capture the scans of every query
+	report.queries.resize(workload.size());
+	for (size_t q = 0; q < workload.size(); q++) {
+		QueryReport& qr = report.queries[q];
+		qr.sql = workload[q];
+		state.currentQuery = q;
+
+		sqlite3_stmt* stmt = nullptr;
+		if (sqlite3_prepare_v2(expert.db, qr.sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+			qr.error = sqlite3_errmsg(expert.db);
+		}
+		sqlite3_finalize(stmt);
+		if (qr.error.empty() && QueryPlan(db, qr.sql, qr.before) != SQLITE_OK) {
+			qr.error = sqlite3_errmsg(db);
+		}
+	}
+
+	// Derive candidates and create them in the scratch schema
+	auto existing = LoadIndexColumns(db);
+	std::map<std::string, Candidate> candidates;
+	for (const auto& scan : state.scans) {
+		const TableInfo& table = state.tables[scan.table];
+		CandidatesForScan(table, scan, existing[table.name], candidates);
+	}
+	for (auto it = candidates.begin(); it != candidates.end();) {
+		if (ExecAll(scratch.db, it->second.sql, ignored) != SQLITE_OK) {
+			it = candidates.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	PopulateStat1(db, scratch.db, state.tables, state.scans);
+
+	// Keep the candidates the planner actually picks
+	std::set<std::string> recommended;
+	for (auto& qr : report.queries) {
+		if (!qr.error.empty()) continue;
+		if (QueryPlan(scratch.db, qr.sql, qr.after) != SQLITE_OK) {
+			qr.error = sqlite3_errmsg(scratch.db);
+			continue;
+		}
+		for (const auto& row : qr.after) {
+			auto it = candidates.find(IndexFromDetail(row.detail));
+			if (it == candidates.end()) continue;
+			bool seen = false;
+			for (const auto& sql : qr.indexes) seen = seen || sql == it->second.sql;
+			if (!seen) qr.indexes.push_back(it->second.sql);
+			if (recommended.insert(it->first).second) {
+				report.indexes.push_back(it->second.sql);
+			}
+		}
+	}
+
+	return SQLITE_OK;
+}
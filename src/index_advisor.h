@@ -0,0 +1,56 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Index Advisor Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef INDEX_ADVISOR_H
+#define INDEX_ADVISOR_H
+
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+
+/**
+ * IndexAdvisor - proposes missing indexes for a workload (sqlite3expert algorithm)
+ *
+ *   1. Every table of the schema is mirrored as an "expert" virtual table in a
+ *      scratch connection; preparing the workload there makes the planner
+ *      report each scan's equality/range constraints and ORDER BY through
+ *      xBestIndex.
+ *   2. Candidate indexes are derived from those scans and created, together
+ *      with the real schema, in a second scratch connection whose
+ *      sqlite_stat1 is seeded from the live data.
+ *   3. EXPLAIN QUERY PLAN is compared before/after; only candidates the
+ *      planner actually picks are recommended.
+ */
+class IndexAdvisor {
+public:
+	struct PlanRow {
+		int id;
+		int parent;
+		std::string detail;
+	};
+
+	struct QueryReport {
+		std::string sql;
+		std::string error;                 // set if the query could not be analysed
+		std::vector<std::string> indexes;  // recommended CREATE INDEX statements
+		std::vector<PlanRow> before;
+		std::vector<PlanRow> after;
+	};
+
+	struct Report {
+		std::vector<std::string> indexes;  // union over all queries, first-use order
+		std::vector<QueryReport> queries;
+	};
+
+	// Returns SQLITE_OK or an error code with `error` describing the failure
+	static int Advise(sqlite3* db, const std::vector<std::string>& workload, Report& report, std::string& error);
+
+	// Runs EXPLAIN QUERY PLAN for `sql` on `db`
+	static int QueryPlan(sqlite3* db, const std::string& sql, std::vector<PlanRow>& rows);
+};
+
+#endif // INDEX_ADVISOR_H
@@ -0,0 +1,82 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Query Deadline Timer Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "interrupt_timer.h"
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct TimerState {
+	std::mutex mutex;
+	std::condition_variable wake;
+	// Deadline -> (token, connection); tokens are unique so erase is exact
+	std::multimap<Clock::time_point, std::pair<uint64_t, sqlite3*>> deadlines;
+	std::map<uint64_t, decltype(deadlines)::iterator> armed;
+	uint64_t nextToken = 1;
+	bool started = false;
+};
+
+// Intentionally leaked: the thread is detached and may outlive static destructors
+TimerState& State() {
+	static TimerState* state = new TimerState();
+	return *state;
+}
+
+void TimerLoop(TimerState* state) {
+	std::unique_lock<std::mutex> lock(state->mutex);
+	for (;;) {
+		if (state->deadlines.empty()) {
+			state->wake.wait(lock);
+			continue;
+		}
+		auto earliest = state->deadlines.begin();
+		if (Clock::now() < earliest->first) {
+			state->wake.wait_until(lock, earliest->first);
+			continue;
+		}
+		// Interrupt while holding the lock, so Disarm() returning guarantees
+		// the connection is no longer referenced
+		sqlite3_interrupt(earliest->second.second);
+		state->armed.erase(earliest->second.first);
+		state->deadlines.erase(earliest);
+	}
+}
+
+} // namespace
+
+uint64_t InterruptTimer::Arm(sqlite3* db, int64_t timeoutMs) {
+	if (timeoutMs <= 0) return 0;
+	TimerState& state = State();
+	Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+	if (!state.started) {
+		std::thread(TimerLoop, &state).detach();
+		state.started = true;
+	}
+	uint64_t token = state.nextToken++;
+	auto it = state.deadlines.emplace(deadline, std::make_pair(token, db));
+	state.armed.emplace(token, it);
+	// Only an earlier deadline changes what the thread is sleeping for
+	if (it == state.deadlines.begin()) state.wake.notify_one();
+	return token;
+}
+
+void InterruptTimer::Disarm(uint64_t token) {
+	TimerState& state = State();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	auto it = state.armed.find(token);
+	if (it == state.armed.end()) return; // already fired
+	state.deadlines.erase(it->second);
+	state.armed.erase(it);
+}
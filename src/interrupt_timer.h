@@ -0,0 +1,47 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Query Deadline Timer Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef INTERRUPT_TIMER_H
+#define INTERRUPT_TIMER_H
+
+#include <sqlite3.h>
+#include <cstdint>
+
+/**
+ * InterruptTimer - process-wide thread that calls sqlite3_interrupt() on a
+ * connection once a query deadline passes
+ *
+ * The build omits the progress callback, so a running statement cannot poll
+ * a clock; instead every execution with a timeout arms an entry here and
+ * disarms it when sqlite3_step returns. The thread is started on first use
+ * and sleeps until the earliest armed deadline.
+ */
+class InterruptTimer {
+public:
+	// Returns a token for Disarm(); 0 (nothing armed) when timeoutMs <= 0
+	static uint64_t Arm(sqlite3* db, int64_t timeoutMs);
+	// Cancels the deadline. After it returns the timer will not touch db.
+	static void Disarm(uint64_t token);
+};
+
+/**
+ * ScopedDeadline - arms an InterruptTimer entry for the lifetime of one
+ * statement execution
+ */
+class ScopedDeadline {
+public:
+	ScopedDeadline(sqlite3* db, int64_t timeoutMs) : token_(InterruptTimer::Arm(db, timeoutMs)) {}
+	~ScopedDeadline() { if (token_) InterruptTimer::Disarm(token_); }
+
+	ScopedDeadline(const ScopedDeadline&) = delete;
+	ScopedDeadline& operator=(const ScopedDeadline&) = delete;
+
+private:
+	uint64_t token_;
+};
+
+#endif // INTERRUPT_TIMER_H
@@ -0,0 +1,184 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * IOC FTS5 Tokenizer Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "ioc_tokenizer.h"
+#include "text_functions.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+const char* const IocTokenizer::kDefaultName = "hexioc";
+
+namespace {
+
+// Suffix emission stops here: longer words are rarely searched by infix and
+// would add a token per byte
+const size_t kMaxSuffixWord = 64;
+// Hex runs this long are hashes or addresses, searched whole
+const size_t kLongHex = 16;
+
+typedef int (*TokenCallback)(void* ctx, int flags, const char* token, int length, int start, int end);
+
+struct Tokenizer {
+	size_t suffix;      // minimum suffix length, 0 = no suffixes
+	std::string folded; // reused across tokens
+};
+
+inline bool IsDigit(unsigned char c) {
+	return c >= '0' && c <= '9';
+}
+
+inline bool IsHexDigit(unsigned char c) {
+	return IsDigit(c) || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+}
+
+// Non-ASCII bytes are word characters: separators in IOCs are all ASCII
+inline bool IsWordByte(unsigned char c) {
+	return IsDigit(c) || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') || c == '_' || c >= 0x80;
+}
+
+bool IsHexRun(const char* text, size_t length) {
+	for (size_t i = 0; i < length; i++) {
+		if (!IsHexDigit(static_cast<unsigned char>(text[i]))) return false;
+	}
+	return length > 0;
+}
+
+// Length of a dotted-quad IPv4 address starting at text[i], or 0
+int MatchIpv4(const unsigned char* text, int i, int n) {
+	int j = i;
+	for (int part = 0; part < 4; part++) {
+		if (part) {
+			if (j >= n || text[j] != '.') return 0;
+			j++;
+		}
+		int digits = 0;
+		int value = 0;
+		while (j < n && IsDigit(text[j]) && digits < 4) {
+			value = value * 10 + (text[j] - '0');
+			digits++;
+			j++;
+		}
+		if (digits == 0 || digits > 3 || value > 255) return 0;
+	}
+	// "1.2.3.4.5" (a version) or "1.2.3.4x" is something else
+	if (j < n && (IsWordByte(text[j]) || (text[j] == '.' && j + 1 < n && IsDigit(text[j + 1])))) return 0;
+	return j - i;
+}
+
+void Fold(const char* word, size_t length, std::string& out) {
+	out.assign(word, length);
+	for (char& c : out) {
+		unsigned char u = static_cast<unsigned char>(c);
+		if (u >= 0x80) {
+			out = TextFunctions::CaseFold(word, length);
+			return;
+		}
+		if (u >= 'A' && u <= 'Z') c = static_cast<char>(u | 0x20);
+	}
+}
+
+int EmitWord(Tokenizer* tokenizer, void* ctx, bool document, const char* word, size_t length,
+	int start, int end, TokenCallback xToken) {
+	std::string& folded = tokenizer->folded;
+	Fold(word, length, folded);
+	int rc = xToken(ctx, 0, folded.data(), static_cast<int>(folded.size()), start, end);
+	// Query and highlight() tokenization only needs the words themselves
+	if (rc != SQLITE_OK || !document) return rc;
+
+	// 0x401000 is also found as 401000
+	if (folded.size() > 2 && folded[0] == '0' && folded[1] == 'x' && IsHexRun(folded.data() + 2, folded.size() - 2)) {
+		rc = xToken(ctx, FTS5_TOKEN_COLOCATED, folded.data() + 2, static_cast<int>(folded.size() - 2), start, end);
+		if (rc != SQLITE_OK) return rc;
+	}
+
+	size_t minimum = tokenizer->suffix;
+	if (minimum == 0 || folded.size() > kMaxSuffixWord ||
+		(folded.size() >= kLongHex && IsHexRun(folded.data(), folded.size()))) {
+		return SQLITE_OK;
+	}
+	for (size_t k = 1; folded.size() - k >= minimum; k++) {
+		// Suffixes start on character boundaries
+		if ((static_cast<unsigned char>(folded[k]) & 0xC0) == 0x80) continue;
+		rc = xToken(ctx, FTS5_TOKEN_COLOCATED, folded.data() + k, static_cast<int>(folded.size() - k), start, end);
+		if (rc != SQLITE_OK) return rc;
+	}
+	return SQLITE_OK;
+}
+
+int Create(void*, const char** args, int argc, Fts5Tokenizer** out) {
+	size_t suffix = 0;
+	for (int i = 0; i < argc; i += 2) {
+		if (strcmp(args[i], "suffix") != 0 || i + 1 >= argc) return SQLITE_ERROR;
+		char* end = nullptr;
+		long value = strtol(args[i + 1], &end, 10);
+		if (*end != '\0' || value < 1 || value > static_cast<long>(kMaxSuffixWord)) return SQLITE_ERROR;
+		suffix = static_cast<size_t>(value);
+	}
+	Tokenizer* tokenizer = new (std::nothrow) Tokenizer{ suffix, std::string() };
+	if (!tokenizer) return SQLITE_NOMEM;
+	*out = reinterpret_cast<Fts5Tokenizer*>(tokenizer);
+	return SQLITE_OK;
+}
+
+void Delete(Fts5Tokenizer* handle) {
+	delete reinterpret_cast<Tokenizer*>(handle);
+}
+
+int Tokenize(Fts5Tokenizer* handle, void* ctx, int flags, const char* text, int n, TokenCallback xToken) {
+	Tokenizer* tokenizer = reinterpret_cast<Tokenizer*>(handle);
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+	bool document = (flags & FTS5_TOKENIZE_DOCUMENT) != 0;
+	int i = 0;
+	try {
+		while (i < n) {
+			if (p[i] == '%' && i + 2 < n && IsHexDigit(p[i + 1]) && IsHexDigit(p[i + 2])) {
+				i += 3;
+				continue;
+			}
+			if (!IsWordByte(p[i])) {
+				i++;
+				continue;
+			}
+			int start = i;
+			int ipv4 = MatchIpv4(p, i, n);
+			if (ipv4) {
+				i += ipv4;
+			} else {
+				while (i < n && (IsWordByte(p[i]) || ((p[i] == '-') && i + 1 < n && IsWordByte(p[i + 1])))) i++;
+			}
+			int rc = EmitWord(tokenizer, ctx, document, text + start, static_cast<size_t>(i - start), start, i, xToken);
+			if (rc != SQLITE_OK) return rc;
+		}
+	} catch (const std::bad_alloc&) {
+		return SQLITE_NOMEM;
+	}
+	return SQLITE_OK;
+}
+
+} // namespace
+
+int IocTokenizer::Register(sqlite3* db, const std::string& name, std::string& error) {
+	// The FTS5 API pointer is only handed out through SQL
+	fts5_api* api = nullptr;
+	sqlite3_stmt* stmt = nullptr;
+	int rc = sqlite3_prepare_v2(db, "SELECT fts5(?1)", -1, &stmt, nullptr);
+	if (rc == SQLITE_OK) {
+		sqlite3_bind_pointer(stmt, 1, &api, "fts5_api_ptr", nullptr);
+		sqlite3_step(stmt);
+	}
+	sqlite3_finalize(stmt);
+	if (!api) {
+		error = "FTS5 is not available in this SQLite build";
+		return rc == SQLITE_OK ? SQLITE_ERROR : rc;
+	}
+
+	static fts5_tokenizer methods = { Create, Delete, Tokenize };
+	rc = api->xCreateTokenizer(api, name.c_str(), nullptr, &methods, nullptr);
+	if (rc != SQLITE_OK) error = sqlite3_errmsg(db);
+	return rc;
+}
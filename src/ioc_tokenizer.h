@@ -0,0 +1,43 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * IOC FTS5 Tokenizer Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef IOC_TOKENIZER_H
+#define IOC_TOKENIZER_H
+
+#include <sqlite3.h>
+#include <string>
+
+/**
+ * IocTokenizer - FTS5 tokenizer for indicator text (URLs, file paths,
+ * registry keys, domains, IPs, hashes)
+ *
+ * Splits on every URL / path / registry separator, so each host label, path
+ * segment and query parameter is one token, and a quoted IOC in a MATCH
+ * query ("c2.evil.net", "HKLM\Software\...\Run") becomes a phrase that
+ * matches it wherever it appears, including inside longer URLs or paths.
+ * Tokens are case folded.
+ *
+ *   - IPv4 addresses stay one token instead of four numbers
+ *   - %xx escapes are separators, not part of the neighbouring words
+ *   - "-" and "_" inside a word are kept ("evil-corp", "svc_host")
+ *   - 0x-prefixed hex is also indexed without the prefix
+ *
+ * Arguments (tokenize = 'hexioc suffix 3'): "suffix N" additionally indexes
+ * every suffix of at least N bytes of each word (words up to 64 bytes, long
+ * hex strings excluded), so a prefix query 'eaco*' finds "beacon". Combine
+ * with the table's prefix='3' option to keep those queries index lookups.
+ */
+class IocTokenizer {
+public:
+	static const char* const kDefaultName; // "hexioc"
+
+	// Registers the tokenizer with the connection's FTS5 module; fills error
+	// and returns an SQLite result code
+	static int Register(sqlite3* db, const std::string& name, std::string& error);
+};
+
+#endif // IOC_TOKENIZER_H
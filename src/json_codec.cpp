@@ -0,0 +1,601 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * JSON / JSONB Column Codec Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "json_codec.h"
+#include "json_writer.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// JSONB element types (low nibble of the header byte)
+enum JsonbType {
+	kNull = 0,
+	kTrue = 1,
+	kFalse = 2,
+	kInt = 3,
+	kInt5 = 4,      // JSON5 integer: hexadecimal or leading '+'
+	kFloat = 5,
+	kFloat5 = 6,    // JSON5 float: Infinity, NaN, ".5", "5."
+	kText = 7,      // no escapes
+	kTextJ = 8,     // JSON escapes
+	kText5 = 9,     // JSON5 escapes
+	kTextRaw = 10,  // raw UTF-8, escaped when rendered as JSON
+	kArray = 11,
+	kObject = 12
+};
+
+int HexDigit(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+bool ParseHex4(const char* p, uint32_t& value) {
+	value = 0;
+	for (int i = 0; i < 4; i++) {
+		int digit = HexDigit(p[i]);
+		if (digit < 0) return false;
+		value = (value << 4) | static_cast<uint32_t>(digit);
+	}
+	return true;
+}
+
+void AppendUtf8(std::string& out, uint32_t cp) {
+	if (cp < 0x80) {
+		out += static_cast<char>(cp);
+	} else if (cp < 0x800) {
+		out += static_cast<char>(0xC0 | (cp >> 6));
+		out += static_cast<char>(0x80 | (cp & 0x3F));
+	} else if (cp < 0x10000) {
+		out += static_cast<char>(0xE0 | (cp >> 12));
+		out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (cp & 0x3F));
+	} else {
+		out += static_cast<char>(0xF0 | (cp >> 18));
+		out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+}
+
+// Decodes the escapes of a string body; json5 also accepts \' \v \0 \xHH,
+// line continuations and any other escaped character as itself
+bool Unescape(const char* p, const char* end, bool json5, std::string& out) {
+	out.clear();
+	while (p < end) {
+		const char* slash = static_cast<const char*>(memchr(p, '\\', end - p));
+		if (!slash) {
+			out.append(p, end);
+			break;
+		}
+		out.append(p, slash);
+		p = slash + 1;
+		if (p >= end) return false;
+		char c = *p++;
+		switch (c) {
+			case '"': case '\\': case '/': out += c; break;
+			case 'b': out += '\b'; break;
+			case 'f': out += '\f'; break;
+			case 'n': out += '\n'; break;
+			case 'r': out += '\r'; break;
+			case 't': out += '\t'; break;
+			case 'u': {
+				uint32_t cp;
+				if (end - p < 4 || !ParseHex4(p, cp)) return false;
+				p += 4;
+				uint32_t low;
+				if (cp >= 0xD800 && cp <= 0xDBFF && end - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+					ParseHex4(p + 2, low) && low >= 0xDC00 && low <= 0xDFFF) {
+					cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+					p += 6;
+				}
+				AppendUtf8(out, cp);
+				break;
+			}
+			default:
+				if (!json5) return false;
+				if (c == 'v') {
+					out += '\v';
+				} else if (c == '0') {
+					out += '\0';
+				} else if (c == 'x') {
+					if (end - p < 2 || HexDigit(p[0]) < 0 || HexDigit(p[1]) < 0) return false;
+					AppendUtf8(out, static_cast<uint32_t>(HexDigit(p[0]) << 4 | HexDigit(p[1])));
+					p += 2;
+				} else if (c == '\r') {
+					if (p < end && *p == '\n') p++;
+				} else if (c == '\xE2' && end - p >= 2 && p[0] == '\x80' && (p[1] == '\xA8' || p[1] == '\xA9')) {
+					p += 2;  // U+2028 / U+2029 continuation
+				} else if (c != '\n') {
+					out += c;
+				}
+				break;
+		}
+	}
+	return true;
+}
+
+/**
+ * Builder - shared value construction for the text and JSONB readers
+ */
+class Builder {
+protected:
+	Builder(Napi::Env env, bool safeIntegers) : env_(env), safeIntegers_(safeIntegers) {}
+
+	// Decimal or (JSON5) hexadecimal integer, or any float form strtod takes;
+	// integers that overflow int64 become doubles
+	bool Number(const char* p, size_t n, Napi::Value& out) {
+		size_t i = 0;
+		bool negative = false;
+		if (i < n && (p[i] == '-' || p[i] == '+')) negative = p[i++] == '-';
+		bool hex = n - i > 2 && p[i] == '0' && (p[i + 1] == 'x' || p[i + 1] == 'X');
+		if (hex) i += 2;
+		if (i == n) return false;
+
+		uint64_t magnitude = 0;
+		double approx = 0;
+		bool overflow = false;
+		size_t j = i;
+		for (; j < n; j++) {
+			int digit = hex ? HexDigit(p[j]) : (p[j] >= '0' && p[j] <= '9' ? p[j] - '0' : -1);
+			if (digit < 0) break;
+			uint64_t base = hex ? 16 : 10;
+			if (magnitude > (UINT64_MAX - static_cast<uint64_t>(digit)) / base) overflow = true;
+			magnitude = magnitude * base + static_cast<uint64_t>(digit);
+			approx = approx * static_cast<double>(base) + digit;
+		}
+		if (j == n) {
+			uint64_t limit = negative ? UINT64_C(0x8000000000000000) : INT64_MAX;
+			if (!overflow && magnitude <= limit) {
+				if (magnitude == 0 && negative && !safeIntegers_) {
+					out = Napi::Number::New(env_, -0.0);
+					return true;
+				}
+				int64_t value = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+				out = safeIntegers_
+					? static_cast<Napi::Value>(Napi::BigInt::New(env_, value))
+					: static_cast<Napi::Value>(Napi::Number::New(env_, static_cast<double>(value)));
+				return true;
+			}
+			if (hex) {
+				out = Napi::Number::New(env_, negative ? -approx : approx);
+				return true;
+			}
+		} else if (hex) {
+			return false;
+		}
+
+		// Fractions, exponents, Infinity/NaN and out-of-range integers
+		char small[64];
+		std::string large;
+		char* text = small;
+		if (n < sizeof(small)) {
+			memcpy(small, p, n);
+			small[n] = '\0';
+		} else {
+			large.assign(p, n);
+			text = &large[0];
+		}
+		char* stop;
+		double value = strtod(text, &stop);
+		if (stop != text + n) return false;
+		out = Napi::Number::New(env_, value);
+		return true;
+	}
+
+	Napi::Env env_;
+	bool safeIntegers_;
+	std::string scratch_;
+};
+
+/**
+ * TextReader - recursive descent over strict JSON text
+ */
+class TextReader : public Builder {
+public:
+	TextReader(Napi::Env env, const char* p, size_t length, bool safeIntegers)
+		: Builder(env, safeIntegers), p_(p), end_(p + length) {}
+
+	bool Parse(Napi::Value& result) {
+		SkipSpace();
+		if (!Value(result, 0)) return false;
+		SkipSpace();
+		return p_ == end_;
+	}
+
+private:
+	void SkipSpace() {
+		while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) p_++;
+	}
+
+	bool Literal(const char* word, size_t length) {
+		if (static_cast<size_t>(end_ - p_) < length || memcmp(p_, word, length) != 0) return false;
+		p_ += length;
+		return true;
+	}
+
+	bool Value(Napi::Value& out, int depth) {
+		if (p_ >= end_) return false;
+		switch (*p_) {
+			case '{': return Object(out, depth);
+			case '[': return Array(out, depth);
+			case '"': return String(out);
+			case 't': out = Napi::Boolean::New(env_, true); return Literal("true", 4);
+			case 'f': out = Napi::Boolean::New(env_, false); return Literal("false", 5);
+			case 'n': out = env_.Null(); return Literal("null", 4);
+			default: return NumberToken(out);
+		}
+	}
+
+	bool String(Napi::Value& out) {
+		const char* start = ++p_;
+		bool escaped = false;
+		while (p_ < end_ && *p_ != '"') {
+			if (*p_ == '\\') {
+				if (end_ - p_ < 2) return false;
+				escaped = true;
+				p_ += 2;
+			} else if (static_cast<unsigned char>(*p_) < 0x20) {
+				return false;
+			} else {
+				p_++;
+			}
+		}
+		if (p_ >= end_) return false;
+		const char* stop = p_++;
+		if (!escaped) {
+			out = Napi::String::New(env_, start, static_cast<size_t>(stop - start));
+			return true;
+		}
+		if (!Unescape(start, stop, false, scratch_)) return false;
+		out = Napi::String::New(env_, scratch_);
+		return true;
+	}
+
+	// -? (0 | [1-9][0-9]*) (. [0-9]+)? ([eE] [+-]? [0-9]+)?
+	bool NumberToken(Napi::Value& out) {
+		const char* start = p_;
+		if (p_ < end_ && *p_ == '-') p_++;
+		if (p_ < end_ && *p_ == '0') {
+			p_++;
+		} else if (!Digits()) {
+			return false;
+		}
+		if (p_ < end_ && *p_ == '.') {
+			p_++;
+			if (!Digits()) return false;
+		}
+		if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+			p_++;
+			if (p_ < end_ && (*p_ == '+' || *p_ == '-')) p_++;
+			if (!Digits()) return false;
+		}
+		return Number(start, static_cast<size_t>(p_ - start), out);
+	}
+
+	bool Digits() {
+		const char* start = p_;
+		while (p_ < end_ && *p_ >= '0' && *p_ <= '9') p_++;
+		return p_ > start;
+	}
+
+	bool Array(Napi::Value& out, int depth) {
+		if (depth >= JsonCodec::kMaxDepth) return false;
+		p_++;
+		Napi::Array array = Napi::Array::New(env_);
+		SkipSpace();
+		if (p_ < end_ && *p_ == ']') {
+			p_++;
+			out = array;
+			return true;
+		}
+		for (uint32_t index = 0;; index++) {
+			Napi::Value element;
+			SkipSpace();
+			if (!Value(element, depth + 1)) return false;
+			array.Set(index, element);
+			SkipSpace();
+			if (p_ < end_ && *p_ == ',') {
+				p_++;
+			} else if (p_ < end_ && *p_ == ']') {
+				p_++;
+				out = array;
+				return true;
+			} else {
+				return false;
+			}
+		}
+	}
+
+	bool Object(Napi::Value& out, int depth) {
+		if (depth >= JsonCodec::kMaxDepth) return false;
+		p_++;
+		Napi::Object object = Napi::Object::New(env_);
+		SkipSpace();
+		if (p_ < end_ && *p_ == '}') {
+			p_++;
+			out = object;
+			return true;
+		}
+		for (;;) {
+			Napi::Value key;
+			Napi::Value value;
+			SkipSpace();
+			if (p_ >= end_ || *p_ != '"' || !String(key)) return false;
+			SkipSpace();
+			if (p_ >= end_ || *p_++ != ':') return false;
+			SkipSpace();
+			if (!Value(value, depth + 1)) return false;
+			object.Set(key, value);
+			SkipSpace();
+			if (p_ < end_ && *p_ == ',') {
+				p_++;
+			} else if (p_ < end_ && *p_ == '}') {
+				p_++;
+				out = object;
+				return true;
+			} else {
+				return false;
+			}
+		}
+	}
+
+	const char* p_;
+	const char* end_;
+};
+
+/**
+ * JsonbReader - walks SQLite's binary JSON: a header byte (type in the low
+ * nibble, payload size or size-of-size in the high nibble) per element
+ */
+class JsonbReader : public Builder {
+public:
+	JsonbReader(Napi::Env env, bool safeIntegers) : Builder(env, safeIntegers) {}
+
+	bool Element(const uint8_t*& p, const uint8_t* end, Napi::Value& out, int depth) {
+		int type;
+		size_t size;
+		if (!Header(p, end, type, size)) return false;
+		const char* body = reinterpret_cast<const char*>(p);
+		p += size;
+		switch (type) {
+			case kNull: out = env_.Null(); return true;
+			case kTrue: out = Napi::Boolean::New(env_, true); return true;
+			case kFalse: out = Napi::Boolean::New(env_, false); return true;
+			case kInt: case kInt5: case kFloat: case kFloat5:
+				return Number(body, size, out);
+			case kText: case kTextRaw:
+				out = Napi::String::New(env_, body, size);
+				return true;
+			case kTextJ: case kText5:
+				if (!Unescape(body, body + size, type == kText5, scratch_)) return false;
+				out = Napi::String::New(env_, scratch_);
+				return true;
+			case kArray: {
+				if (depth >= JsonCodec::kMaxDepth) return false;
+				Napi::Array array = Napi::Array::New(env_);
+				const uint8_t* q = reinterpret_cast<const uint8_t*>(body);
+				for (uint32_t index = 0; q < p; index++) {
+					Napi::Value element;
+					if (!Element(q, p, element, depth + 1)) return false;
+					array.Set(index, element);
+				}
+				out = array;
+				return true;
+			}
+			case kObject: {
+				if (depth >= JsonCodec::kMaxDepth) return false;
+				Napi::Object object = Napi::Object::New(env_);
+				const uint8_t* q = reinterpret_cast<const uint8_t*>(body);
+				while (q < p) {
+					Napi::Value key;
+					Napi::Value value;
+					if (*q % 16 < kText || *q % 16 > kTextRaw) return false;
+					if (!Element(q, p, key, depth + 1) || q >= p || !Element(q, p, value, depth + 1)) return false;
+					object.Set(key, value);
+				}
+				out = object;
+				return true;
+			}
+			default:
+				return false;
+		}
+	}
+
+private:
+	static bool Header(const uint8_t*& p, const uint8_t* end, int& type, size_t& size) {
+		if (p >= end) return false;
+		uint8_t header = *p++;
+		type = header & 0x0F;
+		size_t sizeCode = header >> 4;
+		if (sizeCode <= 11) {
+			size = sizeCode;
+		} else {
+			size_t bytes = sizeCode == 12 ? 1 : sizeCode == 13 ? 2 : sizeCode == 14 ? 4 : 8;
+			if (static_cast<size_t>(end - p) < bytes) return false;
+			uint64_t value = 0;
+			for (size_t i = 0; i < bytes; i++) value = (value << 8) | *p++;
+			if (value > static_cast<uint64_t>(end - p)) return false;
+			size = static_cast<size_t>(value);
+		}
+		return size <= static_cast<size_t>(end - p);
+	}
+};
+
+/**
+ * JsonbWriter - JSON.stringify() semantics, JSONB output
+ */
+class JsonbWriter {
+public:
+	enum class Status { Written, Skipped, Failed };
+
+	JsonbWriter(Napi::Env env, std::string& out) : env_(env), out_(out) {}
+
+	Status Encode(Napi::Value value, Napi::Value key, int depth, bool replaced = false) {
+		switch (value.Type()) {
+			case napi_null:
+				Leaf(kNull, nullptr, 0);
+				return Status::Written;
+			case napi_boolean:
+				Leaf(value.As<Napi::Boolean>().Value() ? kTrue : kFalse, nullptr, 0);
+				return Status::Written;
+			case napi_number: {
+				double d = value.As<Napi::Number>().DoubleValue();
+				number_.clear();
+				if (!std::isfinite(d)) {
+					Leaf(kNull, nullptr, 0);
+				} else if (d == static_cast<double>(static_cast<int64_t>(d)) && d >= -9007199254740991.0 && d <= 9007199254740991.0) {
+					JsonWriter::AppendInteger(number_, static_cast<int64_t>(d));
+					Leaf(kInt, number_.data(), number_.size());
+				} else {
+					// Integral doubles past 2^53 print as bare digits, which
+					// SQLite only accepts as INT elements (as jsonb() writes them)
+					JsonWriter::AppendReal(number_, d);
+					bool integral = number_.find_first_of(".eE") == std::string::npos;
+					Leaf(integral ? kInt : kFloat, number_.data(), number_.size());
+				}
+				return Status::Written;
+			}
+			case napi_string: {
+				std::string text = value.As<Napi::String>().Utf8Value();
+				Leaf(kTextRaw, text.data(), text.size());
+				return Status::Written;
+			}
+			case napi_bigint: {
+				bool lossless;
+				int64_t v = value.As<Napi::BigInt>().Int64Value(&lossless);
+				if (!lossless) {
+					Napi::RangeError::New(env_, "BigInt is too large to store as a JSON integer").ThrowAsJavaScriptException();
+					return Status::Failed;
+				}
+				number_.clear();
+				JsonWriter::AppendInteger(number_, v);
+				Leaf(kInt, number_.data(), number_.size());
+				return Status::Written;
+			}
+			case napi_object:
+				break;
+			default:
+				// undefined, functions and symbols
+				return Status::Skipped;
+		}
+
+		if (depth >= JsonCodec::kMaxDepth) {
+			Napi::TypeError::New(env_, "JSON value is nested too deeply (or circular)").ThrowAsJavaScriptException();
+			return Status::Failed;
+		}
+		Napi::Object object = value.As<Napi::Object>();
+		if (!replaced) {
+			Napi::Value toJSON = object.Get("toJSON");
+			if (toJSON.IsFunction()) {
+				return Encode(toJSON.As<Napi::Function>().Call(object, { key }), key, depth + 1, true);
+			}
+		}
+
+		size_t start = Open();
+		if (value.IsArray()) {
+			Napi::Array array = value.As<Napi::Array>();
+			uint32_t length = array.Length();
+			for (uint32_t i = 0; i < length; i++) {
+				Status status = Encode(array.Get(i), Napi::String::New(env_, std::to_string(i)), depth + 1);
+				if (status == Status::Failed) return status;
+				if (status == Status::Skipped) Leaf(kNull, nullptr, 0);
+			}
+			Close(start, kArray);
+			return Status::Written;
+		}
+
+		// Own enumerable string keys, in property order (Object.keys)
+		napi_value names;
+		napi_status status = napi_get_all_property_names(env_, object, napi_key_own_only,
+			static_cast<napi_key_filter>(napi_key_enumerable | napi_key_skip_symbols),
+			napi_key_numbers_to_strings, &names);
+		if (status != napi_ok) {
+			Napi::Error::New(env_).ThrowAsJavaScriptException();
+			return Status::Failed;
+		}
+		Napi::Array keys(env_, names);
+		uint32_t count = keys.Length();
+		for (uint32_t i = 0; i < count; i++) {
+			Napi::Value name = keys.Get(i);
+			std::string text = name.As<Napi::String>().Utf8Value();
+			size_t mark = out_.size();
+			Leaf(kTextRaw, text.data(), text.size());
+			Status member = Encode(object.Get(name), name, depth + 1);
+			if (member == Status::Failed) return member;
+			if (member == Status::Skipped) out_.resize(mark);
+		}
+		Close(start, kObject);
+		return Status::Written;
+	}
+
+private:
+	// Smallest header for a payload of n bytes
+	static size_t Header(char* header, int type, uint64_t n) {
+		if (n <= 11) {
+			header[0] = static_cast<char>(n << 4 | type);
+			return 1;
+		}
+		size_t bytes = n <= 0xFF ? 1 : n <= 0xFFFF ? 2 : n <= 0xFFFFFFFF ? 4 : 8;
+		int code = bytes == 1 ? 12 : bytes == 2 ? 13 : bytes == 4 ? 14 : 15;
+		header[0] = static_cast<char>(code << 4 | type);
+		for (size_t i = 0; i < bytes; i++) {
+			header[bytes - i] = static_cast<char>(n >> (8 * i));
+		}
+		return bytes + 1;
+	}
+
+	void Leaf(int type, const char* data, size_t n) {
+		char header[9];
+		out_.append(header, Header(header, type, n));
+		out_.append(data, n);
+	}
+
+	// Containers are written after a maximal header slot and moved down once
+	// their payload size is known
+	size_t Open() {
+		size_t start = out_.size();
+		out_.append(9, '\0');
+		return start;
+	}
+
+	void Close(size_t start, int type) {
+		size_t n = out_.size() - start - 9;
+		char header[9];
+		size_t length = Header(header, type, n);
+		memmove(&out_[start + length], &out_[start + 9], n);
+		memcpy(&out_[start], header, length);
+		out_.resize(start + length + n);
+	}
+
+	Napi::Env env_;
+	std::string& out_;
+	std::string number_;
+};
+
+} // namespace
+
+bool JsonCodec::FromText(Napi::Env env, const char* text, size_t length, bool safeIntegers, Napi::Value& result) {
+	return TextReader(env, text, length, safeIntegers).Parse(result);
+}
+
+bool JsonCodec::FromJsonb(Napi::Env env, const uint8_t* data, size_t length, bool safeIntegers, Napi::Value& result) {
+	const uint8_t* p = data;
+	const uint8_t* end = data + length;
+	return JsonbReader(env, safeIntegers).Element(p, end, result, 0) && p == end;
+}
+
+bool JsonCodec::ToJsonb(Napi::Env env, Napi::Value value, std::string& out) {
+	JsonbWriter::Status status = JsonbWriter(env, out).Encode(value, Napi::String::New(env, ""), 0);
+	if (status == JsonbWriter::Status::Skipped) {
+		Napi::TypeError::New(env, "This value cannot be stored as JSON").ThrowAsJavaScriptException();
+	}
+	return status == JsonbWriter::Status::Written;
+}
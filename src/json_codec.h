@@ -0,0 +1,44 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * JSON / JSONB Column Codec Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef JSON_CODEC_H
+#define JSON_CODEC_H
+
+#include <napi.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * JsonCodec - converts between JS values and the two forms SQLite stores
+ * JSON in, for statements in json mode
+ *
+ * Reading builds the JS value straight from the column bytes: JSON text
+ * (strict RFC 8259, what json() produces) or JSONB, SQLite's binary
+ * encoding, including the JSON5 number and string forms it may contain.
+ * Integers follow the statement's safeIntegers setting. A value that does
+ * not parse is reported back so the caller can return it unchanged.
+ *
+ * Writing encodes a JS object or array as JSONB with the semantics of
+ * JSON.stringify() (toJSON(), skipped undefined/function members, NaN and
+ * Infinity as null), except that BigInts become integers.
+ */
+class JsonCodec {
+public:
+	// Nesting limit for both directions (SQLite's JSON_MAX_DEPTH); also what
+	// stops a circular structure
+	static const int kMaxDepth = 1000;
+
+	// false (and nothing thrown) when the bytes are not valid JSON / JSONB
+	static bool FromText(Napi::Env env, const char* text, size_t length, bool safeIntegers, Napi::Value& result);
+	static bool FromJsonb(Napi::Env env, const uint8_t* data, size_t length, bool safeIntegers, Napi::Value& result);
+
+	// false with a JS exception pending when value cannot be encoded
+	static bool ToJsonb(Napi::Env env, Napi::Value value, std::string& out);
+};
+
+#endif // JSON_CODEC_H
@@ -0,0 +1,199 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * JSON Writer Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "json_writer.h"
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEX_JSON_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// First byte in [p, end) that JSON strings must escape: '"', '\\' or < 0x20
+const char* FindEscape(const char* p, const char* end) {
+#ifdef HEX_JSON_SSE2
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i control = _mm_set1_epi8(0x1F);
+	while (end - p >= 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		// Unsigned v <= 0x1F  <=>  min(v, 0x1F) == v
+		__m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+			_mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+		unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+		if (mask) {
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return p + index;
+#else
+			return p + __builtin_ctz(mask);
+#endif
+		}
+		p += 16;
+	}
+#endif
+	while (p < end) {
+		unsigned char c = static_cast<unsigned char>(*p);
+		if (c < 0x20 || c == '"' || c == '\\') break;
+		p++;
+	}
+	return p;
+}
+
+} // namespace
+
+void JsonWriter::AppendString(std::string& out, const char* p, size_t length) {
+	static const char kHex[] = "0123456789abcdef";
+	const char* end = p + length;
+	out += '"';
+	for (;;) {
+		const char* stop = FindEscape(p, end);
+		out.append(p, stop);
+		if (stop == end) break;
+		unsigned char c = static_cast<unsigned char>(*stop);
+		switch (c) {
+			case '"': out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n"; break;
+			case '\r': out += "\\r"; break;
+			case '\t': out += "\\t"; break;
+			case '\b': out += "\\b"; break;
+			case '\f': out += "\\f"; break;
+			default: {
+				char escape[6] = { '\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 15] };
+				out.append(escape, 6);
+			}
+		}
+		p = stop + 1;
+	}
+	out += '"';
+}
+
+void JsonWriter::AppendInteger(std::string& out, int64_t value) {
+	char digits[24];
+	int n = snprintf(digits, sizeof(digits), "%lld", static_cast<long long>(value));
+	out.append(digits, static_cast<size_t>(n));
+}
+
+// Number::toString(): the shortest digits that read back as the same double,
+// laid out as plain decimals for exponents in [-7, 21) and as d.ddde+X beyond
+void JsonWriter::AppendReal(std::string& out, double value) {
+	if (value == 0) {
+		// JSON.stringify(-0) is "0"
+		out += '0';
+		return;
+	}
+	if (value < 0) {
+		out += '-';
+		value = -value;
+	}
+
+	// Any shorter form of a normal double is a prefix of its 15-digit
+	// rounding; subnormals have fewer significant digits and start lower
+	char buffer[40];
+	for (int precision = value < DBL_MIN ? 1 : 15; precision <= 17; precision++) {
+		snprintf(buffer, sizeof(buffer), "%.*e", precision - 1, value);
+		if (strtod(buffer, nullptr) == value) break;
+	}
+
+	// "d.ddde-XX" -> significant digits without trailing zeros, and the
+	// decimal point position n (value = 0.digits * 10^n)
+	char* e = strchr(buffer, 'e');
+	int n = atoi(e + 1) + 1;
+	std::string digits(1, buffer[0]);
+	if (buffer[1] == '.') digits.append(buffer + 2, e);
+	while (digits.size() > 1 && digits.back() == '0') digits.pop_back();
+	int k = static_cast<int>(digits.size());
+
+	if (k <= n && n <= 21) {
+		out += digits;
+		out.append(static_cast<size_t>(n - k), '0');
+	} else if (0 < n && n <= 21) {
+		out.append(digits, 0, static_cast<size_t>(n));
+		out += '.';
+		out.append(digits, static_cast<size_t>(n), std::string::npos);
+	} else if (-6 < n && n <= 0) {
+		out += "0.";
+		out.append(static_cast<size_t>(-n), '0');
+		out += digits;
+	} else {
+		out += digits[0];
+		if (k > 1) {
+			out += '.';
+			out.append(digits, 1, std::string::npos);
+		}
+		out += n - 1 > 0 ? "e+" : "e-";
+		AppendInteger(out, n - 1 > 0 ? n - 1 : 1 - n);
+	}
+}
+
+void JsonWriter::AppendBase64(std::string& out, const unsigned char* p, size_t length) {
+	static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	size_t start = out.size();
+	out.resize(start + (length + 2) / 3 * 4);
+	char* o = &out[start];
+	size_t i = 0;
+	for (; i + 3 <= length; i += 3) {
+		uint32_t v = (uint32_t(p[i]) << 16) | (uint32_t(p[i + 1]) << 8) | p[i + 2];
+		*o++ = kAlphabet[v >> 18];
+		*o++ = kAlphabet[(v >> 12) & 63];
+		*o++ = kAlphabet[(v >> 6) & 63];
+		*o++ = kAlphabet[v & 63];
+	}
+	if (i < length) {
+		uint32_t v = uint32_t(p[i]) << 16;
+		if (i + 1 < length) v |= uint32_t(p[i + 1]) << 8;
+		*o++ = kAlphabet[v >> 18];
+		*o++ = kAlphabet[(v >> 12) & 63];
+		*o++ = i + 1 < length ? kAlphabet[(v >> 6) & 63] : '=';
+		*o++ = '=';
+	}
+}
+
+void JsonWriter::AppendColumn(std::string& out, sqlite3_stmt* stmt, int c) {
+	switch (sqlite3_column_type(stmt, c)) {
+		case SQLITE_INTEGER:
+			AppendInteger(out, sqlite3_column_int64(stmt, c));
+			break;
+		case SQLITE_FLOAT: {
+			double value = sqlite3_column_double(stmt, c);
+			if (std::isfinite(value)) {
+				AppendReal(out, value);
+			} else {
+				out += "null";
+			}
+			break;
+		}
+		case SQLITE_TEXT: {
+			const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, c));
+			AppendString(out, text, static_cast<size_t>(sqlite3_column_bytes(stmt, c)));
+			break;
+		}
+		case SQLITE_BLOB: {
+			const unsigned char* data = static_cast<const unsigned char*>(sqlite3_column_blob(stmt, c));
+			size_t length = static_cast<size_t>(sqlite3_column_bytes(stmt, c));
+			out += '"';
+			AppendBase64(out, data, length);
+			out += '"';
+			break;
+		}
+		default:
+			out += "null";
+			break;
+	}
+}
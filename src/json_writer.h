@@ -0,0 +1,38 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * JSON Writer Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * JsonWriter - appends SQLite values to a UTF-8 JSON buffer
+ *
+ * Shared by stmt.allJSON()/getJSON() and the streaming exporter. Strings are
+ * scanned 16 bytes at a time (SSE2) for characters that need escaping and
+ * copied in runs. Numbers are written the way JSON.stringify() writes them
+ * (shortest round-trip form; NaN and Infinity become null), integers with
+ * all their digits, and BLOBs as base64 strings.
+ */
+class JsonWriter {
+public:
+	// Quoted and escaped; the bytes are assumed to be UTF-8
+	static void AppendString(std::string& out, const char* text, size_t length);
+	static void AppendInteger(std::string& out, int64_t value);
+	// Finite values only; callers decide how to write NaN and Infinity
+	static void AppendReal(std::string& out, double value);
+	// Unquoted, standard alphabet with padding (Buffer's "base64")
+	static void AppendBase64(std::string& out, const unsigned char* data, size_t length);
+	// Column value of the current row as a JSON value
+	static void AppendColumn(std::string& out, sqlite3_stmt* stmt, int column);
+};
+
+#endif // JSON_WRITER_H
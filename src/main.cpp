@@ -8,6 +8,8 @@
 #include <napi.h>
 #include <sqlite3.h>
 #include "sqlite3_wrapper.h"
+#include "pool_allocator.h"
+#include "shared_pcache.h"
 
 static Napi::FunctionReference errorConstructor;
 static bool isInitialized = false;
@@ -25,11 +27,87 @@ static Napi::Value SetErrorConstructor(const Napi::CallbackInfo& info) {
 	return env.Undefined();
 }
 
+/**
+ * allocatorStats - per-size-class statistics of the SQLite pool allocator
+ */
+static Napi::Value AllocatorStats(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	PoolAllocator::Stats stats;
+	PoolAllocator::GetStats(stats);
+
+	Napi::Object result = Napi::Object::New(env);
+	result.Set("allocator", Napi::String::New(env, stats.installed ? "pool" : "system"));
+	result.Set("arenaBytes", Napi::Number::New(env, static_cast<double>(stats.arenaBytes)));
+
+	Napi::Object large = Napi::Object::New(env);
+	large.Set("inUse", Napi::Number::New(env, static_cast<double>(stats.largeInUse)));
+	large.Set("bytes", Napi::Number::New(env, static_cast<double>(stats.largeBytes)));
+	large.Set("total", Napi::Number::New(env, static_cast<double>(stats.largeTotal)));
+	result.Set("large", large);
+
+	Napi::Array classes = Napi::Array::New(env, stats.classes.size());
+	for (size_t i = 0; i < stats.classes.size(); i++) {
+		const PoolAllocator::ClassStats& cs = stats.classes[i];
+		Napi::Object entry = Napi::Object::New(env);
+		entry.Set("size", Napi::Number::New(env, cs.size));
+		entry.Set("inUse", Napi::Number::New(env, static_cast<double>(cs.inUse)));
+		entry.Set("cached", Napi::Number::New(env, static_cast<double>(cs.cached)));
+		entry.Set("total", Napi::Number::New(env, static_cast<double>(cs.total)));
+		classes.Set(static_cast<uint32_t>(i), entry);
+	}
+	result.Set("classes", classes);
+	return result;
+}
+
+/**
+ * pageCacheStats - process-wide counters of the shared page cache
+ */
+static Napi::Value PageCacheStats(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	SharedPageCache::Stats stats;
+	SharedPageCache::GetStats(stats);
+
+	Napi::Object result = Napi::Object::New(env);
+	result.Set("pageCache", Napi::String::New(env, stats.installed ? "shared" : "default"));
+	result.Set("budget", Napi::Number::New(env, static_cast<double>(stats.budget)));
+	result.Set("bytes", Napi::Number::New(env, static_cast<double>(stats.bytes)));
+	result.Set("pages", Napi::Number::New(env, static_cast<double>(stats.pages)));
+	result.Set("pinned", Napi::Number::New(env, static_cast<double>(stats.pinned)));
+	result.Set("caches", Napi::Number::New(env, static_cast<double>(stats.caches)));
+	result.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+	result.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+	result.Set("evictions", Napi::Number::New(env, static_cast<double>(stats.evictions)));
+	return result;
+}
+
+/**
+ * setPageCacheBudget - cap the bytes cached across all connections (0 = unlimited)
+ */
+static Napi::Value SetPageCacheBudget(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (info.Length() < 1 || !info[0].IsNumber()) {
+		Napi::TypeError::New(env, "Expected budget in bytes as first argument").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	double bytes = info[0].As<Napi::Number>().DoubleValue();
+	SharedPageCache::SetBudget(bytes > 0 ? static_cast<uint64_t>(bytes) : 0);
+	return Napi::Boolean::New(env, SharedPageCache::IsInstalled());
+}
+
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+	// Must run before the first SQLite call in the process
+	PoolAllocator::Install();
+	SharedPageCache::Install();
+
 	DatabaseWrapper::Init(env, exports);
 	StatementWrapper::Init(env, exports);
+	BlobWrapper::Init(env, exports);
+	SessionWrapper::Init(env, exports);
 
 	exports.Set("setErrorConstructor", Napi::Function::New(env, SetErrorConstructor));
+	exports.Set("allocatorStats", Napi::Function::New(env, AllocatorStats));
+	exports.Set("pageCacheStats", Napi::Function::New(env, PageCacheStats));
+	exports.Set("setPageCacheBudget", Napi::Function::New(env, SetPageCacheBudget));
 
 	// Export isInitialized as a property (mutable from JS side)
 	exports.Set("isInitialized", Napi::Boolean::New(env, false));
@@ -0,0 +1,106 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Preallocated Memory Region Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "memory_region.h"
+#include "shared_pcache.h"
+#include <sqlite3.h>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+static const size_t kHugePageSize = 2 * 1024 * 1024;
+
+static size_t RoundUp(size_t n, size_t to) {
+	return (n + to - 1) / to * to;
+}
+
+MemoryRegion* MemoryRegion::Allocate(size_t bytes, bool hugePages) {
+	if (bytes == 0) return nullptr;
+
+#ifdef _WIN32
+	(void)hugePages;
+	void* data = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (!data) return nullptr;
+	return new MemoryRegion(data, bytes, bytes, false);
+#else
+	if (hugePages) {
+		size_t mapped = RoundUp(bytes, kHugePageSize);
+#ifdef MAP_HUGETLB
+		// Explicit huge pages: only succeeds if the admin reserved some (vm.nr_hugepages)
+		void* data = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (data != MAP_FAILED) {
+			return new MemoryRegion(data, bytes, mapped, true);
+		}
+#endif
+		void* thp = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (thp == MAP_FAILED) return nullptr;
+		bool advised = false;
+#ifdef MADV_HUGEPAGE
+		advised = madvise(thp, mapped, MADV_HUGEPAGE) == 0;
+#endif
+		return new MemoryRegion(thp, bytes, mapped, advised);
+	}
+
+	void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (data == MAP_FAILED) return nullptr;
+	return new MemoryRegion(data, bytes, bytes, false);
+#endif
+}
+
+MemoryRegion::~MemoryRegion() {
+#ifdef _WIN32
+	VirtualFree(data_, 0, MEM_RELEASE);
+#else
+	munmap(data_, mapped_);
+#endif
+}
+
+// The page-cache region lives for the rest of the process: SQLite keeps
+// using it until sqlite3_shutdown(), which the addon never calls
+static std::mutex pageCacheMutex;
+static MemoryRegion* pageCacheRegion = nullptr;
+
+bool MemoryRegion::ConfigurePageCache(int pageSize, int pages, bool hugePages, std::string& error) {
+	std::lock_guard<std::mutex> lock(pageCacheMutex);
+	if (pageCacheRegion) return true;
+
+	int headerSize = 0;
+	if (sqlite3_config(SQLITE_CONFIG_PCACHE_HDRSZ, &headerSize) != SQLITE_OK) {
+		headerSize = 256;
+	}
+	size_t slotSize = RoundUp(static_cast<size_t>(pageSize) + headerSize, 8);
+
+	// The shared page cache can adopt the region at any time
+	if (SharedPageCache::IsInstalled()) {
+		slotSize = RoundUp(slotSize + SharedPageCache::PageOverhead(), 8);
+	}
+
+	MemoryRegion* region = Allocate(slotSize * pages, hugePages);
+	if (!region) {
+		error = "Failed to allocate the page cache region";
+		return false;
+	}
+	if (SharedPageCache::IsInstalled()) {
+		SharedPageCache::UseRegion(region->Data(), slotSize, pages);
+		pageCacheRegion = region;
+		return true;
+	}
+	if (sqlite3_config(SQLITE_CONFIG_PAGECACHE, region->Data(), static_cast<int>(slotSize), pages) != SQLITE_OK) {
+		delete region;
+		error = "The \"pageCache\" option must be passed to the first database opened in the process";
+		return false;
+	}
+	pageCacheRegion = region;
+	return true;
+}
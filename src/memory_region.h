@@ -0,0 +1,47 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Preallocated Memory Region Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef MEMORY_REGION_H
+#define MEMORY_REGION_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * MemoryRegion - page-aligned, zeroed block handed to SQLite as lookaside or
+ * page-cache memory
+ *
+ * With hugePages the region is first requested from the hugetlbfs pool
+ * (MAP_HUGETLB); if none are reserved it falls back to a regular mapping
+ * advised for transparent huge pages. Platforms without either get a plain
+ * anonymous mapping.
+ */
+class MemoryRegion {
+public:
+	static MemoryRegion* Allocate(size_t bytes, bool hugePages);
+	~MemoryRegion();
+
+	void* Data() const { return data_; }
+	size_t Size() const { return size_; }
+	bool HugePages() const { return hugePages_; }
+
+	// Installs a process-wide page-cache region, once. The shared page cache
+	// adopts it at any time; SQLite's pcache1 only accepts it before
+	// initialization (SQLITE_CONFIG_PAGECACHE), i.e. before the first open.
+	static bool ConfigurePageCache(int pageSize, int pages, bool hugePages, std::string& error);
+
+private:
+	MemoryRegion(void* data, size_t size, size_t mapped, bool hugePages)
+		: data_(data), size_(size), mapped_(mapped), hugePages_(hugePages) {}
+
+	void* data_;
+	size_t size_;
+	size_t mapped_;
+	bool hugePages_;
+};
+
+#endif // MEMORY_REGION_H
@@ -0,0 +1,422 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Size-Class Pool Allocator Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "pool_allocator.h"
+#include <sqlite3.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace {
+
+constexpr uint32_t kClassSizes[] = {
+	16, 32, 48, 64, 80, 96, 112, 128,
+	160, 192, 224, 256, 320, 384, 448, 512,
+	640, 768, 896, 1024, 1280, 1536, 1792, 2048,
+};
+constexpr int kNumClasses = sizeof(kClassSizes) / sizeof(kClassSizes[0]);
+constexpr uint32_t kMaxSmall = 2048;
+constexpr uint32_t kLargeClass = 0xffffffffu;
+constexpr size_t kChunkSize = 256 * 1024;
+// A thread keeps at most this many free bytes per class; the surplus goes
+// back to the central lists in batches of a quarter of it
+constexpr size_t kLocalBytes = 64 * 1024;
+
+struct Chunk;
+
+// Precedes every block; 16 bytes keeps user pointers 16-byte aligned. Large
+// blocks record their size, size-class blocks the chunk they came from
+struct BlockHeader {
+	uint32_t cls;
+	uint32_t reserved;
+	union {
+		uint64_t size;
+		Chunk* chunk;
+	};
+};
+static_assert(sizeof(BlockHeader) == 16, "BlockHeader must stay 16 bytes");
+
+struct FreeBlock {
+	FreeBlock* next;
+};
+
+// One arena chunk serving a single size class. Blocks past `carved` have
+// never been handed out; freeCount counts them plus the central free list
+struct Chunk {
+	int cls;
+	uint32_t capacity;
+	uint32_t carved;
+	uint32_t freeCount;
+	FreeBlock* free;
+	Chunk* prev;        // partial list: chunks with free blocks
+	Chunk* next;
+	void* reserved;
+};
+constexpr size_t kChunkHeader = (sizeof(Chunk) + 15) & ~static_cast<size_t>(15);
+
+// Written only by the owning thread, read by GetStats(): no RMW needed
+struct Counter {
+	std::atomic<uint64_t> value{ 0 };
+	void Add(uint64_t n) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+	void Sub(uint64_t n) { value.store(value.load(std::memory_order_relaxed) - n, std::memory_order_relaxed); }
+	uint64_t Get() const { return value.load(std::memory_order_relaxed); }
+};
+
+struct ThreadPool {
+	FreeBlock* free[kNumClasses] = {};
+	Counter allocs[kNumClasses];
+	Counter frees[kNumClasses];
+	Counter cached[kNumClasses];
+	ThreadPool* prev = nullptr;
+	ThreadPool* next = nullptr;
+};
+
+// All shared state is plain data, so nothing below has a destructor that
+// could run before a late thread exit or sqlite3_free() during teardown
+uint8_t g_classForUnits[kMaxSmall / 16 + 1];
+uint32_t g_batch[kNumClasses];
+uint32_t g_localMax[kNumClasses];
+bool g_installed = false;
+
+std::mutex g_mutex;                       // guards everything below
+ThreadPool* g_pools = nullptr;
+Chunk* g_partial[kNumClasses] = {};
+uint64_t g_centralFree[kNumClasses] = {};
+uint64_t g_retiredAllocs[kNumClasses] = {};
+uint64_t g_retiredFrees[kNumClasses] = {};
+
+std::atomic<uint64_t> g_arenaBytes{ 0 };
+std::atomic<uint64_t> g_largeInUse{ 0 };
+std::atomic<uint64_t> g_largeBytes{ 0 };
+std::atomic<uint64_t> g_largeTotal{ 0 };
+
+// Set once static destruction begins; declared after the state above so it
+// is destroyed first
+std::atomic<bool> g_exiting{ false };
+struct ExitFlag {
+	~ExitFlag() { g_exiting.store(true, std::memory_order_relaxed); }
+} g_exitFlag;
+
+thread_local ThreadPool* t_pool = nullptr;
+thread_local bool t_retired = false;
+
+// ---------------------------------------------------------------------------
+// Central lists (g_mutex held)
+// ---------------------------------------------------------------------------
+
+void LinkPartial(Chunk* chunk) {
+	Chunk*& head = g_partial[chunk->cls];
+	chunk->prev = nullptr;
+	chunk->next = head;
+	if (head) head->prev = chunk;
+	head = chunk;
+}
+
+void UnlinkPartial(Chunk* chunk) {
+	if (chunk->prev) chunk->prev->next = chunk->next;
+	else g_partial[chunk->cls] = chunk->next;
+	if (chunk->next) chunk->next->prev = chunk->prev;
+	chunk->prev = chunk->next = nullptr;
+}
+
+Chunk* NewChunk(int c) {
+	Chunk* chunk = static_cast<Chunk*>(malloc(kChunkSize));
+	if (!chunk) return nullptr;
+	g_arenaBytes.fetch_add(kChunkSize, std::memory_order_relaxed);
+	chunk->cls = c;
+	chunk->capacity = static_cast<uint32_t>((kChunkSize - kChunkHeader) / (sizeof(BlockHeader) + kClassSizes[c]));
+	chunk->carved = 0;
+	chunk->freeCount = chunk->capacity;
+	chunk->free = nullptr;
+	chunk->reserved = nullptr;
+	g_centralFree[c] += chunk->capacity;
+	LinkPartial(chunk);
+	return chunk;
+}
+
+// Pops one block of class c, allocating a chunk when none has room
+BlockHeader* TakeBlock(int c) {
+	Chunk* chunk = g_partial[c];
+	if (!chunk && !(chunk = NewChunk(c))) return nullptr;
+
+	BlockHeader* header;
+	if (FreeBlock* block = chunk->free) {
+		chunk->free = block->next;
+		header = reinterpret_cast<BlockHeader*>(block) - 1;
+	} else {
+		size_t blockSize = sizeof(BlockHeader) + kClassSizes[c];
+		header = reinterpret_cast<BlockHeader*>(reinterpret_cast<char*>(chunk) + kChunkHeader + blockSize * chunk->carved++);
+	}
+	header->cls = static_cast<uint32_t>(c);
+	header->chunk = chunk;
+	g_centralFree[c]--;
+	if (--chunk->freeCount == 0) UnlinkPartial(chunk);
+	return header;
+}
+
+// Returns a block to its chunk; a chunk whose blocks are all back is
+// released to the system unless it is the last one with room in its class
+void ReturnBlock(FreeBlock* block) {
+	BlockHeader* header = reinterpret_cast<BlockHeader*>(block) - 1;
+	Chunk* chunk = header->chunk;
+	int c = chunk->cls;
+	block->next = chunk->free;
+	chunk->free = block;
+	g_centralFree[c]++;
+	if (chunk->freeCount++ == 0) LinkPartial(chunk);
+	if (chunk->freeCount == chunk->capacity && (chunk->prev || chunk->next)) {
+		UnlinkPartial(chunk);
+		g_centralFree[c] -= chunk->capacity;
+		g_arenaBytes.fetch_sub(kChunkSize, std::memory_order_relaxed);
+		free(chunk);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Per-thread free lists
+// ---------------------------------------------------------------------------
+
+// Hands the thread's free lists back to the central lists when it exits
+struct PoolGuard {
+	~PoolGuard() {
+		ThreadPool* pool = t_pool;
+		if (!pool) return;
+		t_pool = nullptr;
+		t_retired = true;
+		// During process exit the blocks are simply left to the OS
+		if (g_exiting.load(std::memory_order_relaxed)) return;
+
+		std::lock_guard<std::mutex> lock(g_mutex);
+		for (int c = 0; c < kNumClasses; c++) {
+			while (FreeBlock* block = pool->free[c]) {
+				pool->free[c] = block->next;
+				ReturnBlock(block);
+			}
+			g_retiredAllocs[c] += pool->allocs[c].Get();
+			g_retiredFrees[c] += pool->frees[c].Get();
+		}
+		if (pool->prev) pool->prev->next = pool->next;
+		else g_pools = pool->next;
+		if (pool->next) pool->next->prev = pool->prev;
+		delete pool;
+	}
+};
+thread_local PoolGuard t_guard;
+
+ThreadPool* LocalPool() {
+	ThreadPool* pool = t_pool;
+	if (pool || t_retired) return pool;
+
+	pool = new (std::nothrow) ThreadPool();
+	if (!pool) return nullptr;
+	{
+		std::lock_guard<std::mutex> lock(g_mutex);
+		pool->next = g_pools;
+		if (g_pools) g_pools->prev = pool;
+		g_pools = pool;
+	}
+	(void)&t_guard;  // odr-use so the guard's destructor is registered
+	t_pool = pool;
+	return pool;
+}
+
+// Moves a batch of class c blocks from the central lists into the pool
+void Refill(ThreadPool* pool, int c) {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	for (uint32_t i = 0; i < g_batch[c]; i++) {
+		BlockHeader* header = TakeBlock(c);
+		if (!header) break;
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(header + 1);
+		block->next = pool->free[c];
+		pool->free[c] = block;
+		pool->cached[c].Add(1);
+	}
+}
+
+// Gives a batch of class c blocks back once the pool holds too many
+void Trim(ThreadPool* pool, int c) {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	for (uint32_t i = 0; i < g_batch[c] && pool->free[c]; i++) {
+		FreeBlock* block = pool->free[c];
+		pool->free[c] = block->next;
+		pool->cached[c].Sub(1);
+		ReturnBlock(block);
+	}
+}
+
+void* PoolMalloc(int n) {
+	if (n <= 0) n = 1;
+
+	if (static_cast<uint32_t>(n) > kMaxSmall) {
+		BlockHeader* header = static_cast<BlockHeader*>(malloc(sizeof(BlockHeader) + static_cast<size_t>(n)));
+		if (!header) return nullptr;
+		header->cls = kLargeClass;
+		header->size = static_cast<uint64_t>(n);
+		g_largeInUse.fetch_add(1, std::memory_order_relaxed);
+		g_largeBytes.fetch_add(header->size, std::memory_order_relaxed);
+		g_largeTotal.fetch_add(1, std::memory_order_relaxed);
+		return header + 1;
+	}
+
+	int c = g_classForUnits[(n + 15) >> 4];
+	ThreadPool* pool = LocalPool();
+	if (!pool) {
+		// Thread teardown: straight from the central lists
+		std::lock_guard<std::mutex> lock(g_mutex);
+		BlockHeader* header = TakeBlock(c);
+		if (!header) return nullptr;
+		g_retiredAllocs[c]++;
+		return header + 1;
+	}
+
+	if (!pool->free[c]) {
+		Refill(pool, c);
+		if (!pool->free[c]) return nullptr;
+	}
+	FreeBlock* block = pool->free[c];
+	pool->free[c] = block->next;
+	pool->cached[c].Sub(1);
+	pool->allocs[c].Add(1);
+	return block;
+}
+
+void PoolFree(void* p) {
+	if (!p) return;
+	BlockHeader* header = static_cast<BlockHeader*>(p) - 1;
+	if (header->cls == kLargeClass) {
+		g_largeInUse.fetch_sub(1, std::memory_order_relaxed);
+		g_largeBytes.fetch_sub(header->size, std::memory_order_relaxed);
+		free(header);
+		return;
+	}
+
+	// Blocks freed on another thread join that thread's list
+	int c = static_cast<int>(header->cls);
+	FreeBlock* block = static_cast<FreeBlock*>(p);
+	ThreadPool* pool = LocalPool();
+	if (!pool) {
+		if (g_exiting.load(std::memory_order_relaxed)) return;
+		std::lock_guard<std::mutex> lock(g_mutex);
+		ReturnBlock(block);
+		g_retiredFrees[c]++;
+		return;
+	}
+	block->next = pool->free[c];
+	pool->free[c] = block;
+	pool->cached[c].Add(1);
+	pool->frees[c].Add(1);
+	if (pool->cached[c].Get() > g_localMax[c]) Trim(pool, c);
+}
+
+int PoolSize(void* p) {
+	if (!p) return 0;
+	BlockHeader* header = static_cast<BlockHeader*>(p) - 1;
+	return static_cast<int>(header->cls == kLargeClass ? header->size : kClassSizes[header->cls]);
+}
+
+void* PoolRealloc(void* p, int n) {
+	if (!p) return PoolMalloc(n);
+	BlockHeader* header = static_cast<BlockHeader*>(p) - 1;
+
+	if (header->cls == kLargeClass && static_cast<uint32_t>(n) > kMaxSmall) {
+		uint64_t oldSize = header->size;
+		BlockHeader* grown = static_cast<BlockHeader*>(realloc(header, sizeof(BlockHeader) + static_cast<size_t>(n)));
+		if (!grown) return nullptr;
+		grown->size = static_cast<uint64_t>(n);
+		g_largeBytes.fetch_add(grown->size - oldSize, std::memory_order_relaxed);
+		return grown + 1;
+	}
+	uint64_t size = static_cast<uint64_t>(PoolSize(p));
+	if (header->cls != kLargeClass && static_cast<uint64_t>(n) <= size) {
+		return p;
+	}
+
+	void* fresh = PoolMalloc(n);
+	if (!fresh) return nullptr;
+	size_t keep = static_cast<size_t>(size < static_cast<uint64_t>(n) ? size : static_cast<uint64_t>(n));
+	memcpy(fresh, p, keep);
+	PoolFree(p);
+	return fresh;
+}
+
+int PoolRoundup(int n) {
+	if (n <= 0) return static_cast<int>(kClassSizes[0]);
+	if (static_cast<uint32_t>(n) <= kMaxSmall) return static_cast<int>(kClassSizes[g_classForUnits[(n + 15) >> 4]]);
+	return (n + 7) & ~7;
+}
+
+int PoolInit(void*) { return SQLITE_OK; }
+void PoolShutdown(void*) {}
+
+const sqlite3_mem_methods kPoolMethods = {
+	PoolMalloc,
+	PoolFree,
+	PoolRealloc,
+	PoolSize,
+	PoolRoundup,
+	PoolInit,
+	PoolShutdown,
+	nullptr,
+};
+
+} // namespace
+
+// ============================================================================
+// PoolAllocator
+// ============================================================================
+
+bool PoolAllocator::Install() {
+	static std::once_flag once;
+	std::call_once(once, [] {
+		const char* mode = getenv("HEXCORE_SQLITE_MALLOC");
+		if (mode && strcmp(mode, "system") == 0) return;
+
+		int c = 0;
+		for (uint32_t units = 0; units <= kMaxSmall / 16; units++) {
+			while (kClassSizes[c] < units * 16) c++;
+			g_classForUnits[units] = static_cast<uint8_t>(c);
+		}
+		for (c = 0; c < kNumClasses; c++) {
+			g_localMax[c] = static_cast<uint32_t>(kLocalBytes / kClassSizes[c]);
+			g_batch[c] = g_localMax[c] / 4;
+		}
+		// Fails with SQLITE_MISUSE if SQLite was already initialized
+		g_installed = sqlite3_config(SQLITE_CONFIG_MALLOC, &kPoolMethods) == SQLITE_OK;
+	});
+	return g_installed;
+}
+
+bool PoolAllocator::IsInstalled() {
+	return g_installed;
+}
+
+void PoolAllocator::GetStats(Stats& stats) {
+	stats.installed = g_installed;
+	stats.arenaBytes = g_arenaBytes.load(std::memory_order_relaxed);
+	stats.largeInUse = g_largeInUse.load(std::memory_order_relaxed);
+	stats.largeBytes = g_largeBytes.load(std::memory_order_relaxed);
+	stats.largeTotal = g_largeTotal.load(std::memory_order_relaxed);
+	stats.classes.assign(kNumClasses, ClassStats{});
+
+	std::lock_guard<std::mutex> lock(g_mutex);
+	for (int c = 0; c < kNumClasses; c++) {
+		uint64_t allocs = g_retiredAllocs[c];
+		uint64_t frees = g_retiredFrees[c];
+		uint64_t cached = g_centralFree[c];
+		for (ThreadPool* pool = g_pools; pool; pool = pool->next) {
+			allocs += pool->allocs[c].Get();
+			frees += pool->frees[c].Get();
+			cached += pool->cached[c].Get();
+		}
+		ClassStats& cs = stats.classes[c];
+		cs.size = kClassSizes[c];
+		cs.inUse = allocs >= frees ? allocs - frees : 0;
+		cs.cached = cached;
+		cs.total = allocs;
+	}
+}
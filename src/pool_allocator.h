@@ -0,0 +1,57 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Size-Class Pool Allocator Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * PoolAllocator - SQLITE_CONFIG_MALLOC backend for the addon
+ *
+ * Small requests (<= 2 KiB: Mem cells, VDBE frames, parse trees, lookaside
+ * overflow) are served from per-thread free lists of fixed size classes.
+ * Threads refill those lists in batches from 256 KiB arena chunks, each
+ * dedicated to one class. Larger requests (page cache, big blobs) go
+ * straight to the system allocator. Blocks freed on another thread join
+ * that thread's free list. A thread keeps at most 64 KiB of free blocks per
+ * class and returns the surplus to the chunks; so does a thread that exits.
+ * Once every block of a chunk is back, the chunk goes back to the system,
+ * so memory use falls again after a peak.
+ *
+ * Installed once per process from the addon Init, before SQLite is
+ * initialized. Setting HEXCORE_SQLITE_MALLOC=system in the environment keeps
+ * SQLite on the system allocator.
+ */
+class PoolAllocator {
+public:
+	struct ClassStats {
+		uint32_t size;       // usable bytes per block
+		uint64_t inUse;      // blocks currently handed out
+		uint64_t cached;     // free blocks held in free lists and chunks
+		uint64_t total;      // allocations served since start
+	};
+
+	struct Stats {
+		bool installed;
+		uint64_t arenaBytes;     // bytes reserved for size-class blocks
+		uint64_t largeInUse;     // system-allocator blocks currently live
+		uint64_t largeBytes;     // bytes in those blocks
+		uint64_t largeTotal;
+		std::vector<ClassStats> classes;
+	};
+
+	// Registers the allocator with sqlite3_config(); returns false if the
+	// system allocator stays in use (env switch or SQLite already initialized)
+	static bool Install();
+	static bool IsInstalled();
+	static void GetStats(Stats& stats);
+};
+
+#endif // POOL_ALLOCATOR_H
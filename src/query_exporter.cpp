@@ -0,0 +1,298 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Streaming Query Exporter Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "query_exporter.h"
+#include "connection_extensions.h"
+#include "interrupt_timer.h"
+#include "json_writer.h"
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <filesystem>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEX_EXPORT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Output is handed to write() in blocks of about this size
+const size_t kFlushSize = 1 << 20;
+
+// True when a CSV field contains ',', '"', CR or LF and must be quoted
+bool CsvNeedsQuotes(const char* p, const char* end) {
+#ifdef HEX_EXPORT_SSE2
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+	while (end - p >= 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, quote)),
+			_mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)));
+		if (_mm_movemask_epi8(hit)) return true;
+		p += 16;
+	}
+#endif
+	for (; p < end; p++) {
+		if (*p == ',' || *p == '"' || *p == '\r' || *p == '\n') return true;
+	}
+	return false;
+}
+
+/**
+ * Writer - append-only output buffer over a file descriptor
+ */
+class Writer {
+public:
+	~Writer() {
+		if (owned_ && fd_ >= 0) {
+#ifdef _WIN32
+			_close(fd_);
+#else
+			close(fd_);
+#endif
+		}
+	}
+
+	bool Open(const std::string& path, int fd, std::string& error) {
+		buffer_.reserve(kFlushSize + 4096);
+		if (fd >= 0) {
+			fd_ = fd;
+			return true;
+		}
+#ifdef _WIN32
+		fd_ = _wopen(std::filesystem::u8path(path).c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+			_S_IREAD | _S_IWRITE);
+#else
+		do {
+			fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+		} while (fd_ < 0 && errno == EINTR);
+#endif
+		if (fd_ < 0) {
+			error = "Cannot open " + path + ": " + strerror(errno);
+			return false;
+		}
+		owned_ = true;
+		return true;
+	}
+
+	std::string& Buffer() { return buffer_; }
+	uint64_t Written() const { return written_; }
+
+	// Call after each row; writes once a full block has accumulated
+	bool Maybe(std::string& error) {
+		return buffer_.size() < kFlushSize || Flush(error);
+	}
+
+	bool Flush(std::string& error) {
+		const char* p = buffer_.data();
+		size_t left = buffer_.size();
+		while (left > 0) {
+#ifdef _WIN32
+			int n = _write(fd_, p, static_cast<unsigned>(left > 0x40000000 ? 0x40000000 : left));
+#else
+			ssize_t n = write(fd_, p, left);
+			if (n < 0 && errno == EINTR) continue;
+#endif
+			if (n < 0) {
+				error = std::string("Write failed: ") + strerror(errno);
+				return false;
+			}
+			p += n;
+			left -= static_cast<size_t>(n);
+			written_ += static_cast<uint64_t>(n);
+		}
+		buffer_.clear();
+		return true;
+	}
+
+private:
+	int fd_ = -1;
+	bool owned_ = false;
+	uint64_t written_ = 0;
+	std::string buffer_;
+};
+
+// An empty string is written as "" so it does not read back as NULL
+void AppendCsvField(std::string& out, const char* p, size_t length) {
+	const char* end = p + length;
+	if (length && !CsvNeedsQuotes(p, end)) {
+		out.append(p, length);
+		return;
+	}
+	out += '"';
+	for (;;) {
+		const char* quote = static_cast<const char*>(memchr(p, '"', end - p));
+		if (!quote) break;
+		out.append(p, quote + 1);
+		out += '"';
+		p = quote + 1;
+	}
+	out.append(p, end);
+	out += '"';
+}
+
+class Export {
+public:
+	Export(const QueryExporter::Options& options, QueryExporter::Result& result)
+		: options_(options), result_(result) {}
+
+	~Export() {
+		sqlite3_finalize(stmt_);
+		sqlite3_close(db_);
+	}
+
+	void Run() {
+		int rc = sqlite3_open_v2(options_.database.c_str(), &db_, SQLITE_OPEN_READONLY,
+			options_.vfs.empty() ? nullptr : options_.vfs.c_str());
+		if (rc != SQLITE_OK) return Fail(rc, db_ ? sqlite3_errmsg(db_) : sqlite3_errstr(rc));
+		sqlite3_extended_result_codes(db_, 1);
+		sqlite3_busy_timeout(db_, options_.busyTimeout);
+		// The query and the views it reads may use the addon's SQL functions,
+		// carray() or an IOC tokenizer
+		std::string error;
+		rc = ConnectionExtensions::Register(db_, options_.tokenizers, error);
+		if (rc != SQLITE_OK) return Fail(rc, error);
+
+		rc = sqlite3_prepare_v2(db_, options_.sql.c_str(), -1, &stmt_, nullptr);
+		if (rc != SQLITE_OK) return Fail(rc, sqlite3_errmsg(db_));
+		if (!stmt_) return Fail(SQLITE_MISUSE, "The statement is empty");
+		for (const QueryExporter::Param& param : options_.params) {
+			if (!Bind(param)) return;
+		}
+
+		if (!writer_.Open(options_.path, options_.fd, error)) return Fail(SQLITE_CANTOPEN, error);
+		bool csv = options_.format == QueryExporter::Format::Csv;
+		int columns = sqlite3_column_count(stmt_);
+		std::string& out = writer_.Buffer();
+
+		// Column names are escaped once; NDJSON rows reuse the "name": prefixes
+		std::vector<std::string> keys(columns);
+		for (int c = 0; c < columns; c++) {
+			const char* name = sqlite3_column_name(stmt_, c);
+			if (!name) return Fail(SQLITE_NOMEM, sqlite3_errstr(SQLITE_NOMEM));
+			if (csv) {
+				AppendCsvField(keys[c], name, strlen(name));
+			} else {
+				JsonWriter::AppendString(keys[c], name, strlen(name));
+				keys[c] += ':';
+			}
+		}
+		if (csv && options_.header) {
+			for (int c = 0; c < columns; c++) {
+				if (c) out += ',';
+				out += keys[c];
+			}
+			out += '\n';
+		}
+
+		ScopedDeadline deadline(db_, options_.timeout);
+		while ((rc = sqlite3_step(stmt_)) == SQLITE_ROW) {
+			if (!csv) out += '{';
+			for (int c = 0; c < columns; c++) {
+				if (c) out += ',';
+				if (!csv) out += keys[c];
+				AppendValue(out, c, csv);
+			}
+			out += csv ? "\n" : "}\n";
+			result_.rows++;
+			if (!writer_.Maybe(error)) return Fail(SQLITE_IOERR, error);
+		}
+		if (rc != SQLITE_DONE) return Fail(rc, sqlite3_errmsg(db_));
+		if (!writer_.Flush(error)) return Fail(SQLITE_IOERR, error);
+		result_.bytes = writer_.Written();
+	}
+
+private:
+	void Fail(int rc, const std::string& message) {
+		result_.failed = true;
+		result_.code = rc == SQLITE_OK ? SQLITE_ERROR : rc;
+		result_.error = message;
+		result_.bytes = writer_.Written();
+	}
+
+	bool Bind(const QueryExporter::Param& param) {
+		int rc;
+		switch (param.type) {
+			case SQLITE_INTEGER: rc = sqlite3_bind_int64(stmt_, param.index, param.integer); break;
+			case SQLITE_FLOAT: rc = sqlite3_bind_double(stmt_, param.index, param.real); break;
+			case SQLITE_TEXT:
+				rc = sqlite3_bind_text64(stmt_, param.index, param.bytes.data(), param.bytes.size(), SQLITE_STATIC, SQLITE_UTF8);
+				break;
+			case SQLITE_BLOB:
+				rc = sqlite3_bind_blob64(stmt_, param.index, param.bytes.data(), param.bytes.size(), SQLITE_STATIC);
+				break;
+			default: rc = sqlite3_bind_null(stmt_, param.index); break;
+		}
+		if (rc != SQLITE_OK) {
+			Fail(rc, sqlite3_errmsg(db_));
+			return false;
+		}
+		return true;
+	}
+
+	void AppendValue(std::string& out, int c, bool csv) {
+		if (!csv) return JsonWriter::AppendColumn(out, stmt_, c);
+		switch (sqlite3_column_type(stmt_, c)) {
+			case SQLITE_INTEGER:
+				JsonWriter::AppendInteger(out, sqlite3_column_int64(stmt_, c));
+				break;
+			case SQLITE_FLOAT: {
+				double value = sqlite3_column_double(stmt_, c);
+				if (std::isfinite(value)) {
+					JsonWriter::AppendReal(out, value);
+				} else {
+					out += std::isnan(value) ? "NaN" : value > 0 ? "Infinity" : "-Infinity";
+				}
+				break;
+			}
+			case SQLITE_TEXT: {
+				const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, c));
+				AppendCsvField(out, text, static_cast<size_t>(sqlite3_column_bytes(stmt_, c)));
+				break;
+			}
+			case SQLITE_BLOB: {
+				const unsigned char* data = static_cast<const unsigned char*>(sqlite3_column_blob(stmt_, c));
+				JsonWriter::AppendBase64(out, data, static_cast<size_t>(sqlite3_column_bytes(stmt_, c)));
+				break;
+			}
+			default:
+				// NULL is an empty field
+				break;
+		}
+	}
+
+	const QueryExporter::Options& options_;
+	QueryExporter::Result& result_;
+	sqlite3* db_ = nullptr;
+	sqlite3_stmt* stmt_ = nullptr;
+	Writer writer_;
+};
+
+} // namespace
+
+void QueryExporter::Run(const Options& options, Result& result) {
+	try {
+		Export(options, result).Run();
+	} catch (const std::bad_alloc&) {
+		result.failed = true;
+		result.code = SQLITE_NOMEM;
+		result.error = sqlite3_errstr(SQLITE_NOMEM);
+	}
+}
@@ -0,0 +1,65 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Streaming Query Exporter Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef QUERY_EXPORTER_H
+#define QUERY_EXPORTER_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * QueryExporter - runs a read-only query on the calling (worker) thread and
+ * serializes each row straight into a buffered file writer as NDJSON or CSV
+ *
+ * Like BulkImporter it opens its own read-only connection to the database
+ * file, so rows never become JS objects and the main connection stays
+ * usable; in WAL mode the export reads one consistent snapshot. Text is
+ * scanned 16 bytes at a time for characters that need JSON escaping or CSV
+ * quoting and copied in runs. BLOBs are written as base64.
+ */
+class QueryExporter {
+public:
+	enum class Format { Ndjson, Csv };
+
+	// A bound parameter captured on the JS thread
+	struct Param {
+		int index;
+		int type;            // SQLITE_NULL, _INTEGER, _FLOAT, _TEXT or _BLOB
+		int64_t integer;
+		double real;
+		std::string bytes;
+	};
+
+	struct Options {
+		std::string database;
+		std::string vfs;
+		std::string sql;
+		std::vector<Param> params;
+		std::string path;  // written (truncated) unless fd >= 0
+		int fd;            // caller-owned descriptor, left open
+		Format format;
+		bool header;       // CSV: first line names the columns
+		int busyTimeout;
+		int64_t timeout;   // ms, 0 = none (the statement's deadline)
+		std::vector<std::string> tokenizers; // IOC tokenizers to register
+	};
+
+	struct Result {
+		uint64_t rows = 0;
+		uint64_t bytes = 0;
+		bool failed = false;
+		int code = SQLITE_OK;
+		std::string error;
+	};
+
+	// Never throws; failures land in result
+	static void Run(const Options& options, Result& result);
+};
+
+#endif // QUERY_EXPORTER_H
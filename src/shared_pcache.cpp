@@ -0,0 +1,407 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Shared Page Cache Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "shared_pcache.h"
+#include <sqlite3.h>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+namespace {
+
+struct Cache;
+
+// Precedes the page buffer and the pager's extra bytes
+struct Page {
+	sqlite3_pcache_page base;
+	unsigned key;
+	bool pinned;
+	bool fromRegion;
+	Cache* owner;
+	Page* gPrev;     // global LRU (purgeable, unpinned pages only)
+	Page* gNext;
+	Page* cPrev;     // owner's LRU
+	Page* cNext;
+};
+
+constexpr size_t kPageHeader = (sizeof(Page) + 7) & ~static_cast<size_t>(7);
+
+struct LruList {
+	Page* head = nullptr;   // most recently unpinned
+	Page* tail = nullptr;
+};
+
+struct Cache {
+	size_t szPage;
+	size_t szExtra;
+	size_t szAlloc;
+	bool purgeable;
+	unsigned nMax;
+	unsigned n90pct;
+	unsigned nPinned;
+	std::unordered_map<unsigned, Page*> pages;
+	LruList lru;
+};
+
+bool g_installed = false;
+
+std::mutex g_mutex;                       // guards everything below
+LruList g_lru;
+uint64_t g_budget = 0;
+uint64_t g_purgeableBytes = 0;
+uint64_t g_pages = 0;
+uint64_t g_pinned = 0;
+uint64_t g_caches = 0;
+uint64_t g_hits = 0;
+uint64_t g_misses = 0;
+uint64_t g_evictions = 0;
+
+char* g_regionStart = nullptr;
+char* g_regionEnd = nullptr;
+size_t g_regionSlot = 0;
+void* g_regionFree = nullptr;
+
+// ---------------------------------------------------------------------------
+// LRU lists
+// ---------------------------------------------------------------------------
+
+void LinkGlobal(Page* page) {
+	page->gPrev = nullptr;
+	page->gNext = g_lru.head;
+	if (g_lru.head) g_lru.head->gPrev = page;
+	else g_lru.tail = page;
+	g_lru.head = page;
+}
+
+void UnlinkGlobal(Page* page) {
+	if (page->gPrev) page->gPrev->gNext = page->gNext;
+	else g_lru.head = page->gNext;
+	if (page->gNext) page->gNext->gPrev = page->gPrev;
+	else g_lru.tail = page->gPrev;
+	page->gPrev = page->gNext = nullptr;
+}
+
+void LinkCache(Page* page) {
+	LruList& lru = page->owner->lru;
+	page->cPrev = nullptr;
+	page->cNext = lru.head;
+	if (lru.head) lru.head->cPrev = page;
+	else lru.tail = page;
+	lru.head = page;
+}
+
+void UnlinkCache(Page* page) {
+	LruList& lru = page->owner->lru;
+	if (page->cPrev) page->cPrev->cNext = page->cNext;
+	else lru.head = page->cNext;
+	if (page->cNext) page->cNext->cPrev = page->cPrev;
+	else lru.tail = page->cPrev;
+	page->cPrev = page->cNext = nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Page allocation
+// ---------------------------------------------------------------------------
+
+Page* AllocPage(Cache* cache, unsigned key) {
+	Page* page = nullptr;
+	bool fromRegion = false;
+	if (g_regionFree && cache->szAlloc <= g_regionSlot) {
+		page = static_cast<Page*>(g_regionFree);
+		g_regionFree = *static_cast<void**>(g_regionFree);
+		fromRegion = true;
+	} else {
+		page = static_cast<Page*>(malloc(cache->szAlloc));
+		if (!page) return nullptr;
+	}
+
+	char* data = reinterpret_cast<char*>(page) + kPageHeader;
+	page->base.pBuf = data;
+	page->base.pExtra = data + cache->szPage;
+	memset(page->base.pExtra, 0, cache->szExtra);
+	page->key = key;
+	page->pinned = true;
+	page->fromRegion = fromRegion;
+	page->owner = cache;
+	page->gPrev = page->gNext = nullptr;
+	page->cPrev = page->cNext = nullptr;
+
+	cache->pages.emplace(key, page);
+	cache->nPinned++;
+	g_pinned++;
+	g_pages++;
+	if (cache->purgeable) g_purgeableBytes += cache->szAlloc;
+	return page;
+}
+
+// Unlinks and frees a page; the caller erases it from the owner's map
+void FreePage(Page* page) {
+	Cache* cache = page->owner;
+	if (page->pinned) {
+		cache->nPinned--;
+		g_pinned--;
+	} else {
+		UnlinkCache(page);
+		if (cache->purgeable) UnlinkGlobal(page);
+	}
+	g_pages--;
+	if (cache->purgeable) g_purgeableBytes -= cache->szAlloc;
+
+	char* p = reinterpret_cast<char*>(page);
+	if (page->fromRegion && p >= g_regionStart && p < g_regionEnd) {
+		*reinterpret_cast<void**>(p) = g_regionFree;
+		g_regionFree = p;
+	} else {
+		free(page);
+	}
+}
+
+void EvictPage(Page* page) {
+	page->owner->pages.erase(page->key);
+	FreePage(page);
+}
+
+// Drops the oldest unpinned pages of any cache until the budget holds
+void EnforceBudget() {
+	while (g_budget && g_purgeableBytes > g_budget && g_lru.tail) {
+		EvictPage(g_lru.tail);
+		g_evictions++;
+	}
+}
+
+void ShrinkCache(Cache* cache, size_t limit) {
+	while (cache->pages.size() > limit && cache->lru.tail) {
+		EvictPage(cache->lru.tail);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// sqlite3_pcache_methods2
+// ---------------------------------------------------------------------------
+
+int CacheInit(void*) { return SQLITE_OK; }
+void CacheShutdown(void*) {}
+
+sqlite3_pcache* CacheCreate(int szPage, int szExtra, int bPurgeable) {
+	Cache* cache = new (std::nothrow) Cache();
+	if (!cache) return nullptr;
+	cache->szPage = static_cast<size_t>(szPage);
+	cache->szExtra = static_cast<size_t>(szExtra);
+	cache->szAlloc = (kPageHeader + cache->szPage + cache->szExtra + 7) & ~static_cast<size_t>(7);
+	cache->purgeable = bPurgeable != 0;
+	cache->nMax = 100;
+	cache->n90pct = 90;
+	cache->nPinned = 0;
+
+	std::lock_guard<std::mutex> lock(g_mutex);
+	g_caches++;
+	return reinterpret_cast<sqlite3_pcache*>(cache);
+}
+
+void CacheCachesize(sqlite3_pcache* p, int nCachesize) {
+	Cache* cache = reinterpret_cast<Cache*>(p);
+	std::lock_guard<std::mutex> lock(g_mutex);
+	if (!cache->purgeable) return;
+	cache->nMax = nCachesize > 0 ? static_cast<unsigned>(nCachesize) : 0;
+	cache->n90pct = cache->nMax * 9 / 10;
+	ShrinkCache(cache, cache->nMax);
+}
+
+int CachePagecount(sqlite3_pcache* p) {
+	Cache* cache = reinterpret_cast<Cache*>(p);
+	std::lock_guard<std::mutex> lock(g_mutex);
+	return static_cast<int>(cache->pages.size());
+}
+
+sqlite3_pcache_page* CacheFetch(sqlite3_pcache* p, unsigned key, int createFlag) {
+	Cache* cache = reinterpret_cast<Cache*>(p);
+	std::lock_guard<std::mutex> lock(g_mutex);
+
+	auto it = cache->pages.find(key);
+	if (it != cache->pages.end()) {
+		Page* page = it->second;
+		if (!page->pinned) {
+			UnlinkCache(page);
+			if (cache->purgeable) UnlinkGlobal(page);
+			page->pinned = true;
+			cache->nPinned++;
+			g_pinned++;
+		}
+		g_hits++;
+		return &page->base;
+	}
+
+	g_misses++;
+	if (createFlag == 0) return nullptr;
+
+	if (cache->purgeable) {
+		bool overBudget = g_budget && g_purgeableBytes + cache->szAlloc > g_budget;
+		// createFlag 1: only allocate when it is cheap; a NULL return makes
+		// the pager spill dirty pages and retry with createFlag 2
+		if (createFlag == 1 && (cache->nPinned >= cache->n90pct || (overBudget && !g_lru.tail))) {
+			return nullptr;
+		}
+		if (cache->pages.size() >= cache->nMax) {
+			ShrinkCache(cache, cache->nMax ? cache->nMax - 1 : 0);
+		}
+		if (overBudget) {
+			while (g_lru.tail && g_purgeableBytes + cache->szAlloc > g_budget) {
+				EvictPage(g_lru.tail);
+				g_evictions++;
+			}
+		}
+	}
+
+	Page* page = AllocPage(cache, key);
+	return page ? &page->base : nullptr;
+}
+
+void CacheUnpin(sqlite3_pcache* p, sqlite3_pcache_page* pg, int discard) {
+	Cache* cache = reinterpret_cast<Cache*>(p);
+	Page* page = reinterpret_cast<Page*>(pg);
+	std::lock_guard<std::mutex> lock(g_mutex);
+
+	if (discard || (cache->purgeable && cache->pages.size() > cache->nMax)) {
+		EvictPage(page);
+		return;
+	}
+	page->pinned = false;
+	cache->nPinned--;
+	g_pinned--;
+	LinkCache(page);
+	if (cache->purgeable) {
+		LinkGlobal(page);
+		EnforceBudget();
+	}
+}
+
+void CacheRekey(sqlite3_pcache* p, sqlite3_pcache_page* pg, unsigned oldKey, unsigned newKey) {
+	Cache* cache = reinterpret_cast<Cache*>(p);
+	Page* page = reinterpret_cast<Page*>(pg);
+	std::lock_guard<std::mutex> lock(g_mutex);
+
+	// Any page already cached under newKey is unpinned and must be discarded
+	auto existing = cache->pages.find(newKey);
+	if (existing != cache->pages.end()) {
+		Page* stale = existing->second;
+		cache->pages.erase(existing);
+		FreePage(stale);
+	}
+	cache->pages.erase(oldKey);
+	page->key = newKey;
+	cache->pages.emplace(newKey, page);
+}
+
+void CacheTruncate(sqlite3_pcache* p, unsigned iLimit) {
+	Cache* cache = reinterpret_cast<Cache*>(p);
+	std::lock_guard<std::mutex> lock(g_mutex);
+	for (auto it = cache->pages.begin(); it != cache->pages.end();) {
+		if (it->first >= iLimit) {
+			Page* page = it->second;
+			it = cache->pages.erase(it);
+			FreePage(page);
+		} else {
+			++it;
+		}
+	}
+}
+
+void CacheDestroy(sqlite3_pcache* p) {
+	Cache* cache = reinterpret_cast<Cache*>(p);
+	{
+		std::lock_guard<std::mutex> lock(g_mutex);
+		for (auto& entry : cache->pages) {
+			FreePage(entry.second);
+		}
+		cache->pages.clear();
+		g_caches--;
+	}
+	delete cache;
+}
+
+void CacheShrink(sqlite3_pcache* p) {
+	Cache* cache = reinterpret_cast<Cache*>(p);
+	std::lock_guard<std::mutex> lock(g_mutex);
+	// Unpinned pages of an in-memory database are its only copy
+	if (!cache->purgeable) return;
+	ShrinkCache(cache, 0);
+}
+
+const sqlite3_pcache_methods2 kCacheMethods = {
+	1,
+	nullptr,
+	CacheInit,
+	CacheShutdown,
+	CacheCreate,
+	CacheCachesize,
+	CachePagecount,
+	CacheFetch,
+	CacheUnpin,
+	CacheRekey,
+	CacheTruncate,
+	CacheDestroy,
+	CacheShrink,
+};
+
+} // namespace
+
+// ============================================================================
+// SharedPageCache
+// ============================================================================
+
+bool SharedPageCache::Install() {
+	static std::once_flag once;
+	std::call_once(once, [] {
+		const char* mode = getenv("HEXCORE_SQLITE_PCACHE");
+		if (mode && strcmp(mode, "default") == 0) return;
+		// Fails with SQLITE_MISUSE if SQLite was already initialized
+		g_installed = sqlite3_config(SQLITE_CONFIG_PCACHE2, &kCacheMethods) == SQLITE_OK;
+	});
+	return g_installed;
+}
+
+bool SharedPageCache::IsInstalled() {
+	return g_installed;
+}
+
+void SharedPageCache::SetBudget(uint64_t bytes) {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	g_budget = bytes;
+	EnforceBudget();
+}
+
+void SharedPageCache::GetStats(Stats& stats) {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	stats.installed = g_installed;
+	stats.budget = g_budget;
+	stats.bytes = g_purgeableBytes;
+	stats.pages = g_pages;
+	stats.pinned = g_pinned;
+	stats.caches = g_caches;
+	stats.hits = g_hits;
+	stats.misses = g_misses;
+	stats.evictions = g_evictions;
+}
+
+size_t SharedPageCache::PageOverhead() {
+	return kPageHeader;
+}
+
+void SharedPageCache::UseRegion(void* data, size_t slotSize, int slots) {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	if (g_regionStart) return;
+	g_regionStart = static_cast<char*>(data);
+	g_regionEnd = g_regionStart + slotSize * static_cast<size_t>(slots);
+	g_regionSlot = slotSize;
+	for (int i = slots - 1; i >= 0; i--) {
+		char* slot = g_regionStart + slotSize * static_cast<size_t>(i);
+		*reinterpret_cast<void**>(slot) = g_regionFree;
+		g_regionFree = slot;
+	}
+}
@@ -0,0 +1,56 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Shared Page Cache Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef SHARED_PCACHE_H
+#define SHARED_PCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * SharedPageCache - SQLITE_CONFIG_PCACHE2 backend with one process-wide
+ * memory budget
+ *
+ * Every pager cache (one per attached database of every connection) keeps
+ * its unpinned pages on two LRU lists: its own, used to honour the
+ * connection's cache_size, and a global one shared by all caches. When the
+ * purgeable pages of all caches exceed the budget, pages are evicted from
+ * the global tail, so idle databases hand memory to busy ones. In-memory
+ * databases (non-purgeable caches) hold the data itself and are never
+ * evicted or counted against the budget.
+ *
+ * One mutex guards both lists, so every page fetch and unpin in the process
+ * takes the same lock; connections doing heavy concurrent I/O contend on it.
+ *
+ * Installed once per process from the addon Init, before SQLite is
+ * initialized. HEXCORE_SQLITE_PCACHE=default keeps SQLite's own pcache1.
+ */
+class SharedPageCache {
+public:
+	struct Stats {
+		bool installed;
+		uint64_t budget;         // bytes, 0 = unlimited
+		uint64_t bytes;          // purgeable page bytes currently cached
+		uint64_t pages;          // all cached pages, including in-memory databases
+		uint64_t pinned;
+		uint64_t caches;
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t evictions;      // pages dropped to stay within the budget
+	};
+
+	static bool Install();
+	static bool IsInstalled();
+	static void SetBudget(uint64_t bytes);
+	static void GetStats(Stats& stats);
+
+	// Serves pages that fit from a preallocated region (the pageCache option)
+	static size_t PageOverhead();
+	static void UseRegion(void* data, size_t slotSize, int slots);
+};
+
+#endif // SHARED_PCACHE_H
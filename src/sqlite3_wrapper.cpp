@@ -6,8 +6,29 @@
  */
 
 #include "sqlite3_wrapper.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
 #include <cstring>
+#include <memory>
 #include <cassert>
+#include <unordered_map>
+
+// Deadline expirations, interrupt() and lock contention get codes callers
+// can match on
+static const char* ErrorCode(int rc) {
+	switch (rc & 0xff) {
+		case SQLITE_INTERRUPT: return "SQLITE_INTERRUPT";
+		case SQLITE_BUSY: return "SQLITE_BUSY";
+		default: return sqlite3_errstr(rc);
+	}
+}
+
+static int64_t SteadyMillis() {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 // ============================================================================
 // DatabaseWrapper
@@ -23,6 +44,18 @@ Napi::Object DatabaseWrapper::Init(Napi::Env env, Napi::Object exports) {
 		InstanceMethod("pragma", &DatabaseWrapper::Pragma),
 		InstanceMethod("loadExtension", &DatabaseWrapper::LoadExtension),
 		InstanceMethod("defaultSafeIntegers", &DatabaseWrapper::DefaultSafeIntegers),
+		InstanceMethod("adviseIndexes", &DatabaseWrapper::AdviseIndexes),
+		InstanceMethod("cacheStats", &DatabaseWrapper::CacheStats),
+		InstanceMethod("checkpointStats", &DatabaseWrapper::CheckpointStats),
+		InstanceMethod("openBlob", &DatabaseWrapper::OpenBlob),
+		InstanceMethod("createSession", &DatabaseWrapper::CreateSession),
+		InstanceMethod("applyChangeset", &DatabaseWrapper::ApplyChangeset),
+		InstanceMethod("interrupt", &DatabaseWrapper::Interrupt),
+		InstanceMethod("pushDeadline", &DatabaseWrapper::PushDeadline),
+		InstanceMethod("popDeadline", &DatabaseWrapper::PopDeadline),
+		InstanceMethod("registerTokenizer", &DatabaseWrapper::RegisterTokenizer),
+		InstanceMethod("importFile", &DatabaseWrapper::ImportFile),
+		InstanceMethod("pipeline", &DatabaseWrapper::Pipeline),
 		InstanceAccessor("name", &DatabaseWrapper::GetName, nullptr),
 		InstanceAccessor("open", &DatabaseWrapper::GetOpen, nullptr),
 		InstanceAccessor("inTransaction", &DatabaseWrapper::GetInTransaction, nullptr),
@@ -42,11 +75,19 @@ DatabaseWrapper::DatabaseWrapper(const Napi::CallbackInfo& info)
 	, open_(false)
 	, readonly_(false)
 	, memory_(false)
+	, trace_(nullptr)
+	, lookaside_(nullptr)
+	, checkpointer_(nullptr)
+	, fullScanThreshold_(1000)
+	, queryTimeout_(0)
+	, nextDeadlineToken_(0)
+	, deadline_(0)
+	, busyTimeout_(5000)
 	, safeIntegers_(false)
 {
 	Napi::Env env = info.Env();
 
-	// Args: filename, filenameGiven, anonymous, readonly, fileMustExist, timeout, verbose, buffer
+	// Args: filename, filenameGiven, anonymous, readonly, fileMustExist, timeout, verbose, buffer, nativeOptions
 	// We support the simplified form: (filename, anonymous, readonly, fileMustExist, timeout)
 	if (info.Length() < 1 || !info[0].IsString()) {
 		Napi::TypeError::New(env, "Expected filename as first argument").ThrowAsJavaScriptException();
@@ -84,7 +125,33 @@ DatabaseWrapper::DatabaseWrapper(const Napi::CallbackInfo& info)
 		flags |= SQLITE_OPEN_MEMORY;
 	}
 
-	int rc = sqlite3_open_v2(filename.c_str(), &db_, flags, nullptr);
+	// HexCore extensions are passed as a trailing options object
+	Napi::Object nativeOpts = info.Length() >= 9 && info[8].IsObject()
+		? info[8].As<Napi::Object>()
+		: Napi::Object::New(env);
+
+	bool hugePages = nativeOpts.Has("hugePages") && nativeOpts.Get("hugePages").ToBoolean().Value();
+
+	// Process-wide page-cache region; must be configured before SQLite initializes
+	if (nativeOpts.Has("pageCacheSlots") && nativeOpts.Get("pageCacheSlots").IsNumber()) {
+		int pages = nativeOpts.Get("pageCacheSlots").As<Napi::Number>().Int32Value();
+		int pageSize = nativeOpts.Get("pageCachePageSize").As<Napi::Number>().Int32Value();
+		std::string error;
+		if (!MemoryRegion::ConfigurePageCache(pageSize, pages, hugePages, error)) {
+			Napi::Error::New(env, error).ThrowAsJavaScriptException();
+			return;
+		}
+	}
+
+	// io_uring page I/O for on-disk databases; silently stays on the default
+	// VFS where io_uring is unavailable
+	const char* vfs = nullptr;
+	if (!isAnonymous && nativeOpts.Has("ioUring") && nativeOpts.Get("ioUring").ToBoolean().Value() &&
+		UringVfs::Register()) {
+		vfs = UringVfs::kName;
+	}
+
+	int rc = sqlite3_open_v2(filename.c_str(), &db_, flags, vfs);
 	if (rc != SQLITE_OK) {
 		std::string msg = db_ ? sqlite3_errmsg(db_) : "Failed to open database";
 		if (db_) { sqlite3_close(db_); db_ = nullptr; }
@@ -94,8 +161,32 @@ DatabaseWrapper::DatabaseWrapper(const Napi::CallbackInfo& info)
 
 	open_ = true;
 
-	// Set busy timeout
-	sqlite3_busy_timeout(db_, timeout);
+	// Per-connection lookaside backed by our own region (replaces SQLite's default
+	// heap slab); zero slots turns lookaside off
+	if (nativeOpts.Has("lookasideSlots") && nativeOpts.Get("lookasideSlots").IsNumber()) {
+		int slotSize = nativeOpts.Get("lookasideSlotSize").As<Napi::Number>().Int32Value() & ~7;
+		int slots = nativeOpts.Get("lookasideSlots").As<Napi::Number>().Int32Value();
+		if (slots == 0) {
+			rc = sqlite3_db_config(db_, SQLITE_DBCONFIG_LOOKASIDE, nullptr, 0, 0);
+		} else {
+			lookaside_ = MemoryRegion::Allocate(static_cast<size_t>(slotSize) * slots, hugePages);
+			rc = lookaside_
+				? sqlite3_db_config(db_, SQLITE_DBCONFIG_LOOKASIDE, lookaside_->Data(), slotSize, slots)
+				: SQLITE_NOMEM;
+		}
+		if (rc != SQLITE_OK) {
+			ThrowSqliteError(env, rc);
+			CloseConnection();
+			return;
+		}
+	}
+
+	// Set busy timeout. busyMode "immediate" installs no handler: SQLITE_BUSY
+	// reaches JS at once and retryOnBusy() backs off on the event loop instead
+	// of sleeping inside sqlite3_step
+	bool busyImmediate = nativeOpts.Has("busyImmediate") && nativeOpts.Get("busyImmediate").ToBoolean().Value();
+	sqlite3_busy_timeout(db_, busyImmediate ? 0 : timeout);
+	busyTimeout_ = timeout;
 
 	// Enable extended result codes
 	sqlite3_extended_result_codes(db_, 1);
@@ -103,6 +194,71 @@ DatabaseWrapper::DatabaseWrapper(const Napi::CallbackInfo& info)
 	// Set safe limits
 	sqlite3_limit(db_, SQLITE_LIMIT_LENGTH, INT32_MAX);
 
+	// Native normalization functions (hex_lower, hex_casefold, ...) and
+	// carray(?) over arrays bound as pointers (see StatementWrapper::BindValue)
+	std::string extensionError;
+	rc = ConnectionExtensions::Register(db_, tokenizers_, extensionError);
+	if (rc != SQLITE_OK) {
+		ThrowSqliteError(env, rc);
+		CloseConnection();
+		return;
+	}
+
+	// Memory-mapped reads (also valid in WAL mode: only the main file is mapped)
+	if (nativeOpts.Has("mmapSize") && nativeOpts.Get("mmapSize").IsNumber()) {
+		int64_t mmapSize = nativeOpts.Get("mmapSize").As<Napi::Number>().Int64Value();
+		std::string pragma = "PRAGMA mmap_size = " + std::to_string(mmapSize);
+		rc = sqlite3_exec(db_, pragma.c_str(), nullptr, nullptr, nullptr);
+		if (rc != SQLITE_OK) {
+			ThrowSqliteError(env, rc);
+			CloseConnection();
+			return;
+		}
+	}
+
+	// Scan-status counters cost a timestamp read per opcode; only profile() enables them
+	sqlite3_db_config(db_, SQLITE_DBCONFIG_STMT_SCANSTATUS, 0, nullptr);
+
+	// Verbose tracing (sampled, flushed to JS once per event-loop turn)
+	if (info.Length() >= 7 && info[6].IsFunction()) {
+		uint32_t sampleRate = 1;
+		if (nativeOpts.Has("verboseSampleRate") && nativeOpts.Get("verboseSampleRate").IsNumber()) {
+			sampleRate = nativeOpts.Get("verboseSampleRate").As<Napi::Number>().Uint32Value();
+		}
+		trace_ = TraceHook::Create(env, info[6].As<Napi::Function>(), sampleRate);
+		trace_->Attach(db_);
+	}
+
+	// Index advisor workload capture (0 disables)
+	if (nativeOpts.Has("fullScanThreshold") && nativeOpts.Get("fullScanThreshold").IsNumber()) {
+		fullScanThreshold_ = nativeOpts.Get("fullScanThreshold").As<Napi::Number>().Int64Value();
+	}
+
+	// Background checkpointing on a second connection (replaces auto-checkpoint)
+	if (!isAnonymous && !isReadonly && nativeOpts.Has("checkpointer") && nativeOpts.Get("checkpointer").IsObject()) {
+		Napi::Object cp = nativeOpts.Get("checkpointer").As<Napi::Object>();
+		std::string mode = cp.Get("mode").As<Napi::String>().Utf8Value();
+		std::string error;
+		checkpointer_ = WalCheckpointer::Start(db_,
+			cp.Get("threshold").As<Napi::Number>().Int32Value(),
+			mode == "truncate" ? SQLITE_CHECKPOINT_TRUNCATE
+				: mode == "restart" ? SQLITE_CHECKPOINT_RESTART
+				: SQLITE_CHECKPOINT_PASSIVE,
+			cp.Get("escalateAfter").As<Napi::Number>().Int32Value(),
+			timeout, error);
+		if (!checkpointer_) {
+			CloseConnection();
+			Napi::Error::New(env, error).ThrowAsJavaScriptException();
+			return;
+		}
+		checkpointer_->Attach(db_);
+	}
+
+	// Default deadline for every statement execution (0 disables)
+	if (nativeOpts.Has("queryTimeout") && nativeOpts.Get("queryTimeout").IsNumber()) {
+		queryTimeout_ = nativeOpts.Get("queryTimeout").As<Napi::Number>().Int64Value();
+	}
+
 	// Handle buffer (deserialize) if provided
 	if (info.Length() >= 8 && info[7].IsBuffer()) {
 		Napi::Buffer<uint8_t> buf = info[7].As<Napi::Buffer<uint8_t>>();
@@ -123,15 +279,46 @@ DatabaseWrapper::DatabaseWrapper(const Napi::CallbackInfo& info)
 }
 
 DatabaseWrapper::~DatabaseWrapper() {
+	CloseConnection();
+}
+
+void DatabaseWrapper::CloseConnection() {
 	if (db_) {
-		// Finalize all tracked statements
-		for (auto* stmt : statements_) {
+		// Finalize all tracked statements and blob handles (each one untracks
+		// itself, so iterate over a copy)
+		std::vector<StatementWrapper*> stmts(statements_.begin(), statements_.end());
+		for (auto* stmt : stmts) {
 			stmt->FinalizeStatement();
 		}
 		statements_.clear();
-		sqlite3_close(db_);
+		std::vector<BlobWrapper*> blobs(blobs_.begin(), blobs_.end());
+		for (auto* blob : blobs) {
+			blob->CloseBlob();
+		}
+		blobs_.clear();
+		std::vector<SessionWrapper*> sessions(sessions_.begin(), sessions_.end());
+		for (auto* session : sessions) {
+			session->DeleteSession();
+		}
+		sessions_.clear();
+		// Stop first so the writer is the last connection and cleans up the WAL
+		if (checkpointer_) {
+			checkpointer_->Stop(db_);
+			delete checkpointer_;
+			checkpointer_ = nullptr;
+		}
+		if (trace_) {
+			trace_->Release(db_);
+			trace_ = nullptr;
+		}
+		// Lookaside memory may only be released once the connection is gone
+		if (sqlite3_close(db_) == SQLITE_OK && lookaside_) {
+			delete lookaside_;
+		}
+		lookaside_ = nullptr;
 		db_ = nullptr;
 	}
+	open_ = false;
 }
 
 void DatabaseWrapper::TrackStatement(StatementWrapper* stmt) {
@@ -142,14 +329,39 @@ void DatabaseWrapper::UntrackStatement(StatementWrapper* stmt) {
 	statements_.erase(stmt);
 }
 
+void DatabaseWrapper::TrackBlob(BlobWrapper* blob) {
+	blobs_.insert(blob);
+}
+
+void DatabaseWrapper::UntrackBlob(BlobWrapper* blob) {
+	blobs_.erase(blob);
+}
+
+void DatabaseWrapper::TrackSession(SessionWrapper* session) {
+	sessions_.insert(session);
+}
+
+void DatabaseWrapper::UntrackSession(SessionWrapper* session) {
+	sessions_.erase(session);
+}
+
+void DatabaseWrapper::RecordWorkload(const std::string& sql) {
+	// Bounded: the workload only feeds the index advisor
+	if (workload_.size() >= 1000) return;
+	if (workloadSeen_.insert(sql).second) {
+		workload_.push_back(sql);
+	}
+}
+
 void DatabaseWrapper::ThrowSqliteError(Napi::Env env) {
 	ThrowSqliteError(env, sqlite3_errcode(db_));
 }
 
 void DatabaseWrapper::ThrowSqliteError(Napi::Env env, int rc) {
-	const char* msg = db_ ? sqlite3_errmsg(db_) : "Unknown SQLite error";
+	const char* msg = (rc & 0xff) == SQLITE_INTERRUPT ? sqlite3_errstr(rc)
+		: db_ ? sqlite3_errmsg(db_) : "Unknown SQLite error";
 	Napi::Error err = Napi::Error::New(env, msg);
-	err.Set("code", Napi::String::New(env, sqlite3_errstr(rc)));
+	err.Set("code", Napi::String::New(env, ErrorCode(rc)));
 	err.ThrowAsJavaScriptException();
 }
 
@@ -164,14 +376,24 @@ Napi::Value DatabaseWrapper::Exec(const Napi::CallbackInfo& info) {
 		return env.Undefined();
 	}
 
+	int64_t budget = ExecutionBudget(queryTimeout_);
+	if (budget < 0) {
+		ThrowSqliteError(env, SQLITE_INTERRUPT);
+		return env.Undefined();
+	}
+
 	std::string sql = info[0].As<Napi::String>().Utf8Value();
 	char* errMsg = nullptr;
-	int rc = sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &errMsg);
+	int rc;
+	{
+		ScopedDeadline deadline(db_, budget);
+		rc = sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &errMsg);
+	}
 	if (rc != SQLITE_OK) {
 		std::string msg = errMsg ? errMsg : "SQL execution failed";
 		if (errMsg) sqlite3_free(errMsg);
 		Napi::Error err = Napi::Error::New(env, msg);
-		err.Set("code", Napi::String::New(env, sqlite3_errstr(rc)));
+		err.Set("code", Napi::String::New(env, ErrorCode(rc)));
 		err.ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
@@ -200,17 +422,212 @@ Napi::Value DatabaseWrapper::Prepare(const Napi::CallbackInfo& info) {
 	return stmtObj;
 }
 
-Napi::Value DatabaseWrapper::Close(const Napi::CallbackInfo& info) {
+Napi::Value DatabaseWrapper::OpenBlob(const Napi::CallbackInfo& info) {
 	Napi::Env env = info.Env();
-	if (db_) {
-		for (auto* stmt : statements_) {
-			stmt->FinalizeStatement();
+	if (!open_) {
+		Napi::TypeError::New(env, "The database connection is not open").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Args: table, column, rowid, readonly, schema
+	Napi::Object blobObj = BlobWrapper::constructor.New({
+		info.This(),
+		info[0],
+		info[1],
+		info[2],
+		info[3],
+		info[4],
+	});
+
+	return blobObj;
+}
+
+Napi::Value DatabaseWrapper::CreateSession(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!open_) {
+		Napi::TypeError::New(env, "The database connection is not open").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Args: tables (array or null), schema
+	Napi::Object sessionObj = SessionWrapper::constructor.New({
+		info.This(),
+		info.Length() >= 1 ? info[0] : env.Null(),
+		info.Length() >= 2 ? info[1] : env.Undefined(),
+	});
+
+	return sessionObj;
+}
+
+namespace {
+
+struct ConflictContext {
+	Napi::Env env;
+	int policy;                 // SQLITE_CHANGESET_OMIT/REPLACE/ABORT when no handler
+	Napi::Function handler;     // optional per-conflict decision
+	uint32_t conflicts;
+	bool failed;
+	Napi::Error error;
+};
+
+const char* ConflictName(int type) {
+	switch (type) {
+		case SQLITE_CHANGESET_DATA: return "data";
+		case SQLITE_CHANGESET_NOTFOUND: return "notfound";
+		case SQLITE_CHANGESET_CONFLICT: return "conflict";
+		case SQLITE_CHANGESET_CONSTRAINT: return "constraint";
+		case SQLITE_CHANGESET_FOREIGN_KEY: return "foreign_key";
+		default: return "unknown";
+	}
+}
+
+const char* OperationName(int op) {
+	switch (op) {
+		case SQLITE_INSERT: return "insert";
+		case SQLITE_UPDATE: return "update";
+		case SQLITE_DELETE: return "delete";
+		default: return "unknown";
+	}
+}
+
+int PolicyFromString(const std::string& name) {
+	if (name == "omit") return SQLITE_CHANGESET_OMIT;
+	if (name == "replace") return SQLITE_CHANGESET_REPLACE;
+	if (name == "abort") return SQLITE_CHANGESET_ABORT;
+	return -1;
+}
+
+int ApplyConflict(void* ctx, int type, sqlite3_changeset_iter* iter) {
+	ConflictContext* context = static_cast<ConflictContext*>(ctx);
+	context->conflicts++;
+	int policy = context->policy;
+
+	if (!context->handler.IsEmpty()) {
+		const char* table = nullptr;
+		int columns = 0;
+		int op = 0;
+		int indirect = 0;
+		sqlite3changeset_op(iter, &table, &columns, &op, &indirect);
+
+		Napi::Object conflict = Napi::Object::New(context->env);
+		conflict.Set("type", Napi::String::New(context->env, ConflictName(type)));
+		conflict.Set("table", Napi::String::New(context->env, table ? table : ""));
+		conflict.Set("operation", Napi::String::New(context->env, OperationName(op)));
+
+		// A throwing handler must not unwind through SQLite: abort instead
+		try {
+			Napi::Value result = context->handler.Call({ conflict });
+			policy = result.IsString() ? PolicyFromString(result.As<Napi::String>().Utf8Value()) : -1;
+			if (policy < 0) {
+				context->error = Napi::TypeError::New(context->env, "onConflict must return \"omit\", \"replace\" or \"abort\"");
+				context->failed = true;
+				return SQLITE_CHANGESET_ABORT;
+			}
+		} catch (const Napi::Error& e) {
+			context->error = e;
+			context->failed = true;
+			return SQLITE_CHANGESET_ABORT;
 		}
-		statements_.clear();
-		sqlite3_close(db_);
-		db_ = nullptr;
-		open_ = false;
 	}
+
+	// REPLACE is only meaningful when a conflicting row exists
+	if (policy == SQLITE_CHANGESET_REPLACE && type != SQLITE_CHANGESET_DATA && type != SQLITE_CHANGESET_CONFLICT) {
+		return SQLITE_CHANGESET_OMIT;
+	}
+	return policy;
+}
+
+} // namespace
+
+Napi::Value DatabaseWrapper::ApplyChangeset(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!open_) {
+		Napi::TypeError::New(env, "The database connection is not open").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (info.Length() < 1 || !info[0].IsBuffer()) {
+		Napi::TypeError::New(env, "Expected a changeset Buffer").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Args: changeset, onConflict (policy string or function)
+	ConflictContext context{ env, SQLITE_CHANGESET_ABORT, Napi::Function(), 0, false, Napi::Error() };
+	if (info.Length() >= 2 && info[1].IsFunction()) {
+		context.handler = info[1].As<Napi::Function>();
+	} else if (info.Length() >= 2 && info[1].IsString()) {
+		context.policy = PolicyFromString(info[1].As<Napi::String>().Utf8Value());
+		if (context.policy < 0) {
+			Napi::TypeError::New(env, "Expected onConflict to be \"omit\", \"replace\" or \"abort\"").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+	}
+
+	Napi::Buffer<uint8_t> changeset = info[0].As<Napi::Buffer<uint8_t>>();
+	int rc = sqlite3changeset_apply_v2(db_, static_cast<int>(changeset.Length()), changeset.Data(),
+		nullptr, ApplyConflict, &context, nullptr, nullptr, 0);
+	if (context.failed) {
+		context.error.ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (rc != SQLITE_OK) {
+		ThrowSqliteError(env, rc);
+		return env.Undefined();
+	}
+
+	Napi::Object result = Napi::Object::New(env);
+	result.Set("conflicts", Napi::Number::New(env, context.conflicts));
+	return result;
+}
+
+int64_t DatabaseWrapper::ExecutionBudget(int64_t timeoutMs) const {
+	if (deadline_ == 0) return timeoutMs > 0 ? timeoutMs : 0;
+	int64_t remaining = deadline_ - SteadyMillis();
+	if (remaining <= 0) return -1;
+	return timeoutMs > 0 && timeoutMs < remaining ? timeoutMs : remaining;
+}
+
+Napi::Value DatabaseWrapper::Interrupt(const Napi::CallbackInfo& info) {
+	if (db_) sqlite3_interrupt(db_);
+	return info.This();
+}
+
+// Adds a deadline of now + timeoutMs; returns a token for popDeadline()
+Napi::Value DatabaseWrapper::PushDeadline(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (info.Length() < 1 || !info[0].IsNumber()) {
+		Napi::TypeError::New(env, "Expected a timeout in milliseconds").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	int64_t deadline = SteadyMillis() + info[0].As<Napi::Number>().Int64Value();
+	uint32_t token = ++nextDeadlineToken_;
+	deadlines_.emplace_back(token, deadline);
+	if (deadline_ == 0 || deadline < deadline_) deadline_ = deadline;
+	return Napi::Number::New(env, token);
+}
+
+// Removes one scope's deadline; async scopes may end in any order, so the
+// earliest of the remaining ones is recomputed
+Napi::Value DatabaseWrapper::PopDeadline(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (info.Length() < 1 || !info[0].IsNumber()) {
+		Napi::TypeError::New(env, "Expected a token returned by pushDeadline()").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	uint32_t token = info[0].As<Napi::Number>().Uint32Value();
+	deadline_ = 0;
+	for (size_t i = 0; i < deadlines_.size();) {
+		if (deadlines_[i].first == token) {
+			deadlines_.erase(deadlines_.begin() + i);
+			continue;
+		}
+		if (deadline_ == 0 || deadlines_[i].second < deadline_) deadline_ = deadlines_[i].second;
+		i++;
+	}
+	return info.This();
+}
+
+Napi::Value DatabaseWrapper::Close(const Napi::CallbackInfo& info) {
+	CloseConnection();
 	return info.This();
 }
 
@@ -300,6 +717,296 @@ Napi::Value DatabaseWrapper::Pragma(const Napi::CallbackInfo& info) {
 	return rows;
 }
 
+/**
+ * ImportWorker - runs BulkImporter on the libuv thread pool and settles a
+ * promise; progress is delivered to the optional JS callback between batches
+ */
+class ImportWorker : public Napi::AsyncProgressWorker<BulkImporter::Progress> {
+public:
+	ImportWorker(Napi::Env env, const BulkImporter::Options& options, Napi::Value onProgress)
+		: Napi::AsyncProgressWorker<BulkImporter::Progress>(env)
+		, options_(options)
+		, deferred_(Napi::Promise::Deferred::New(env))
+		, cancelled_(false)
+	{
+		if (onProgress.IsFunction()) onProgress_ = Napi::Persistent(onProgress.As<Napi::Function>());
+	}
+
+	Napi::Promise Promise() const { return deferred_.Promise(); }
+
+protected:
+	void Execute(const ExecutionProgress& progress) override {
+		BulkImporter::Run(options_, [this, &progress](const BulkImporter::Progress& current) {
+			progress.Send(&current, 1);
+			return !cancelled_.load();
+		}, result_);
+	}
+
+	void OnProgress(const BulkImporter::Progress* data, size_t count) override {
+		if (onProgress_.IsEmpty() || count == 0 || cancelled_.load()) return;
+		Napi::Env env = Env();
+		Napi::HandleScope scope(env);
+		const BulkImporter::Progress& latest = data[count - 1];
+		Napi::Object info = Napi::Object::New(env);
+		info.Set("rows", Napi::Number::New(env, static_cast<double>(latest.rows)));
+		info.Set("lines", Napi::Number::New(env, static_cast<double>(latest.lines)));
+		info.Set("bytes", Napi::Number::New(env, static_cast<double>(latest.bytes)));
+		info.Set("totalBytes", Napi::Number::New(env, static_cast<double>(latest.totalBytes)));
+		try {
+			onProgress_.Call({ info });
+		} catch (const Napi::Error& e) {
+			// A throwing callback stops the import after the current batch
+			callbackError_ = Napi::Persistent(e.Value());
+			cancelled_ = true;
+		}
+	}
+
+	void OnOK() override {
+		Napi::Env env = Env();
+		if (!callbackError_.IsEmpty()) {
+			deferred_.Reject(callbackError_.Value());
+			return;
+		}
+		if (result_.failed) {
+			Napi::Error error = Napi::Error::New(env, result_.error);
+			error.Set("code", Napi::String::New(env, ErrorCode(result_.code)));
+			if (result_.line) error.Set("line", Napi::Number::New(env, static_cast<double>(result_.line)));
+			error.Set("rows", Napi::Number::New(env, static_cast<double>(result_.rows)));
+			deferred_.Reject(error.Value());
+			return;
+		}
+		Napi::Object out = Napi::Object::New(env);
+		out.Set("rows", Napi::Number::New(env, static_cast<double>(result_.rows)));
+		out.Set("lines", Napi::Number::New(env, static_cast<double>(result_.lines)));
+		out.Set("skipped", Napi::Number::New(env, static_cast<double>(result_.skipped)));
+		Napi::Array errors = Napi::Array::New(env, result_.errors.size());
+		for (size_t i = 0; i < result_.errors.size(); i++) {
+			Napi::Object entry = Napi::Object::New(env);
+			entry.Set("line", Napi::Number::New(env, static_cast<double>(result_.errors[i].line)));
+			entry.Set("message", Napi::String::New(env, result_.errors[i].message));
+			errors.Set(static_cast<uint32_t>(i), entry);
+		}
+		out.Set("errors", errors);
+		deferred_.Resolve(out);
+	}
+
+	void OnError(const Napi::Error& e) override {
+		deferred_.Reject(e.Value());
+	}
+
+private:
+	BulkImporter::Options options_;
+	BulkImporter::Result result_;
+	Napi::Promise::Deferred deferred_;
+	Napi::FunctionReference onProgress_;
+	Napi::ObjectReference callbackError_;
+	std::atomic<bool> cancelled_;
+};
+
+// importFile(path, { table, format, columns, header, conflict, batchSize,
+// skipErrors, onProgress }) -> Promise; options are validated in JS
+Napi::Value DatabaseWrapper::ImportFile(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!open_) {
+		Napi::TypeError::New(env, "The database connection is not open").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (info.Length() < 2 || !info[0].IsString() || !info[1].IsObject()) {
+		Napi::TypeError::New(env, "Expected a file path and an options object").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	// The import runs on its own connection, which needs a file to open
+	const char* database = sqlite3_db_filename(db_, "main");
+	if (!database || !database[0]) {
+		Napi::TypeError::New(env, "importFile() requires an on-disk database").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	Napi::Object opts = info[1].As<Napi::Object>();
+	BulkImporter::Options options;
+	options.database = database;
+	sqlite3_vfs* vfs = nullptr;
+	sqlite3_file_control(db_, "main", SQLITE_FCNTL_VFS_POINTER, &vfs);
+	if (vfs) options.vfs = vfs->zName;
+	options.path = info[0].As<Napi::String>().Utf8Value();
+	options.table = opts.Get("table").As<Napi::String>().Utf8Value();
+	options.format = opts.Get("format").As<Napi::String>().Utf8Value() == "csv"
+		? BulkImporter::Format::Csv
+		: BulkImporter::Format::Ndjson;
+	if (opts.Get("columns").IsArray()) {
+		Napi::Array columns = opts.Get("columns").As<Napi::Array>();
+		for (uint32_t i = 0; i < columns.Length(); i++) {
+			options.columns.push_back(columns.Get(i).As<Napi::String>().Utf8Value());
+		}
+	}
+	options.header = opts.Get("header").ToBoolean().Value();
+	options.conflict = opts.Get("conflict").As<Napi::String>().Utf8Value();
+	options.batchSize = opts.Get("batchSize").As<Napi::Number>().Int64Value();
+	options.skipErrors = opts.Get("skipErrors").ToBoolean().Value();
+	options.busyTimeout = busyTimeout_;
+	options.tokenizers = tokenizers_;
+
+	ImportWorker* worker = new ImportWorker(env, options, opts.Get("onProgress"));
+	Napi::Promise promise = worker->Promise();
+	worker->Queue();
+	return promise;
+}
+
+// pipeline(steps, transaction): runs [statement, params, mode] steps back to
+// back in one call and returns their results in order. The first failure
+// stops the pipeline and is thrown with the failing step's index; with
+// transaction set the steps share one savepoint, rolled back on failure.
+// run steps do not consult a statement's dedup filter (a miss is always safe)
+Napi::Value DatabaseWrapper::Pipeline(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!open_) {
+		Napi::TypeError::New(env, "The database connection is not open").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (info.Length() < 1 || !info[0].IsArray()) {
+		Napi::TypeError::New(env, "Expected an array of pipeline steps").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	Napi::Array steps = info[0].As<Napi::Array>();
+	bool atomic = info.Length() >= 2 && info[1].ToBoolean().Value();
+
+	struct Step {
+		StatementWrapper* stmt;
+		Napi::Value params;
+		StatementWrapper::Mode mode;
+	};
+
+	// Every step is checked before any of them runs
+	uint32_t count = steps.Length();
+	std::vector<Step> plan;
+	plan.reserve(count);
+	for (uint32_t i = 0; i < count; i++) {
+		std::string where = "pipeline step " + std::to_string(i);
+		Napi::Value entry = steps.Get(i);
+		if (!entry.IsArray()) {
+			Napi::TypeError::New(env, "Expected " + where + " to be a [statement, params, mode] array").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		Napi::Array tuple = entry.As<Napi::Array>();
+		Napi::Value target = tuple.Get(0u);
+		if (!target.IsObject() || !target.As<Napi::Object>().InstanceOf(StatementWrapper::constructor.Value())) {
+			Napi::TypeError::New(env, "Expected " + where + " to start with a prepared statement").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		StatementWrapper* stmt = StatementWrapper::Unwrap(target.As<Napi::Object>());
+		if (stmt->db_ != this) {
+			Napi::TypeError::New(env, "The statement in " + where + " belongs to a different database").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if (stmt->finalized_) {
+			Napi::TypeError::New(env, "The statement in " + where + " has been finalized").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+
+		// The mode defaults to all() for statements that return data, else run()
+		Napi::Value modeName = tuple.Get(2u);
+		StatementWrapper::Mode mode;
+		if (modeName.IsUndefined()) {
+			mode = sqlite3_column_count(stmt->stmt_) > 0 ? StatementWrapper::Mode::All : StatementWrapper::Mode::Run;
+		} else {
+			std::string name = modeName.IsString() ? modeName.As<Napi::String>().Utf8Value() : "";
+			if (name == "run") mode = StatementWrapper::Mode::Run;
+			else if (name == "get") mode = StatementWrapper::Mode::Get;
+			else if (name == "all") mode = StatementWrapper::Mode::All;
+			else if (name == "getJSON") mode = StatementWrapper::Mode::GetJSON;
+			else if (name == "allJSON") mode = StatementWrapper::Mode::AllJSON;
+			else {
+				Napi::TypeError::New(env, "Expected the mode of " + where + " to be \"run\", \"get\", \"all\", \"getJSON\" or \"allJSON\"").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
+		}
+		plan.push_back({ stmt, tuple.Get(1u), mode });
+	}
+
+	// Opened outside a transaction the savepoint is the transaction, and is
+	// undone with a plain ROLLBACK
+	bool outermost = sqlite3_get_autocommit(db_) != 0;
+	if (atomic) {
+		int rc = sqlite3_exec(db_, "SAVEPOINT \"\t_pipeline\t\"", nullptr, nullptr, nullptr);
+		if (rc != SQLITE_OK) {
+			ThrowSqliteError(env, rc);
+			return env.Undefined();
+		}
+	}
+	auto fail = [&](Napi::Error error) {
+		if (atomic) {
+			// Fails harmlessly when SQLite has already rolled the transaction back
+			sqlite3_exec(db_, outermost ? "ROLLBACK" : "ROLLBACK TO \"\t_pipeline\t\"; RELEASE \"\t_pipeline\t\"",
+				nullptr, nullptr, nullptr);
+		}
+		error.ThrowAsJavaScriptException();
+		return env.Undefined();
+	};
+
+	Napi::Array results = Napi::Array::New(env, count);
+	for (uint32_t i = 0; i < count; i++) {
+		StatementWrapper* stmt = plan[i].stmt;
+		Napi::Error error;
+		try {
+			int64_t budget = stmt->Budget();
+			if (budget < 0) {
+				ThrowSqliteError(env, SQLITE_INTERRUPT);
+			} else {
+				stmt->BindParams(env, plan[i].params);
+				if (!env.IsExceptionPending()) {
+					Napi::Value result = stmt->Execute(env, plan[i].mode, budget);
+					if (!env.IsExceptionPending()) results.Set(i, result);
+				}
+			}
+			if (!env.IsExceptionPending()) continue;
+			error = env.GetAndClearPendingException();
+		} catch (const Napi::Error& e) {
+			error = e;
+		}
+		sqlite3_reset(stmt->stmt_);
+		error.Set("index", Napi::Number::New(env, i));
+		return fail(error);
+	}
+
+	if (atomic) {
+		int rc = sqlite3_exec(db_, "RELEASE \"\t_pipeline\t\"", nullptr, nullptr, nullptr);
+		if (rc != SQLITE_OK) {
+			// A commit that cannot complete (SQLITE_BUSY) leaves nothing behind
+			ThrowSqliteError(env, rc);
+			return fail(env.GetAndClearPendingException());
+		}
+	}
+	return results;
+}
+
+// Registers the IOC tokenizer with FTS5 under the given name (default "hexioc")
+Napi::Value DatabaseWrapper::RegisterTokenizer(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!open_) {
+		Napi::TypeError::New(env, "The database connection is not open").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	std::string name = IocTokenizer::kDefaultName;
+	if (info.Length() >= 1 && !info[0].IsUndefined() && !info[0].IsNull()) {
+		if (!info[0].IsString()) {
+			Napi::TypeError::New(env, "Expected the tokenizer name to be a string").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		name = info[0].As<Napi::String>().Utf8Value();
+	}
+
+	std::string error;
+	if (IocTokenizer::Register(db_, name, error) != SQLITE_OK) {
+		Napi::Error::New(env, error).ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	// importFile()/exportTo() connections register it too
+	if (std::find(tokenizers_.begin(), tokenizers_.end(), name) == tokenizers_.end()) {
+		tokenizers_.push_back(name);
+	}
+	return info.This();
+}
+
 Napi::Value DatabaseWrapper::LoadExtension(const Napi::CallbackInfo& info) {
 	Napi::Env env = info.Env();
 	if (!open_) {
@@ -342,40 +1049,166 @@ Napi::Value DatabaseWrapper::DefaultSafeIntegers(const Napi::CallbackInfo& info)
 	return info.This();
 }
 
-// Property getters
-Napi::Value DatabaseWrapper::GetName(const Napi::CallbackInfo& info) {
-	return Napi::String::New(info.Env(), name_);
-}
-Napi::Value DatabaseWrapper::GetOpen(const Napi::CallbackInfo& info) {
-	return Napi::Boolean::New(info.Env(), open_);
-}
-Napi::Value DatabaseWrapper::GetInTransaction(const Napi::CallbackInfo& info) {
-	return Napi::Boolean::New(info.Env(), db_ ? !sqlite3_get_autocommit(db_) : false);
-}
-Napi::Value DatabaseWrapper::GetReadonly(const Napi::CallbackInfo& info) {
-	return Napi::Boolean::New(info.Env(), readonly_);
-}
-Napi::Value DatabaseWrapper::GetMemory(const Napi::CallbackInfo& info) {
-	return Napi::Boolean::New(info.Env(), memory_);
+static Napi::Array QueryPlanToJS(Napi::Env env, const std::vector<IndexAdvisor::PlanRow>& plan) {
+	Napi::Array rows = Napi::Array::New(env, plan.size());
+	for (size_t i = 0; i < plan.size(); i++) {
+		Napi::Object row = Napi::Object::New(env);
+		row.Set("id", Napi::Number::New(env, plan[i].id));
+		row.Set("parent", Napi::Number::New(env, plan[i].parent));
+		row.Set("detail", Napi::String::New(env, plan[i].detail));
+		rows.Set(static_cast<uint32_t>(i), row);
+	}
+	return rows;
 }
 
-// ============================================================================
-// StatementWrapper
-// ============================================================================
-
-Napi::FunctionReference StatementWrapper::constructor;
+static Napi::Array StringsToJS(Napi::Env env, const std::vector<std::string>& list) {
+	Napi::Array arr = Napi::Array::New(env, list.size());
+	for (size_t i = 0; i < list.size(); i++) {
+		arr.Set(static_cast<uint32_t>(i), Napi::String::New(env, list[i]));
+	}
+	return arr;
+}
+
+Napi::Value DatabaseWrapper::AdviseIndexes(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!open_) {
+		Napi::TypeError::New(env, "The database connection is not open").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Without an explicit list, advise on the statements recorded as full scans
+	std::vector<std::string> workload;
+	if (info.Length() >= 1 && info[0].IsArray()) {
+		Napi::Array list = info[0].As<Napi::Array>();
+		for (uint32_t i = 0; i < list.Length(); i++) {
+			Napi::Value sql = list.Get(i);
+			if (!sql.IsString()) {
+				Napi::TypeError::New(env, "Expected an array of SQL strings").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
+			workload.push_back(sql.As<Napi::String>().Utf8Value());
+		}
+	} else {
+		workload = workload_;
+	}
+
+	IndexAdvisor::Report report;
+	std::string error;
+	int rc = IndexAdvisor::Advise(db_, workload, report, error);
+	if (rc != SQLITE_OK) {
+		Napi::Error err = Napi::Error::New(env, error);
+		err.Set("code", Napi::String::New(env, sqlite3_errstr(rc)));
+		err.ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	Napi::Array queries = Napi::Array::New(env, report.queries.size());
+	for (size_t i = 0; i < report.queries.size(); i++) {
+		const IndexAdvisor::QueryReport& qr = report.queries[i];
+		Napi::Object q = Napi::Object::New(env);
+		q.Set("sql", Napi::String::New(env, qr.sql));
+		q.Set("indexes", StringsToJS(env, qr.indexes));
+		q.Set("before", QueryPlanToJS(env, qr.before));
+		q.Set("after", QueryPlanToJS(env, qr.after));
+		q.Set("error", qr.error.empty() ? env.Null() : Napi::String::New(env, qr.error));
+		queries.Set(static_cast<uint32_t>(i), q);
+	}
+
+	Napi::Object result = Napi::Object::New(env);
+	result.Set("indexes", StringsToJS(env, report.indexes));
+	result.Set("queries", queries);
+	return result;
+}
+
+Napi::Value DatabaseWrapper::CacheStats(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!open_) {
+		Napi::TypeError::New(env, "The database connection is not open").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Pager-level counters, summed over every attached database of this connection
+	static const struct { const char* name; int op; } counters[] = {
+		{ "hits", SQLITE_DBSTATUS_CACHE_HIT },
+		{ "misses", SQLITE_DBSTATUS_CACHE_MISS },
+		{ "writes", SQLITE_DBSTATUS_CACHE_WRITE },
+		{ "spills", SQLITE_DBSTATUS_CACHE_SPILL },
+		{ "bytes", SQLITE_DBSTATUS_CACHE_USED },
+	};
+	bool reset = info.Length() >= 1 && info[0].ToBoolean().Value();
+
+	Napi::Object result = Napi::Object::New(env);
+	for (const auto& counter : counters) {
+		int current = 0;
+		int highwater = 0;
+		sqlite3_db_status(db_, counter.op, &current, &highwater, reset && counter.op != SQLITE_DBSTATUS_CACHE_USED);
+		result.Set(counter.name, Napi::Number::New(env, current));
+	}
+	return result;
+}
+
+Napi::Value DatabaseWrapper::CheckpointStats(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!checkpointer_) return env.Null();
+
+	WalCheckpointer::Stats stats = checkpointer_->GetStats();
+	Napi::Object result = Napi::Object::New(env);
+	result.Set("checkpoints", Napi::Number::New(env, static_cast<double>(stats.checkpoints)));
+	result.Set("escalations", Napi::Number::New(env, static_cast<double>(stats.escalations)));
+	result.Set("busy", Napi::Number::New(env, static_cast<double>(stats.busy)));
+	result.Set("lastDurationNs", Napi::Number::New(env, static_cast<double>(stats.lastDurationNs)));
+	result.Set("maxDurationNs", Napi::Number::New(env, static_cast<double>(stats.maxDurationNs)));
+	result.Set("totalDurationNs", Napi::Number::New(env, static_cast<double>(stats.totalDurationNs)));
+	result.Set("walFrames", Napi::Number::New(env, stats.walFrames));
+	result.Set("backfilledFrames", Napi::Number::New(env, stats.backfilledFrames));
+	result.Set("walBytes", Napi::Number::New(env, static_cast<double>(stats.walBytes)));
+	return result;
+}
+
+// Property getters
+Napi::Value DatabaseWrapper::GetName(const Napi::CallbackInfo& info) {
+	return Napi::String::New(info.Env(), name_);
+}
+Napi::Value DatabaseWrapper::GetOpen(const Napi::CallbackInfo& info) {
+	return Napi::Boolean::New(info.Env(), open_);
+}
+Napi::Value DatabaseWrapper::GetInTransaction(const Napi::CallbackInfo& info) {
+	return Napi::Boolean::New(info.Env(), db_ ? !sqlite3_get_autocommit(db_) : false);
+}
+Napi::Value DatabaseWrapper::GetReadonly(const Napi::CallbackInfo& info) {
+	return Napi::Boolean::New(info.Env(), readonly_);
+}
+Napi::Value DatabaseWrapper::GetMemory(const Napi::CallbackInfo& info) {
+	return Napi::Boolean::New(info.Env(), memory_);
+}
+
+// ============================================================================
+// StatementWrapper
+// ============================================================================
+
+Napi::FunctionReference StatementWrapper::constructor;
 
 Napi::Object StatementWrapper::Init(Napi::Env env, Napi::Object exports) {
 	Napi::Function func = DefineClass(env, "Statement", {
 		InstanceMethod("run", &StatementWrapper::Run),
 		InstanceMethod("get", &StatementWrapper::Get),
 		InstanceMethod("all", &StatementWrapper::All),
+		InstanceMethod("getJSON", &StatementWrapper::GetJSON),
+		InstanceMethod("allJSON", &StatementWrapper::AllJSON),
+		InstanceMethod("getMany", &StatementWrapper::GetMany),
+		InstanceMethod("jsonBuffer", &StatementWrapper::JsonBuffer),
 		InstanceMethod("iterate", &StatementWrapper::Iterate),
 		InstanceMethod("columns", &StatementWrapper::Columns),
 		InstanceMethod("bind", &StatementWrapper::Bind),
 		InstanceMethod("safeIntegers", &StatementWrapper::SafeIntegers),
 		InstanceMethod("raw", &StatementWrapper::Raw),
 		InstanceMethod("expand", &StatementWrapper::Expand),
+		InstanceMethod("json", &StatementWrapper::Json),
+		InstanceMethod("profile", &StatementWrapper::Profile),
+		InstanceMethod("timeout", &StatementWrapper::Timeout),
+		InstanceMethod("dedupFilter", &StatementWrapper::SetDedupFilter),
+		InstanceMethod("dedupStats", &StatementWrapper::DedupStats),
+		InstanceMethod("exportTo", &StatementWrapper::ExportTo),
 		InstanceAccessor("source", &StatementWrapper::GetSource, nullptr),
 		InstanceAccessor("reader", &StatementWrapper::GetReader, nullptr),
 		InstanceAccessor("busy", &StatementWrapper::GetBusy, nullptr),
@@ -387,6 +1220,19 @@ Napi::Object StatementWrapper::Init(Napi::Env env, Napi::Object exports) {
 	return exports;
 }
 
+// Whether the SQL calls carray(); only then do array parameters bind as
+// pointers, so a stray array elsewhere still fails with the usual TypeError
+static bool CallsCarray(const char* sql) {
+	for (const char* p = sql; *p; p++) {
+		if (sqlite3_strnicmp(p, "carray", 6) != 0) continue;
+		if (p > sql && (isalnum(static_cast<unsigned char>(p[-1])) || p[-1] == '_')) continue;
+		const char* q = p + 6;
+		while (isspace(static_cast<unsigned char>(*q))) q++;
+		if (*q == '(') return true;
+	}
+	return false;
+}
+
 StatementWrapper::StatementWrapper(const Napi::CallbackInfo& info)
 	: Napi::ObjectWrap<StatementWrapper>(info)
 	, stmt_(nullptr)
@@ -395,6 +1241,11 @@ StatementWrapper::StatementWrapper(const Napi::CallbackInfo& info)
 	, safeIntegers_(false)
 	, rawMode_(false)
 	, expandMode_(false)
+	, jsonBuffer_(false)
+	, jsonMode_(false)
+	, carray_(false)
+	, timeout_(-1)
+	, dedup_(nullptr)
 {
 	Napi::Env env = info.Env();
 
@@ -421,6 +1272,7 @@ StatementWrapper::StatementWrapper(const Napi::CallbackInfo& info)
 		db_->ThrowSqliteError(env, rc);
 		return;
 	}
+	carray_ = CallsCarray(source_.c_str());
 
 	db_->TrackStatement(this);
 }
@@ -437,6 +1289,8 @@ void StatementWrapper::Finalize(Napi::Env /*env*/) {
 
 void StatementWrapper::FinalizeStatement() {
 	if (stmt_ && !finalized_) {
+		delete dedup_;
+		dedup_ = nullptr;
 		sqlite3_finalize(stmt_);
 		stmt_ = nullptr;
 		finalized_ = true;
@@ -447,6 +1301,79 @@ void StatementWrapper::FinalizeStatement() {
 	}
 }
 
+// Copies a JS array (numbers, bigints or strings) or a Float64Array,
+// BigInt64Array, Int32Array or Uint32Array into a carray() block
+static CArray::Values* ToCArray(Napi::Env env, Napi::Value val) {
+	std::unique_ptr<CArray::Values> values(new CArray::Values());
+	if (val.IsTypedArray()) {
+		Napi::TypedArray typed = val.As<Napi::TypedArray>();
+		switch (typed.TypedArrayType()) {
+			case napi_float64_array: {
+				Napi::Float64Array array = val.As<Napi::Float64Array>();
+				values->type = SQLITE_FLOAT;
+				values->reals.assign(array.Data(), array.Data() + array.ElementLength());
+				break;
+			}
+			case napi_bigint64_array: {
+				Napi::BigInt64Array array = val.As<Napi::BigInt64Array>();
+				values->integers.assign(array.Data(), array.Data() + array.ElementLength());
+				break;
+			}
+			case napi_int32_array: {
+				Napi::Int32Array array = val.As<Napi::Int32Array>();
+				values->integers.assign(array.Data(), array.Data() + array.ElementLength());
+				break;
+			}
+			case napi_uint32_array: {
+				Napi::Uint32Array array = val.As<Napi::Uint32Array>();
+				values->integers.assign(array.Data(), array.Data() + array.ElementLength());
+				break;
+			}
+			default:
+				Napi::TypeError::New(env, "carray() binds Float64Array, BigInt64Array, Int32Array or Uint32Array").ThrowAsJavaScriptException();
+				return nullptr;
+		}
+		return values.release();
+	}
+
+	// Numbers stay integers unless one of them is not; strings cannot mix with numbers
+	Napi::Array array = val.As<Napi::Array>();
+	uint32_t length = array.Length();
+	bool text = false;
+	bool integral = true;
+	for (uint32_t i = 0; i < length; i++) {
+		Napi::Value element = array.Get(i);
+		if (element.IsString() && (i == 0 || text)) {
+			text = true;
+			values->texts.push_back(element.As<Napi::String>().Utf8Value());
+		} else if (element.IsNumber() && !text) {
+			double d = element.As<Napi::Number>().DoubleValue();
+			if (!(d == static_cast<double>(static_cast<int64_t>(d)) && d >= -9007199254740991.0 && d <= 9007199254740991.0)) {
+				integral = false;
+			}
+			values->integers.push_back(integral ? static_cast<int64_t>(d) : 0);
+			values->reals.push_back(d);
+		} else if (element.IsBigInt() && !text) {
+			bool lossless;
+			int64_t v = element.As<Napi::BigInt>().Int64Value(&lossless);
+			values->integers.push_back(v);
+			values->reals.push_back(static_cast<double>(v));
+		} else {
+			Napi::TypeError::New(env, "carray() arrays must hold only numbers and bigints, or only strings").ThrowAsJavaScriptException();
+			return nullptr;
+		}
+	}
+	if (text) {
+		values->type = SQLITE_TEXT;
+	} else if (!integral) {
+		values->type = SQLITE_FLOAT;
+		values->integers.clear();
+	} else {
+		values->reals.clear();
+	}
+	return values.release();
+}
+
 void StatementWrapper::BindValue(Napi::Env env, int index, Napi::Value val) {
 	int rc;
 	if (val.IsNull() || val.IsUndefined()) {
@@ -468,6 +1395,16 @@ void StatementWrapper::BindValue(Napi::Env env, int index, Napi::Value val) {
 	} else if (val.IsBuffer()) {
 		Napi::Buffer<uint8_t> buf = val.As<Napi::Buffer<uint8_t>>();
 		rc = sqlite3_bind_blob(stmt_, index, buf.Data(), static_cast<int>(buf.Length()), SQLITE_TRANSIENT);
+	} else if (carray_ && (val.IsTypedArray() || (val.IsArray() && !jsonMode_))) {
+		// Arrays bind as one carray() pointer: WHERE id IN carray(?)
+		CArray::Values* values = ToCArray(env, val);
+		if (!values) return;
+		rc = CArray::Bind(stmt_, index, values);
+	} else if (jsonMode_ && val.IsObject()) {
+		// Objects and arrays are stored as JSONB
+		std::string jsonb;
+		if (!JsonCodec::ToJsonb(env, val, jsonb)) return;
+		rc = sqlite3_bind_blob64(stmt_, index, jsonb.data(), jsonb.size(), SQLITE_TRANSIENT);
 	} else {
 		Napi::TypeError::New(env, "SQLite3 can only bind numbers, strings, bigints, buffers, and null").ThrowAsJavaScriptException();
 		return;
@@ -487,17 +1424,7 @@ void StatementWrapper::BindParams(Napi::Env env, const Napi::CallbackInfo& info,
 	int argIdx = startIdx;
 	// If first arg is an object (named params) or array
 	if (static_cast<int>(info.Length()) > argIdx && info[argIdx].IsObject() && !info[argIdx].IsBuffer() && !info[argIdx].IsArray()) {
-		Napi::Object obj = info[argIdx].As<Napi::Object>();
-		for (int i = 1; i <= paramCount; i++) {
-			const char* paramName = sqlite3_bind_parameter_name(stmt_, i);
-			if (paramName) {
-				// Skip the prefix character (: @ $)
-				std::string key(paramName + 1);
-				if (obj.Has(key)) {
-					BindValue(env, i, obj.Get(key));
-				}
-			}
-		}
+		BindNamed(env, info[argIdx].As<Napi::Object>());
 	} else {
 		// Positional binding
 		for (int i = 1; i <= paramCount && argIdx < static_cast<int>(info.Length()); i++, argIdx++) {
@@ -506,6 +1433,43 @@ void StatementWrapper::BindParams(Napi::Env env, const Napi::CallbackInfo& info,
 	}
 }
 
+// Pipeline form: params is an array of positional values, an object of named
+// values, a single value, or undefined/null for none
+void StatementWrapper::BindParams(Napi::Env env, Napi::Value params) {
+	sqlite3_reset(stmt_);
+	sqlite3_clear_bindings(stmt_);
+
+	int paramCount = sqlite3_bind_parameter_count(stmt_);
+	if (paramCount == 0 || params.IsUndefined() || params.IsNull()) return;
+
+	if (params.IsArray()) {
+		Napi::Array values = params.As<Napi::Array>();
+		uint32_t length = values.Length();
+		for (uint32_t i = 0; i < length && static_cast<int>(i) < paramCount; i++) {
+			BindValue(env, static_cast<int>(i) + 1, values.Get(i));
+			if (env.IsExceptionPending()) return;
+		}
+	} else if (params.IsObject() && !params.IsBuffer() && !params.IsTypedArray()) {
+		BindNamed(env, params.As<Napi::Object>());
+	} else {
+		BindValue(env, 1, params);
+	}
+}
+
+void StatementWrapper::BindNamed(Napi::Env env, Napi::Object obj) {
+	int paramCount = sqlite3_bind_parameter_count(stmt_);
+	for (int i = 1; i <= paramCount; i++) {
+		const char* paramName = sqlite3_bind_parameter_name(stmt_, i);
+		if (paramName) {
+			// Skip the prefix character (: @ $)
+			std::string key(paramName + 1);
+			if (obj.Has(key)) {
+				BindValue(env, i, obj.Get(key));
+			}
+		}
+	}
+}
+
 Napi::Value StatementWrapper::ColumnToJS(Napi::Env env, int col) {
 	int type = sqlite3_column_type(stmt_, col);
 	switch (type) {
@@ -518,11 +1482,27 @@ Napi::Value StatementWrapper::ColumnToJS(Napi::Env env, int col) {
 		}
 		case SQLITE_FLOAT:
 			return Napi::Number::New(env, sqlite3_column_double(stmt_, col));
-		case SQLITE_TEXT:
-			return Napi::String::New(env, reinterpret_cast<const char*>(sqlite3_column_text(stmt_, col)));
+		case SQLITE_TEXT: {
+			// Length from SQLite instead of a strlen() pass over the value
+			const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, col));
+			size_t len = static_cast<size_t>(sqlite3_column_bytes(stmt_, col));
+			Napi::Value decoded;
+			if (IsJsonColumn(col) && JsonCodec::FromText(env, text, len, safeIntegers_, decoded)) {
+				return decoded;
+			}
+			return Napi::String::New(env, text, len);
+		}
 		case SQLITE_BLOB: {
+			// In mmap mode a blob that fits on one page points straight into the
+			// mapping; it is only valid until the next step, so this single copy
+			// into the Buffer is the only one made
 			const void* data = sqlite3_column_blob(stmt_, col);
 			int len = sqlite3_column_bytes(stmt_, col);
+			Napi::Value decoded;
+			if (IsJsonColumn(col) &&
+				JsonCodec::FromJsonb(env, static_cast<const uint8_t*>(data), static_cast<size_t>(len), safeIntegers_, decoded)) {
+				return decoded;
+			}
 			return Napi::Buffer<uint8_t>::Copy(env, static_cast<const uint8_t*>(data), len);
 		}
 		default:
@@ -563,6 +1543,19 @@ Napi::Array StatementWrapper::RowToArray(Napi::Env env) {
 	return arr;
 }
 
+int64_t StatementWrapper::Budget() const {
+	return db_->ExecutionBudget(timeout_ >= 0 ? timeout_ : db_->queryTimeout_);
+}
+
+void StatementWrapper::CheckFullScan(uint32_t runs) {
+	// Feeds the index advisor with statements that keep scanning whole tables;
+	// the counter covers all runs since the last check, so compare per run
+	int steps = sqlite3_stmt_status(stmt_, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+	if (db_->fullScanThreshold_ > 0 && steps / static_cast<int64_t>(runs ? runs : 1) > db_->fullScanThreshold_) {
+		db_->RecordWorkload(source_);
+	}
+}
+
 Napi::Value StatementWrapper::Run(const Napi::CallbackInfo& info) {
 	Napi::Env env = info.Env();
 	if (finalized_) {
@@ -570,29 +1563,85 @@ Napi::Value StatementWrapper::Run(const Napi::CallbackInfo& info) {
 		return env.Undefined();
 	}
 
+	int64_t budget = Budget();
+	if (budget < 0) {
+		db_->ThrowSqliteError(env, SQLITE_INTERRUPT);
+		return env.Undefined();
+	}
+
+	// Known duplicates are answered from the filter before the row is bound
+	DedupFilter::Key dedupKey;
+	bool keyed = dedup_ && DedupKey(info, dedupKey);
+	if (keyed && dedup_->IsDuplicate(dedupKey)) {
+		return RunResult(env, 0);
+	}
+
 	BindParams(env, info);
 	if (env.IsExceptionPending()) return env.Undefined();
 
-	int rc = sqlite3_step(stmt_);
-	if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
-		sqlite3_reset(stmt_);
-		db_->ThrowSqliteError(env, rc);
-		return env.Undefined();
-	}
+	Napi::Value result = Execute(env, Mode::Run, budget);
+	if (keyed && !env.IsExceptionPending()) dedup_->Add(dedupKey);
+	return result;
+}
 
+Napi::Object StatementWrapper::RunResult(Napi::Env env, int changes) {
 	Napi::Object result = Napi::Object::New(env);
-	result.Set("changes", Napi::Number::New(env, static_cast<double>(sqlite3_changes(db_->GetHandle()))));
+	result.Set("changes", Napi::Number::New(env, changes));
 	int64_t lastId = sqlite3_last_insert_rowid(db_->GetHandle());
 	if (safeIntegers_) {
 		result.Set("lastInsertRowid", Napi::BigInt::New(env, lastId));
 	} else {
 		result.Set("lastInsertRowid", Napi::Number::New(env, static_cast<double>(lastId)));
 	}
-
-	sqlite3_reset(stmt_);
 	return result;
 }
 
+// Reads the key columns from run()'s arguments the way BindParams would bind
+// them; false (no filtering) for values the filter does not model
+bool StatementWrapper::DedupKey(const Napi::CallbackInfo& info, DedupFilter::Key& key) {
+	bool named = info.Length() >= 1 && info[0].IsObject() && !info[0].IsBuffer() && !info[0].IsArray();
+	key.resize(dedupParams_.size());
+	for (size_t i = 0; i < dedupParams_.size(); i++) {
+		int index = dedupParams_[i];
+		Napi::Value val;
+		if (named) {
+			const char* name = sqlite3_bind_parameter_name(stmt_, index);
+			if (!name) return false;
+			val = info[0].As<Napi::Object>().Get(name + 1);
+		} else {
+			if (static_cast<size_t>(index) > info.Length()) return false;
+			val = info[index - 1];
+		}
+
+		DedupFilter::Value& value = key[i];
+		value.bytes.clear();
+		if (val.IsString()) {
+			value.type = SQLITE_TEXT;
+			value.bytes = val.As<Napi::String>().Utf8Value();
+		} else if (val.IsNumber()) {
+			double d = val.As<Napi::Number>().DoubleValue();
+			if (d == static_cast<double>(static_cast<int64_t>(d)) && d >= -9007199254740991.0 && d <= 9007199254740991.0) {
+				value.type = SQLITE_INTEGER;
+				value.integer = static_cast<int64_t>(d);
+			} else {
+				value.type = SQLITE_FLOAT;
+				value.real = d;
+			}
+		} else if (val.IsBigInt()) {
+			bool lossless;
+			value.type = SQLITE_INTEGER;
+			value.integer = val.As<Napi::BigInt>().Int64Value(&lossless);
+		} else if (val.IsBuffer()) {
+			Napi::Buffer<uint8_t> buf = val.As<Napi::Buffer<uint8_t>>();
+			value.type = SQLITE_BLOB;
+			value.bytes.assign(reinterpret_cast<const char*>(buf.Data()), buf.Length());
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
 Napi::Value StatementWrapper::Get(const Napi::CallbackInfo& info) {
 	Napi::Env env = info.Env();
 	if (finalized_) {
@@ -600,55 +1649,327 @@ Napi::Value StatementWrapper::Get(const Napi::CallbackInfo& info) {
 		return env.Undefined();
 	}
 
+	int64_t budget = Budget();
+	if (budget < 0) {
+		db_->ThrowSqliteError(env, SQLITE_INTERRUPT);
+		return env.Undefined();
+	}
+
 	BindParams(env, info);
 	if (env.IsExceptionPending()) return env.Undefined();
+	return Execute(env, Mode::Get, budget);
+}
 
-	int rc = sqlite3_step(stmt_);
-	if (rc == SQLITE_ROW) {
-		Napi::Value result = rawMode_
-			? static_cast<Napi::Value>(RowToArray(env))
-			: static_cast<Napi::Value>(RowToObject(env));
-		sqlite3_reset(stmt_);
-		return result;
+Napi::Value StatementWrapper::All(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (finalized_) {
+		Napi::TypeError::New(env, "This statement has been finalized").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	int64_t budget = Budget();
+	if (budget < 0) {
+		db_->ThrowSqliteError(env, SQLITE_INTERRUPT);
+		return env.Undefined();
+	}
+
+	BindParams(env, info);
+	if (env.IsExceptionPending()) return env.Undefined();
+	return Execute(env, Mode::All, budget);
+}
+
+/**
+ * JsonShape - per-call layout of a JSON row: the escaped "name": prefix of
+ * every column and, in expand mode, the columns grouped under their tables
+ */
+struct JsonShape {
+	std::vector<std::string> keys;
+	std::vector<std::string> tables;        // "table":{ prefixes (expand mode)
+	std::vector<std::vector<int>> groups;   // column indices per table
+};
+
+static void BuildJsonShape(sqlite3_stmt* stmt, bool expand, JsonShape& shape) {
+	int cols = sqlite3_column_count(stmt);
+	shape.keys.resize(cols);
+	for (int c = 0; c < cols; c++) {
+		const char* name = sqlite3_column_name(stmt, c);
+		std::string& key = shape.keys[c];
+		JsonWriter::AppendString(key, name ? name : "", name ? strlen(name) : 0);
+		key += ':';
+
+		// Same grouping as RowToObject(): first appearance order, "$" for expressions
+		std::string table;
+		if (expand) {
+			const char* tableName = sqlite3_column_table_name(stmt, c);
+			JsonWriter::AppendString(table, tableName ? tableName : "$", tableName ? strlen(tableName) : 1);
+			table += ":{";
+		}
+		size_t group = 0;
+		while (group < shape.tables.size() && shape.tables[group] != table) group++;
+		if (group == shape.tables.size()) {
+			shape.tables.push_back(table);
+			shape.groups.emplace_back();
+		}
+		shape.groups[group].push_back(c);
+	}
+}
+
+static void AppendJsonRow(std::string& out, sqlite3_stmt* stmt, const JsonShape& shape, bool raw) {
+	if (raw) {
+		out += '[';
+		for (size_t c = 0; c < shape.keys.size(); c++) {
+			if (c) out += ',';
+			JsonWriter::AppendColumn(out, stmt, static_cast<int>(c));
+		}
+		out += ']';
+		return;
+	}
+	out += '{';
+	for (size_t g = 0; g < shape.groups.size(); g++) {
+		if (g) out += ',';
+		out += shape.tables[g];
+		bool first = true;
+		for (int c : shape.groups[g]) {
+			if (!first) out += ',';
+			first = false;
+			out += shape.keys[c];
+			JsonWriter::AppendColumn(out, stmt, c);
+		}
+		if (!shape.tables[g].empty()) out += '}';
+	}
+	out += '}';
+}
+
+// Both forms copy: a string is decoded into V8, and Buffers are not created
+// over external memory, which the V8 sandbox (Electron) rejects
+Napi::Value StatementWrapper::JsonResult(Napi::Env env, const std::string& json) {
+	if (jsonBuffer_) {
+		return Napi::Buffer<char>::Copy(env, json.data(), json.size());
+	}
+	return Napi::String::New(env, json);
+}
+
+// Steps the bound statement to completion in the given mode. Shared by the
+// JS entry points and DatabaseWrapper::Pipeline(); on failure a JS exception
+// is pending and undefined is returned
+Napi::Value StatementWrapper::Execute(Napi::Env env, Mode mode, int64_t budget) {
+	ScopedDeadline deadline(db_->GetHandle(), budget);
+
+	Napi::Value result = env.Undefined();
+	int rc;
+	switch (mode) {
+		case Mode::Run:
+			rc = sqlite3_step(stmt_);
+			if (rc == SQLITE_ROW) rc = SQLITE_DONE;
+			if (rc == SQLITE_DONE) result = RunResult(env, sqlite3_changes(db_->GetHandle()));
+			break;
+		case Mode::Get:
+			rc = sqlite3_step(stmt_);
+			if (rc == SQLITE_ROW) {
+				result = rawMode_
+					? static_cast<Napi::Value>(RowToArray(env))
+					: static_cast<Napi::Value>(RowToObject(env));
+				rc = SQLITE_DONE;
+			}
+			break;
+		case Mode::All: {
+			Napi::Array rows = Napi::Array::New(env);
+			uint32_t idx = 0;
+			while ((rc = sqlite3_step(stmt_)) == SQLITE_ROW) {
+				if (rawMode_) {
+					rows.Set(idx++, RowToArray(env));
+				} else {
+					rows.Set(idx++, RowToObject(env));
+				}
+			}
+			result = rows;
+			break;
+		}
+		case Mode::GetJSON:
+			rc = sqlite3_step(stmt_);
+			if (rc == SQLITE_ROW) {
+				JsonShape shape;
+				BuildJsonShape(stmt_, expandMode_ && !rawMode_, shape);
+				std::string json;
+				AppendJsonRow(json, stmt_, shape, rawMode_);
+				result = JsonResult(env, json);
+				rc = SQLITE_DONE;
+			}
+			break;
+		case Mode::AllJSON: {
+			JsonShape shape;
+			BuildJsonShape(stmt_, expandMode_ && !rawMode_, shape);
+			std::string json(1, '[');
+			while ((rc = sqlite3_step(stmt_)) == SQLITE_ROW) {
+				if (json.size() > 1) json += ',';
+				AppendJsonRow(json, stmt_, shape, rawMode_);
+			}
+			json += ']';
+			if (rc == SQLITE_DONE) result = JsonResult(env, json);
+			break;
+		}
 	}
 
 	sqlite3_reset(stmt_);
-	if (rc == SQLITE_DONE) {
+	if (rc != SQLITE_DONE) {
+		db_->ThrowSqliteError(env, rc);
 		return env.Undefined();
 	}
 
-	db_->ThrowSqliteError(env, rc);
-	return env.Undefined();
+	CheckFullScan();
+	return result;
 }
 
-Napi::Value StatementWrapper::All(const Napi::CallbackInfo& info) {
+// getJSON(...params): the first row serialized natively, or undefined
+Napi::Value StatementWrapper::GetJSON(const Napi::CallbackInfo& info) {
 	Napi::Env env = info.Env();
 	if (finalized_) {
 		Napi::TypeError::New(env, "This statement has been finalized").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
 
+	int64_t budget = Budget();
+	if (budget < 0) {
+		db_->ThrowSqliteError(env, SQLITE_INTERRUPT);
+		return env.Undefined();
+	}
+
 	BindParams(env, info);
 	if (env.IsExceptionPending()) return env.Undefined();
+	return Execute(env, Mode::GetJSON, budget);
+}
 
-	Napi::Array rows = Napi::Array::New(env);
-	uint32_t idx = 0;
-	int rc;
-	while ((rc = sqlite3_step(stmt_)) == SQLITE_ROW) {
-		if (rawMode_) {
-			rows.Set(idx++, RowToArray(env));
-		} else {
-			rows.Set(idx++, RowToObject(env));
+// allJSON(...params): every row as one JSON array text, without building
+// row objects
+Napi::Value StatementWrapper::AllJSON(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (finalized_) {
+		Napi::TypeError::New(env, "This statement has been finalized").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	int64_t budget = Budget();
+	if (budget < 0) {
+		db_->ThrowSqliteError(env, SQLITE_INTERRUPT);
+		return env.Undefined();
+	}
+
+	BindParams(env, info);
+	if (env.IsExceptionPending()) return env.Undefined();
+	return Execute(env, Mode::AllJSON, budget);
+}
+
+// getMany(keys, { mode }): get() for every element of keys (a single value,
+// an array of positional values or an object of named ones) in one call.
+// "row" (default) and "pluck" return an array aligned with keys holding the
+// row or its first column, undefined where nothing matched; "exists" returns
+// a Uint8Array of 1/0 flags without converting any column
+Napi::Value StatementWrapper::GetMany(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (finalized_) {
+		Napi::TypeError::New(env, "This statement has been finalized").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (info.Length() < 1 || !info[0].IsArray() ||
+		(info.Length() >= 2 && !info[1].IsUndefined() && !info[1].IsObject())) {
+		Napi::TypeError::New(env, "Expected an array of parameters and an optional options object").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	int cols = sqlite3_column_count(stmt_);
+	if (cols == 0) {
+		Napi::TypeError::New(env, "getMany() only works with statements that return data").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	enum class Lookup { Row, Pluck, Exists } lookup = Lookup::Row;
+	if (info.Length() >= 2 && info[1].IsObject()) {
+		Napi::Value mode = info[1].As<Napi::Object>().Get("mode");
+		if (!mode.IsUndefined()) {
+			std::string name = mode.IsString() ? mode.As<Napi::String>().Utf8Value() : "";
+			if (name == "row") lookup = Lookup::Row;
+			else if (name == "pluck") lookup = Lookup::Pluck;
+			else if (name == "exists") lookup = Lookup::Exists;
+			else {
+				Napi::TypeError::New(env, "Expected the \"mode\" option to be \"row\", \"pluck\" or \"exists\"").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
 		}
 	}
 
-	sqlite3_reset(stmt_);
-	if (rc != SQLITE_DONE) {
-		db_->ThrowSqliteError(env, rc);
+	int64_t budget = Budget();
+	if (budget < 0) {
+		db_->ThrowSqliteError(env, SQLITE_INTERRUPT);
 		return env.Undefined();
 	}
 
-	return rows;
+	Napi::Array keys = info[0].As<Napi::Array>();
+	uint32_t count = keys.Length();
+	Napi::Uint8Array found;
+	Napi::Array results;
+	if (lookup == Lookup::Exists) {
+		found = Napi::Uint8Array::New(env, count);
+	} else {
+		results = Napi::Array::New(env, count);
+	}
+
+	// Property keys of plain row objects are created once for the batch
+	std::vector<Napi::String> names;
+	if (lookup == Lookup::Row && !rawMode_ && !expandMode_) {
+		names.reserve(cols);
+		for (int c = 0; c < cols; c++) {
+			names.push_back(Napi::String::New(env, sqlite3_column_name(stmt_, c)));
+		}
+	}
+
+	// Failures are thrown with the index of the key that caused them
+	auto fail = [&](uint32_t index) {
+		Napi::Error error = env.GetAndClearPendingException();
+		error.Set("index", Napi::Number::New(env, index));
+		error.ThrowAsJavaScriptException();
+		return env.Undefined();
+	};
+
+	ScopedDeadline deadline(db_->GetHandle(), budget);
+	for (uint32_t i = 0; i < count; i++) {
+		BindParams(env, keys.Get(i));
+		if (env.IsExceptionPending()) return fail(i);
+
+		int rc = sqlite3_step(stmt_);
+		if (rc == SQLITE_ROW) {
+			switch (lookup) {
+				case Lookup::Exists:
+					found.Data()[i] = 1;
+					break;
+				case Lookup::Pluck:
+					results.Set(i, ColumnToJS(env, 0));
+					break;
+				case Lookup::Row:
+					if (!names.empty()) {
+						Napi::Object row = Napi::Object::New(env);
+						for (int c = 0; c < cols; c++) {
+							row.Set(names[c], ColumnToJS(env, c));
+						}
+						results.Set(i, row);
+					} else if (rawMode_) {
+						results.Set(i, RowToArray(env));
+					} else {
+						results.Set(i, RowToObject(env));
+					}
+					break;
+			}
+		} else if (rc == SQLITE_DONE) {
+			if (lookup != Lookup::Exists) results.Set(i, env.Undefined());
+		} else {
+			sqlite3_reset(stmt_);
+			db_->ThrowSqliteError(env, rc);
+			return fail(i);
+		}
+	}
+
+	sqlite3_reset(stmt_);
+	CheckFullScan(count);
+	if (lookup == Lookup::Exists) return found;
+	return results;
 }
 
 Napi::Value StatementWrapper::Iterate(const Napi::CallbackInfo& info) {
@@ -701,33 +2022,890 @@ Napi::Value StatementWrapper::SafeIntegers(const Napi::CallbackInfo& info) {
 	return info.This();
 }
 
-Napi::Value StatementWrapper::Raw(const Napi::CallbackInfo& info) {
+// jsonBuffer(toggle = true): allJSON()/getJSON() return UTF-8 Buffers
+Napi::Value StatementWrapper::JsonBuffer(const Napi::CallbackInfo& info) {
 	if (info.Length() >= 1 && info[0].IsBoolean()) {
-		rawMode_ = info[0].As<Napi::Boolean>().Value();
+		jsonBuffer_ = info[0].As<Napi::Boolean>().Value();
 	} else {
-		rawMode_ = true;
+		jsonBuffer_ = true;
 	}
 	return info.This();
 }
 
-Napi::Value StatementWrapper::Expand(const Napi::CallbackInfo& info) {
-	if (info.Length() >= 1 && info[0].IsBoolean()) {
-		expandMode_ = info[0].As<Napi::Boolean>().Value();
+// timeout(ms) sets this statement's deadline; timeout(null) inherits queryTimeout
+Napi::Value StatementWrapper::Timeout(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (info.Length() < 1 || info[0].IsNull() || info[0].IsUndefined()) {
+		timeout_ = -1;
+	} else if (info[0].IsNumber() && info[0].As<Napi::Number>().DoubleValue() >= 0) {
+		timeout_ = info[0].As<Napi::Number>().Int64Value();
 	} else {
-		expandMode_ = true;
+		Napi::TypeError::New(env, "Expected a non-negative timeout in milliseconds or null").ThrowAsJavaScriptException();
+		return env.Undefined();
 	}
 	return info.This();
 }
 
-// Property getters
-Napi::Value StatementWrapper::GetSource(const Napi::CallbackInfo& info) {
-	return Napi::String::New(info.Env(), source_);
-}
-Napi::Value StatementWrapper::GetReader(const Napi::CallbackInfo& info) {
-	if (!stmt_) return Napi::Boolean::New(info.Env(), false);
-	return Napi::Boolean::New(info.Env(), sqlite3_column_count(stmt_) > 0);
+// dedupFilter({ columns, table?, params?, bits?, hashes? }) attaches a filter
+// over the UNIQUE key columns; dedupFilter(null) detaches it
+Napi::Value StatementWrapper::SetDedupFilter(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (finalized_) {
+		Napi::TypeError::New(env, "This statement has been finalized").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (info.Length() < 1 || info[0].IsNull() || info[0].IsUndefined()) {
+		delete dedup_;
+		dedup_ = nullptr;
+		dedupParams_.clear();
+		return info.This();
+	}
+	if (!info[0].IsObject()) {
+		Napi::TypeError::New(env, "Expected an options object or null").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	// Skipping a duplicate is only invisible where SQLite would ignore it too
+	if (sqlite3_stmt_readonly(stmt_) || !DedupFilter::IgnoresConflicts(source_)) {
+		Napi::TypeError::New(env, "dedupFilter() is only available on INSERT OR IGNORE (or ON CONFLICT DO NOTHING) statements").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	Napi::Object options = info[0].As<Napi::Object>();
+	Napi::Value columnsVal = options.Get("columns");
+	if (!columnsVal.IsArray() || columnsVal.As<Napi::Array>().Length() == 0) {
+		Napi::TypeError::New(env, "Expected the \"columns\" option to be a non-empty array of column names").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	Napi::Array columnsArr = columnsVal.As<Napi::Array>();
+	std::vector<std::string> columns;
+	for (uint32_t i = 0; i < columnsArr.Length(); i++) {
+		Napi::Value column = columnsArr.Get(i);
+		if (!column.IsString()) {
+			Napi::TypeError::New(env, "Expected every column name to be a string").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		columns.push_back(column.As<Napi::String>().Utf8Value());
+	}
+
+	uint64_t bits = 0;
+	int hashes = 7;
+	if (options.Has("bits") && !options.Get("bits").IsUndefined()) {
+		Napi::Value bitsVal = options.Get("bits");
+		if (!bitsVal.IsNumber() || bitsVal.As<Napi::Number>().DoubleValue() < 64 || bitsVal.As<Napi::Number>().DoubleValue() > 68719476736.0) {
+			Napi::RangeError::New(env, "Expected the \"bits\" option to be between 64 and 2^36").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		bits = static_cast<uint64_t>(bitsVal.As<Napi::Number>().Int64Value());
+	}
+	if (options.Has("hashes") && !options.Get("hashes").IsUndefined()) {
+		Napi::Value hashesVal = options.Get("hashes");
+		if (!hashesVal.IsNumber() || hashesVal.As<Napi::Number>().Int32Value() < 1 || hashesVal.As<Napi::Number>().Int32Value() > 16) {
+			Napi::RangeError::New(env, "Expected the \"hashes\" option to be between 1 and 16").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		hashes = hashesVal.As<Napi::Number>().Int32Value();
+	}
+
+	// Table and parameter positions default to the INSERT's own column list
+	std::string table;
+	std::vector<std::string> insertColumns;
+	bool parsed = DedupFilter::ParseInsert(source_, table, insertColumns);
+	if (options.Has("table") && options.Get("table").IsString()) {
+		table = options.Get("table").As<Napi::String>().Utf8Value();
+	} else if (!parsed) {
+		Napi::TypeError::New(env, "Cannot determine the target table; pass the \"table\" option").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	Napi::Value paramsVal = options.Get("params");
+	if (!paramsVal.IsUndefined() && (!paramsVal.IsArray() || paramsVal.As<Napi::Array>().Length() != columns.size())) {
+		Napi::TypeError::New(env, "Expected the \"params\" option to be an array matching \"columns\"").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (!DedupFilter::IsUniqueKey(db_->GetHandle(), table, columns)) {
+		Napi::TypeError::New(env, "The \"columns\" option must match a UNIQUE index or the PRIMARY KEY of \"" + table + "\" exactly").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	int paramCount = sqlite3_bind_parameter_count(stmt_);
+	std::vector<int> params;
+	for (size_t i = 0; i < columns.size(); i++) {
+		int index = 0;
+		Napi::Value param = paramsVal.IsArray() ? paramsVal.As<Napi::Array>().Get(static_cast<uint32_t>(i)) : env.Undefined();
+		if (param.IsNumber()) {
+			index = param.As<Napi::Number>().Int32Value() + 1;
+		} else {
+			std::string name = param.IsString() ? param.As<Napi::String>().Utf8Value() : columns[i];
+			for (const char* prefix : { ":", "@", "$" }) {
+				if (!index) index = sqlite3_bind_parameter_index(stmt_, (prefix + name).c_str());
+			}
+			if (!index && !param.IsString()) {
+				for (size_t c = 0; c < insertColumns.size(); c++) {
+					if (sqlite3_stricmp(insertColumns[c].c_str(), columns[i].c_str()) == 0) index = static_cast<int>(c) + 1;
+				}
+			}
+		}
+		if (index < 1 || index > paramCount) {
+			Napi::TypeError::New(env, "Cannot map column \"" + columns[i] + "\" to a parameter; pass the \"params\" option").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		params.push_back(index);
+	}
+
+	std::string error;
+	DedupFilter* filter = DedupFilter::Create(db_->GetHandle(), table, columns, bits, hashes, error);
+	if (!filter) {
+		Napi::Error::New(env, error).ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	delete dedup_;
+	dedup_ = filter;
+	dedupParams_ = params;
+	return info.This();
+}
+
+Napi::Value StatementWrapper::DedupStats(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!dedup_) return env.Null();
+
+	DedupFilter::Stats stats = dedup_->GetStats();
+	Napi::Object result = Napi::Object::New(env);
+	result.Set("keys", Napi::Number::New(env, static_cast<double>(stats.keys)));
+	result.Set("bits", Napi::Number::New(env, static_cast<double>(stats.bits)));
+	result.Set("hashes", Napi::Number::New(env, stats.hashes));
+	result.Set("probes", Napi::Number::New(env, static_cast<double>(stats.probes)));
+	result.Set("rejected", Napi::Number::New(env, static_cast<double>(stats.rejected)));
+	result.Set("falsePositives", Napi::Number::New(env, static_cast<double>(stats.falsePositives)));
+	return result;
+}
+
+/**
+ * ExportWorker - runs QueryExporter on the libuv thread pool and settles a
+ * promise with { rows, bytes }
+ */
+class ExportWorker : public Napi::AsyncWorker {
+public:
+	ExportWorker(Napi::Env env, const QueryExporter::Options& options)
+		: Napi::AsyncWorker(env)
+		, options_(options)
+		, deferred_(Napi::Promise::Deferred::New(env))
+	{}
+
+	Napi::Promise Promise() const { return deferred_.Promise(); }
+
+protected:
+	void Execute() override {
+		QueryExporter::Run(options_, result_);
+	}
+
+	void OnOK() override {
+		Napi::Env env = Env();
+		if (result_.failed) {
+			Napi::Error error = Napi::Error::New(env, result_.error);
+			error.Set("code", Napi::String::New(env, ErrorCode(result_.code)));
+			error.Set("rows", Napi::Number::New(env, static_cast<double>(result_.rows)));
+			deferred_.Reject(error.Value());
+			return;
+		}
+		Napi::Object out = Napi::Object::New(env);
+		out.Set("rows", Napi::Number::New(env, static_cast<double>(result_.rows)));
+		out.Set("bytes", Napi::Number::New(env, static_cast<double>(result_.bytes)));
+		deferred_.Resolve(out);
+	}
+
+	void OnError(const Napi::Error& e) override {
+		deferred_.Reject(e.Value());
+	}
+
+private:
+	QueryExporter::Options options_;
+	QueryExporter::Result result_;
+	Napi::Promise::Deferred deferred_;
+};
+
+// Copies one bound value for the worker thread; same rules as BindValue()
+static bool CaptureParam(Napi::Env env, int index, Napi::Value val, std::vector<QueryExporter::Param>& params) {
+	QueryExporter::Param param{ index, SQLITE_NULL, 0, 0, std::string() };
+	if (val.IsNull() || val.IsUndefined()) {
+		param.type = SQLITE_NULL;
+	} else if (val.IsNumber()) {
+		double d = val.As<Napi::Number>().DoubleValue();
+		if (d == static_cast<double>(static_cast<int64_t>(d)) && d >= -9007199254740991.0 && d <= 9007199254740991.0) {
+			param.type = SQLITE_INTEGER;
+			param.integer = static_cast<int64_t>(d);
+		} else {
+			param.type = SQLITE_FLOAT;
+			param.real = d;
+		}
+	} else if (val.IsString()) {
+		param.type = SQLITE_TEXT;
+		param.bytes = val.As<Napi::String>().Utf8Value();
+	} else if (val.IsBigInt()) {
+		bool lossless;
+		param.type = SQLITE_INTEGER;
+		param.integer = val.As<Napi::BigInt>().Int64Value(&lossless);
+	} else if (val.IsBuffer()) {
+		Napi::Buffer<uint8_t> buf = val.As<Napi::Buffer<uint8_t>>();
+		param.type = SQLITE_BLOB;
+		param.bytes.assign(reinterpret_cast<const char*>(buf.Data()), buf.Length());
+	} else {
+		Napi::TypeError::New(env, "SQLite3 can only bind numbers, strings, bigints, buffers, and null").ThrowAsJavaScriptException();
+		return false;
+	}
+	params.push_back(std::move(param));
+	return true;
+}
+
+// exportTo(pathOrFd, { format, header, params }) -> Promise<{ rows, bytes }>;
+// the query runs on a read-only connection of its own, off the JS thread
+Napi::Value StatementWrapper::ExportTo(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (finalized_) {
+		Napi::TypeError::New(env, "This statement has been finalized").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (info.Length() < 1 || !(info[0].IsString() || info[0].IsNumber()) ||
+		(info.Length() >= 2 && !info[1].IsUndefined() && !info[1].IsObject())) {
+		Napi::TypeError::New(env, "Expected a file path or descriptor and an optional options object").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (!sqlite3_stmt_readonly(stmt_) || sqlite3_column_count(stmt_) == 0) {
+		Napi::TypeError::New(env, "exportTo() only works with read-only statements that return data").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	const char* database = sqlite3_db_filename(db_->GetHandle(), "main");
+	if (!database || !database[0]) {
+		Napi::TypeError::New(env, "exportTo() requires an on-disk database").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	int64_t budget = Budget();
+	if (budget < 0) {
+		db_->ThrowSqliteError(env, SQLITE_INTERRUPT);
+		return env.Undefined();
+	}
+
+	QueryExporter::Options options;
+	options.database = database;
+	sqlite3_vfs* vfs = nullptr;
+	sqlite3_file_control(db_->GetHandle(), "main", SQLITE_FCNTL_VFS_POINTER, &vfs);
+	if (vfs) options.vfs = vfs->zName;
+	options.sql = source_;
+	options.fd = -1;
+	if (info[0].IsNumber()) {
+		double fd = info[0].As<Napi::Number>().DoubleValue();
+		if (fd < 0 || fd > INT32_MAX || fd != static_cast<double>(static_cast<int>(fd))) {
+			Napi::TypeError::New(env, "Expected a valid file descriptor").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		options.fd = static_cast<int>(fd);
+	} else {
+		options.path = info[0].As<Napi::String>().Utf8Value();
+	}
+	options.busyTimeout = db_->busyTimeout_;
+	options.tokenizers = db_->tokenizers_;
+	options.timeout = budget;
+
+	Napi::Object opts = info.Length() >= 2 && info[1].IsObject() ? info[1].As<Napi::Object>() : Napi::Object::New(env);
+	// Default format follows the file extension
+	std::string format = options.path.size() >= 4 && sqlite3_stricmp(options.path.c_str() + options.path.size() - 4, ".csv") == 0
+		? "csv"
+		: "ndjson";
+	if (opts.Has("format") && !opts.Get("format").IsUndefined()) {
+		format = opts.Get("format").IsString() ? opts.Get("format").As<Napi::String>().Utf8Value() : std::string();
+		if (format != "ndjson" && format != "csv") {
+			Napi::TypeError::New(env, "Expected the \"format\" option to be \"ndjson\" or \"csv\"").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+	}
+	options.format = format == "csv" ? QueryExporter::Format::Csv : QueryExporter::Format::Ndjson;
+	options.header = true;
+	if (opts.Has("header") && !opts.Get("header").IsUndefined()) {
+		if (!opts.Get("header").IsBoolean()) {
+			Napi::TypeError::New(env, "Expected the \"header\" option to be a boolean").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		options.header = opts.Get("header").As<Napi::Boolean>().Value();
+	}
+
+	// Parameters are copied now; the worker binds them to its own statement
+	Napi::Value params = opts.Get("params");
+	int paramCount = sqlite3_bind_parameter_count(stmt_);
+	if (params.IsArray()) {
+		Napi::Array values = params.As<Napi::Array>();
+		for (uint32_t i = 0; i < values.Length() && static_cast<int>(i) < paramCount; i++) {
+			if (!CaptureParam(env, static_cast<int>(i) + 1, values.Get(i), options.params)) return env.Undefined();
+		}
+	} else if (params.IsObject() && !params.IsBuffer()) {
+		Napi::Object values = params.As<Napi::Object>();
+		for (int i = 1; i <= paramCount; i++) {
+			const char* paramName = sqlite3_bind_parameter_name(stmt_, i);
+			// Skip the prefix character (: @ $)
+			if (paramName && values.Has(paramName + 1)) {
+				if (!CaptureParam(env, i, values.Get(paramName + 1), options.params)) return env.Undefined();
+			}
+		}
+	} else if (!params.IsUndefined() && !params.IsNull()) {
+		Napi::TypeError::New(env, "Expected the \"params\" option to be an array or an object").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	ExportWorker* worker = new ExportWorker(env, options);
+	Napi::Promise promise = worker->Promise();
+	worker->Queue();
+	return promise;
+}
+
+Napi::Value StatementWrapper::Raw(const Napi::CallbackInfo& info) {
+	if (info.Length() >= 1 && info[0].IsBoolean()) {
+		rawMode_ = info[0].As<Napi::Boolean>().Value();
+	} else {
+		rawMode_ = true;
+	}
+	return info.This();
+}
+
+Napi::Value StatementWrapper::Expand(const Napi::CallbackInfo& info) {
+	if (info.Length() >= 1 && info[0].IsBoolean()) {
+		expandMode_ = info[0].As<Napi::Boolean>().Value();
+	} else {
+		expandMode_ = true;
+	}
+	return info.This();
+}
+
+// json(toggle = true) decodes columns declared JSON or JSONB into JS values
+// and binds objects and arrays as JSONB; json([names]) picks the decoded
+// columns by name instead (e.g. json_extract() results, which have no type)
+Napi::Value StatementWrapper::Json(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (finalized_) {
+		Napi::TypeError::New(env, "This statement has been finalized").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (info.Length() >= 1 && info[0].IsBoolean() && !info[0].As<Napi::Boolean>().Value()) {
+		jsonMode_ = false;
+		jsonColumns_.clear();
+		return info.This();
+	}
+
+	int cols = sqlite3_column_count(stmt_);
+	std::vector<bool> columns(cols, false);
+	if (info.Length() >= 1 && info[0].IsArray()) {
+		Napi::Array names = info[0].As<Napi::Array>();
+		for (uint32_t i = 0; i < names.Length(); i++) {
+			Napi::Value name = names.Get(i);
+			if (!name.IsString()) {
+				Napi::TypeError::New(env, "Expected an array of column names").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
+			std::string wanted = name.As<Napi::String>().Utf8Value();
+			bool found = false;
+			for (int c = 0; c < cols; c++) {
+				const char* colName = sqlite3_column_name(stmt_, c);
+				if (colName && wanted == colName) columns[c] = found = true;
+			}
+			if (!found) {
+				Napi::TypeError::New(env, "No result column named \"" + wanted + "\"").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
+		}
+	} else if (info.Length() >= 1 && !info[0].IsBoolean() && !info[0].IsUndefined()) {
+		Napi::TypeError::New(env, "Expected a boolean or an array of column names").ThrowAsJavaScriptException();
+		return env.Undefined();
+	} else {
+		for (int c = 0; c < cols; c++) {
+			const char* declType = sqlite3_column_decltype(stmt_, c);
+			columns[c] = declType && (sqlite3_stricmp(declType, "JSON") == 0 || sqlite3_stricmp(declType, "JSONB") == 0);
+		}
+	}
+	jsonMode_ = true;
+	jsonColumns_ = columns;
+	return info.This();
+}
+
+static Napi::Value ScanStatusInt(Napi::Env env, sqlite3_stmt* stmt, int idx, int op) {
+	sqlite3_int64 v = -1;
+	sqlite3_stmt_scanstatus_v2(stmt, idx, op, SQLITE_SCANSTAT_COMPLEX, &v);
+	return v < 0 ? env.Null() : Napi::Number::New(env, static_cast<double>(v));
+}
+
+Napi::Value StatementWrapper::Profile(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (finalized_) {
+		Napi::TypeError::New(env, "This statement has been finalized").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	int64_t budget = Budget();
+	if (budget < 0) {
+		db_->ThrowSqliteError(env, SQLITE_INTERRUPT);
+		return env.Undefined();
+	}
+
+	// Counters are only collected for statements prepared and stepped with the
+	// flag set, so profile a private copy rather than the hot statement.
+	sqlite3* db = db_->GetHandle();
+	sqlite3_stmt* profiled = nullptr;
+	sqlite3_db_config(db, SQLITE_DBCONFIG_STMT_SCANSTATUS, 1, nullptr);
+	int rc = sqlite3_prepare_v2(db, source_.c_str(), -1, &profiled, nullptr);
+	if (rc != SQLITE_OK) {
+		sqlite3_db_config(db, SQLITE_DBCONFIG_STMT_SCANSTATUS, 0, nullptr);
+		db_->ThrowSqliteError(env, rc);
+		return env.Undefined();
+	}
+
+	sqlite3_stmt* hot = stmt_;
+	stmt_ = profiled;
+	BindParams(env, info);
+	if (env.IsExceptionPending()) {
+		stmt_ = hot;
+		sqlite3_finalize(profiled);
+		sqlite3_db_config(db, SQLITE_DBCONFIG_STMT_SCANSTATUS, 0, nullptr);
+		return env.Undefined();
+	}
+
+	double rows = 0;
+	auto start = std::chrono::steady_clock::now();
+	{
+		ScopedDeadline deadline(db, budget);
+		while ((rc = sqlite3_step(profiled)) == SQLITE_ROW) {
+			rows++;
+		}
+	}
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	stmt_ = hot;
+	sqlite3_db_config(db, SQLITE_DBCONFIG_STMT_SCANSTATUS, 0, nullptr);
+
+	if (rc != SQLITE_DONE) {
+		sqlite3_finalize(profiled);
+		db_->ThrowSqliteError(env, rc);
+		return env.Undefined();
+	}
+
+	// Build the plan tree from the per-element counters
+	Napi::Array roots = Napi::Array::New(env);
+	std::unordered_map<int, Napi::Object> nodes;
+	for (int idx = 0;; idx++) {
+		int selectId = 0;
+		if (sqlite3_stmt_scanstatus_v2(profiled, idx, SQLITE_SCANSTAT_SELECTID, SQLITE_SCANSTAT_COMPLEX, &selectId) != 0) {
+			break;
+		}
+		int parentId = 0;
+		const char* explain = nullptr;
+		const char* name = nullptr;
+		double est = -1;
+		sqlite3_int64 loops = -1;
+		sqlite3_int64 visited = -1;
+		sqlite3_stmt_scanstatus_v2(profiled, idx, SQLITE_SCANSTAT_PARENTID, SQLITE_SCANSTAT_COMPLEX, &parentId);
+		sqlite3_stmt_scanstatus_v2(profiled, idx, SQLITE_SCANSTAT_EXPLAIN, SQLITE_SCANSTAT_COMPLEX, &explain);
+		sqlite3_stmt_scanstatus_v2(profiled, idx, SQLITE_SCANSTAT_NAME, SQLITE_SCANSTAT_COMPLEX, &name);
+		sqlite3_stmt_scanstatus_v2(profiled, idx, SQLITE_SCANSTAT_EST, SQLITE_SCANSTAT_COMPLEX, &est);
+		sqlite3_stmt_scanstatus_v2(profiled, idx, SQLITE_SCANSTAT_NLOOP, SQLITE_SCANSTAT_COMPLEX, &loops);
+		sqlite3_stmt_scanstatus_v2(profiled, idx, SQLITE_SCANSTAT_NVISIT, SQLITE_SCANSTAT_COMPLEX, &visited);
+
+		Napi::Object node = Napi::Object::New(env);
+		node.Set("id", Napi::Number::New(env, selectId));
+		node.Set("parent", Napi::Number::New(env, parentId));
+		node.Set("detail", Napi::String::New(env, explain ? explain : ""));
+		node.Set("name", name ? Napi::String::New(env, name) : env.Null());
+		node.Set("loops", loops < 0 ? env.Null() : Napi::Number::New(env, static_cast<double>(loops)));
+		node.Set("rowsVisited", visited < 0 ? env.Null() : Napi::Number::New(env, static_cast<double>(visited)));
+		node.Set("estimatedRows", est < 0 ? env.Null() : Napi::Number::New(env, est));
+		node.Set("actualRows", loops > 0 && visited >= 0
+			? Napi::Number::New(env, static_cast<double>(visited) / static_cast<double>(loops))
+			: env.Null());
+		node.Set("cycles", ScanStatusInt(env, profiled, idx, SQLITE_SCANSTAT_NCYCLE));
+		node.Set("children", Napi::Array::New(env));
+
+		auto parent = nodes.find(parentId);
+		Napi::Array siblings = parent != nodes.end()
+			? parent->second.Get("children").As<Napi::Array>()
+			: roots;
+		siblings.Set(siblings.Length(), node);
+		nodes.emplace(selectId, node);
+	}
+
+	Napi::Object result = Napi::Object::New(env);
+	result.Set("rows", Napi::Number::New(env, rows));
+	result.Set("durationNs", Napi::Number::New(env,
+		static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())));
+	result.Set("cycles", ScanStatusInt(env, profiled, -1, SQLITE_SCANSTAT_NCYCLE));
+	result.Set("plan", roots);
+	sqlite3_finalize(profiled);
+	return result;
+}
+
+// Property getters
+Napi::Value StatementWrapper::GetSource(const Napi::CallbackInfo& info) {
+	return Napi::String::New(info.Env(), source_);
+}
+Napi::Value StatementWrapper::GetReader(const Napi::CallbackInfo& info) {
+	if (!stmt_) return Napi::Boolean::New(info.Env(), false);
+	return Napi::Boolean::New(info.Env(), sqlite3_column_count(stmt_) > 0);
 }
 Napi::Value StatementWrapper::GetBusy(const Napi::CallbackInfo& info) {
 	if (!stmt_) return Napi::Boolean::New(info.Env(), false);
 	return Napi::Boolean::New(info.Env(), sqlite3_stmt_busy(stmt_) != 0);
 }
+
+// ============================================================================
+// BlobWrapper
+// ============================================================================
+
+Napi::FunctionReference BlobWrapper::constructor;
+
+Napi::Object BlobWrapper::Init(Napi::Env env, Napi::Object exports) {
+	Napi::Function func = DefineClass(env, "Blob", {
+		InstanceMethod("read", &BlobWrapper::Read),
+		InstanceMethod("write", &BlobWrapper::Write),
+		InstanceMethod("reopen", &BlobWrapper::Reopen),
+		InstanceMethod("close", &BlobWrapper::Close),
+		InstanceAccessor("length", &BlobWrapper::GetLength, nullptr),
+		InstanceAccessor("readonly", &BlobWrapper::GetReadonly, nullptr),
+		InstanceAccessor("open", &BlobWrapper::GetOpen, nullptr),
+	});
+
+	constructor = Napi::Persistent(func);
+	constructor.SuppressDestruct();
+	exports.Set("Blob", func);
+	return exports;
+}
+
+// Row ids arrive as Number or BigInt
+static bool RowidFromJS(Napi::Value val, sqlite3_int64& rowid) {
+	if (val.IsBigInt()) {
+		bool lossless = false;
+		rowid = val.As<Napi::BigInt>().Int64Value(&lossless);
+		return lossless;
+	}
+	if (val.IsNumber()) {
+		double d = val.As<Napi::Number>().DoubleValue();
+		if (d != static_cast<double>(static_cast<int64_t>(d))) return false;
+		rowid = static_cast<sqlite3_int64>(d);
+		return true;
+	}
+	return false;
+}
+
+BlobWrapper::BlobWrapper(const Napi::CallbackInfo& info)
+	: Napi::ObjectWrap<BlobWrapper>(info)
+	, blob_(nullptr)
+	, db_(nullptr)
+	, readonly_(true)
+{
+	Napi::Env env = info.Env();
+
+	if (info.Length() < 4 || !info[0].IsObject() || !info[1].IsString() || !info[2].IsString()) {
+		Napi::TypeError::New(env, "Expected (database, table, column, rowid)").ThrowAsJavaScriptException();
+		return;
+	}
+	sqlite3_int64 rowid = 0;
+	if (!RowidFromJS(info[3], rowid)) {
+		Napi::TypeError::New(env, "Expected rowid to be an integer").ThrowAsJavaScriptException();
+		return;
+	}
+
+	DatabaseWrapper* db = Napi::ObjectWrap<DatabaseWrapper>::Unwrap(info[0].As<Napi::Object>());
+	if (!db || !db->IsOpened()) {
+		Napi::TypeError::New(env, "The database connection is not open").ThrowAsJavaScriptException();
+		return;
+	}
+
+	readonly_ = info.Length() < 5 || info[4].ToBoolean().Value();
+	std::string schema = info.Length() >= 6 && info[5].IsString()
+		? info[5].As<Napi::String>().Utf8Value()
+		: "main";
+	std::string table = info[1].As<Napi::String>().Utf8Value();
+	std::string column = info[2].As<Napi::String>().Utf8Value();
+
+	int rc = sqlite3_blob_open(db->GetHandle(), schema.c_str(), table.c_str(), column.c_str(),
+		rowid, readonly_ ? 0 : 1, &blob_);
+	if (rc != SQLITE_OK) {
+		sqlite3_blob_close(blob_);
+		blob_ = nullptr;
+		db->ThrowSqliteError(env, rc);
+		return;
+	}
+
+	db_ = db;
+	db_->TrackBlob(this);
+}
+
+BlobWrapper::~BlobWrapper() {
+	// Cleanup happens in CloseBlob(), from close(), the connection or the GC
+}
+
+void BlobWrapper::Finalize(Napi::Env /*env*/) {
+	CloseBlob();
+}
+
+void BlobWrapper::CloseBlob() {
+	if (blob_) {
+		sqlite3_blob_close(blob_);
+		blob_ = nullptr;
+	}
+	if (db_) {
+		db_->UntrackBlob(this);
+		db_ = nullptr;
+	}
+}
+
+bool BlobWrapper::CheckOpen(Napi::Env env) {
+	if (!blob_) {
+		Napi::TypeError::New(env, "The blob handle is closed").ThrowAsJavaScriptException();
+		return false;
+	}
+	return true;
+}
+
+// read(target, targetOffset, length, blobOffset) -> bytes read
+Napi::Value BlobWrapper::Read(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!CheckOpen(env)) return env.Undefined();
+	if (info.Length() < 4 || !info[0].IsBuffer() || !info[1].IsNumber() || !info[2].IsNumber() || !info[3].IsNumber()) {
+		Napi::TypeError::New(env, "Expected (buffer, bufferOffset, length, offset)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	Napi::Buffer<uint8_t> target = info[0].As<Napi::Buffer<uint8_t>>();
+	int64_t targetOffset = info[1].As<Napi::Number>().Int64Value();
+	int64_t length = info[2].As<Napi::Number>().Int64Value();
+	int64_t offset = info[3].As<Napi::Number>().Int64Value();
+	int64_t size = sqlite3_blob_bytes(blob_);
+
+	if (targetOffset < 0 || length < 0 || offset < 0 || targetOffset + length > static_cast<int64_t>(target.Length())) {
+		Napi::RangeError::New(env, "Read range is outside the target buffer").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	// Reads past the end are clamped, like fs.read()
+	if (offset >= size) return Napi::Number::New(env, 0);
+	if (length > size - offset) length = size - offset;
+
+	int rc = sqlite3_blob_read(blob_, target.Data() + targetOffset, static_cast<int>(length), static_cast<int>(offset));
+	if (rc != SQLITE_OK) {
+		db_->ThrowSqliteError(env, rc);
+		return env.Undefined();
+	}
+	return Napi::Number::New(env, static_cast<double>(length));
+}
+
+// write(source, offset) -> bytes written; blobs cannot grow
+Napi::Value BlobWrapper::Write(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!CheckOpen(env)) return env.Undefined();
+	if (readonly_) {
+		Napi::TypeError::New(env, "The blob was opened readonly").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsNumber()) {
+		Napi::TypeError::New(env, "Expected (buffer, offset)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	Napi::Buffer<uint8_t> source = info[0].As<Napi::Buffer<uint8_t>>();
+	int64_t offset = info[1].As<Napi::Number>().Int64Value();
+	int64_t size = sqlite3_blob_bytes(blob_);
+	if (offset < 0 || offset + static_cast<int64_t>(source.Length()) > size) {
+		Napi::RangeError::New(env, "Write would extend past the end of the blob (allocate it with zeroblob())").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	int rc = sqlite3_blob_write(blob_, source.Data(), static_cast<int>(source.Length()), static_cast<int>(offset));
+	if (rc != SQLITE_OK) {
+		db_->ThrowSqliteError(env, rc);
+		return env.Undefined();
+	}
+	return Napi::Number::New(env, static_cast<double>(source.Length()));
+}
+
+Napi::Value BlobWrapper::Reopen(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!CheckOpen(env)) return env.Undefined();
+	sqlite3_int64 rowid = 0;
+	if (info.Length() < 1 || !RowidFromJS(info[0], rowid)) {
+		Napi::TypeError::New(env, "Expected rowid to be an integer").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	int rc = sqlite3_blob_reopen(blob_, rowid);
+	if (rc != SQLITE_OK) {
+		// The handle is aborted after a failed reopen
+		DatabaseWrapper* db = db_;
+		db->ThrowSqliteError(env, rc);
+		CloseBlob();
+		return env.Undefined();
+	}
+	return info.This();
+}
+
+Napi::Value BlobWrapper::Close(const Napi::CallbackInfo& info) {
+	CloseBlob();
+	return info.This();
+}
+
+Napi::Value BlobWrapper::GetLength(const Napi::CallbackInfo& info) {
+	if (!blob_) return Napi::Number::New(info.Env(), 0);
+	return Napi::Number::New(info.Env(), sqlite3_blob_bytes(blob_));
+}
+
+Napi::Value BlobWrapper::GetReadonly(const Napi::CallbackInfo& info) {
+	return Napi::Boolean::New(info.Env(), readonly_);
+}
+
+Napi::Value BlobWrapper::GetOpen(const Napi::CallbackInfo& info) {
+	return Napi::Boolean::New(info.Env(), blob_ != nullptr);
+}
+
+// ============================================================================
+// SessionWrapper
+// ============================================================================
+
+Napi::FunctionReference SessionWrapper::constructor;
+
+Napi::Object SessionWrapper::Init(Napi::Env env, Napi::Object exports) {
+	Napi::Function func = DefineClass(env, "Session", {
+		InstanceMethod("changeset", &SessionWrapper::Changeset),
+		InstanceMethod("patchset", &SessionWrapper::Patchset),
+		InstanceMethod("enable", &SessionWrapper::Enable),
+		InstanceMethod("close", &SessionWrapper::Close),
+		InstanceAccessor("empty", &SessionWrapper::GetEmpty, nullptr),
+		InstanceAccessor("open", &SessionWrapper::GetOpen, nullptr),
+	});
+
+	constructor = Napi::Persistent(func);
+	constructor.SuppressDestruct();
+	exports.Set("Session", func);
+	return exports;
+}
+
+SessionWrapper::SessionWrapper(const Napi::CallbackInfo& info)
+	: Napi::ObjectWrap<SessionWrapper>(info)
+	, session_(nullptr)
+	, db_(nullptr)
+{
+	Napi::Env env = info.Env();
+
+	if (info.Length() < 1 || !info[0].IsObject()) {
+		Napi::TypeError::New(env, "Expected (database, tables, schema)").ThrowAsJavaScriptException();
+		return;
+	}
+	DatabaseWrapper* db = Napi::ObjectWrap<DatabaseWrapper>::Unwrap(info[0].As<Napi::Object>());
+	if (!db || !db->IsOpened()) {
+		Napi::TypeError::New(env, "The database connection is not open").ThrowAsJavaScriptException();
+		return;
+	}
+
+	std::string schema = info.Length() >= 3 && info[2].IsString()
+		? info[2].As<Napi::String>().Utf8Value()
+		: "main";
+	int rc = sqlite3session_create(db->GetHandle(), schema.c_str(), &session_);
+	if (rc != SQLITE_OK) {
+		session_ = nullptr;
+		db->ThrowSqliteError(env, rc);
+		return;
+	}
+
+	// No table list: record every table that has a primary key
+	if (info.Length() >= 2 && info[1].IsArray()) {
+		Napi::Array tables = info[1].As<Napi::Array>();
+		for (uint32_t i = 0; i < tables.Length(); i++) {
+			std::string table = tables.Get(i).As<Napi::String>().Utf8Value();
+			rc = sqlite3session_attach(session_, table.c_str());
+			if (rc != SQLITE_OK) break;
+		}
+	} else {
+		rc = sqlite3session_attach(session_, nullptr);
+	}
+	if (rc != SQLITE_OK) {
+		sqlite3session_delete(session_);
+		session_ = nullptr;
+		db->ThrowSqliteError(env, rc);
+		return;
+	}
+
+	db_ = db;
+	db_->TrackSession(this);
+}
+
+SessionWrapper::~SessionWrapper() {
+	// Cleanup happens in DeleteSession(), from close(), the connection or the GC
+}
+
+void SessionWrapper::Finalize(Napi::Env /*env*/) {
+	DeleteSession();
+}
+
+void SessionWrapper::DeleteSession() {
+	if (session_) {
+		sqlite3session_delete(session_);
+		session_ = nullptr;
+	}
+	if (db_) {
+		db_->UntrackSession(this);
+		db_ = nullptr;
+	}
+}
+
+bool SessionWrapper::CheckOpen(Napi::Env env) {
+	if (!session_) {
+		Napi::TypeError::New(env, "The session is closed").ThrowAsJavaScriptException();
+		return false;
+	}
+	return true;
+}
+
+Napi::Value SessionWrapper::Changeset(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!CheckOpen(env)) return env.Undefined();
+
+	int size = 0;
+	void* data = nullptr;
+	int rc = sqlite3session_changeset(session_, &size, &data);
+	if (rc != SQLITE_OK) {
+		sqlite3_free(data);
+		db_->ThrowSqliteError(env, rc);
+		return env.Undefined();
+	}
+	Napi::Buffer<uint8_t> result = Napi::Buffer<uint8_t>::Copy(env, static_cast<uint8_t*>(data), static_cast<size_t>(size));
+	sqlite3_free(data);
+	return result;
+}
+
+Napi::Value SessionWrapper::Patchset(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!CheckOpen(env)) return env.Undefined();
+
+	int size = 0;
+	void* data = nullptr;
+	int rc = sqlite3session_patchset(session_, &size, &data);
+	if (rc != SQLITE_OK) {
+		sqlite3_free(data);
+		db_->ThrowSqliteError(env, rc);
+		return env.Undefined();
+	}
+	Napi::Buffer<uint8_t> result = Napi::Buffer<uint8_t>::Copy(env, static_cast<uint8_t*>(data), static_cast<size_t>(size));
+	sqlite3_free(data);
+	return result;
+}
+
+Napi::Value SessionWrapper::Enable(const Napi::CallbackInfo& info) {
+	Napi::Env env = info.Env();
+	if (!CheckOpen(env)) return env.Undefined();
+	int enable = info.Length() >= 1 ? (info[0].ToBoolean().Value() ? 1 : 0) : 1;
+	sqlite3session_enable(session_, enable);
+	return info.This();
+}
+
+Napi::Value SessionWrapper::Close(const Napi::CallbackInfo& info) {
+	DeleteSession();
+	return info.This();
+}
+
+Napi::Value SessionWrapper::GetEmpty(const Napi::CallbackInfo& info) {
+	if (!session_) return Napi::Boolean::New(info.Env(), true);
+	return Napi::Boolean::New(info.Env(), sqlite3session_isempty(session_) != 0);
+}
+
+Napi::Value SessionWrapper::GetOpen(const Napi::CallbackInfo& info) {
+	return Napi::Boolean::New(info.Env(), session_ != nullptr);
+}
@@ -12,10 +12,28 @@
 #include <sqlite3.h>
 #include <string>
 #include <vector>
+#include <utility>
 #include <unordered_set>
+#include "trace_hook.h"
+#include "index_advisor.h"
+#include "memory_region.h"
+#include "uring_vfs.h"
+#include "wal_checkpointer.h"
+#include "interrupt_timer.h"
+#include "dedup_filter.h"
+#include "text_functions.h"
+#include "ioc_tokenizer.h"
+#include "bulk_importer.h"
+#include "query_exporter.h"
+#include "json_writer.h"
+#include "json_codec.h"
+#include "carray.h"
+#include "connection_extensions.h"
 
 // Forward declarations
 class StatementWrapper;
+class BlobWrapper;
+class SessionWrapper;
 
 /**
  * DatabaseWrapper - N-API class wrapping SQLite3 database connection
@@ -37,6 +55,14 @@ public:
 	bool IsOpened() const { return db_ != nullptr; }
 	void TrackStatement(StatementWrapper* stmt);
 	void UntrackStatement(StatementWrapper* stmt);
+	void TrackBlob(BlobWrapper* blob);
+	void UntrackBlob(BlobWrapper* blob);
+	void TrackSession(SessionWrapper* session);
+	void UntrackSession(SessionWrapper* session);
+	void RecordWorkload(const std::string& sql);
+	// Milliseconds the next execution may run: timeoutMs capped by the active
+	// deadline scope; 0 means unlimited, -1 that the scope has already expired
+	int64_t ExecutionBudget(int64_t timeoutMs) const;
 
 private:
 	sqlite3* db_;
@@ -45,6 +71,29 @@ private:
 	bool memory_;
 	std::string name_;
 	std::unordered_set<StatementWrapper*> statements_;
+	std::unordered_set<BlobWrapper*> blobs_;
+	std::unordered_set<SessionWrapper*> sessions_;
+	TraceHook* trace_;
+	MemoryRegion* lookaside_;
+	WalCheckpointer* checkpointer_;
+
+	// Statements that exceeded fullScanThreshold_ full-scan steps in one run
+	std::vector<std::string> workload_;
+	std::unordered_set<std::string> workloadSeen_;
+	int64_t fullScanThreshold_;
+
+	// Default statement timeout (0 = none); the absolute steady-clock deadline
+	// (ms) of every open withDeadline() scope by pushDeadline() token, and the
+	// earliest of them (0 = none)
+	int64_t queryTimeout_;
+	std::vector<std::pair<uint32_t, int64_t>> deadlines_;
+	uint32_t nextDeadlineToken_;
+	int64_t deadline_;
+
+	// Configured busy timeout (ms) and registered IOC tokenizer names, both
+	// reused by worker-thread connections
+	int busyTimeout_;
+	std::vector<std::string> tokenizers_;
 
 	static Napi::FunctionReference constructor;
 
@@ -55,6 +104,18 @@ private:
 	Napi::Value Pragma(const Napi::CallbackInfo& info);
 	Napi::Value LoadExtension(const Napi::CallbackInfo& info);
 	Napi::Value DefaultSafeIntegers(const Napi::CallbackInfo& info);
+	Napi::Value AdviseIndexes(const Napi::CallbackInfo& info);
+	Napi::Value CacheStats(const Napi::CallbackInfo& info);
+	Napi::Value CheckpointStats(const Napi::CallbackInfo& info);
+	Napi::Value OpenBlob(const Napi::CallbackInfo& info);
+	Napi::Value CreateSession(const Napi::CallbackInfo& info);
+	Napi::Value ApplyChangeset(const Napi::CallbackInfo& info);
+	Napi::Value Interrupt(const Napi::CallbackInfo& info);
+	Napi::Value PushDeadline(const Napi::CallbackInfo& info);
+	Napi::Value PopDeadline(const Napi::CallbackInfo& info);
+	Napi::Value RegisterTokenizer(const Napi::CallbackInfo& info);
+	Napi::Value ImportFile(const Napi::CallbackInfo& info);
+	Napi::Value Pipeline(const Napi::CallbackInfo& info);
 
 	// Property getters
 	Napi::Value GetName(const Napi::CallbackInfo& info);
@@ -67,8 +128,11 @@ private:
 
 	void ThrowSqliteError(Napi::Env env);
 	void ThrowSqliteError(Napi::Env env, int rc);
+	void CloseConnection();
 
 	friend class StatementWrapper;
+	friend class BlobWrapper;
+	friend class SessionWrapper;
 };
 
 /**
@@ -91,6 +155,13 @@ private:
 	bool safeIntegers_;
 	bool rawMode_;
 	bool expandMode_;
+	bool jsonBuffer_;    // allJSON()/getJSON() return a Buffer instead of a string
+	bool jsonMode_;      // objects bind as JSONB; jsonColumns_ are decoded
+	bool carray_;        // the SQL calls carray(), so arrays bind as pointers
+	std::vector<bool> jsonColumns_;
+	int64_t timeout_;    // -1 inherits the database's queryTimeout
+	DedupFilter* dedup_;
+	std::vector<int> dedupParams_;   // bind index of each key column
 
 	static Napi::FunctionReference constructor;
 	friend class DatabaseWrapper;
@@ -99,12 +170,22 @@ private:
 	Napi::Value Run(const Napi::CallbackInfo& info);
 	Napi::Value Get(const Napi::CallbackInfo& info);
 	Napi::Value All(const Napi::CallbackInfo& info);
+	Napi::Value GetJSON(const Napi::CallbackInfo& info);
+	Napi::Value AllJSON(const Napi::CallbackInfo& info);
+	Napi::Value GetMany(const Napi::CallbackInfo& info);
+	Napi::Value JsonBuffer(const Napi::CallbackInfo& info);
 	Napi::Value Iterate(const Napi::CallbackInfo& info);
 	Napi::Value Columns(const Napi::CallbackInfo& info);
 	Napi::Value Bind(const Napi::CallbackInfo& info);
 	Napi::Value SafeIntegers(const Napi::CallbackInfo& info);
 	Napi::Value Raw(const Napi::CallbackInfo& info);
 	Napi::Value Expand(const Napi::CallbackInfo& info);
+	Napi::Value Json(const Napi::CallbackInfo& info);
+	Napi::Value Profile(const Napi::CallbackInfo& info);
+	Napi::Value Timeout(const Napi::CallbackInfo& info);
+	Napi::Value SetDedupFilter(const Napi::CallbackInfo& info);
+	Napi::Value DedupStats(const Napi::CallbackInfo& info);
+	Napi::Value ExportTo(const Napi::CallbackInfo& info);
 
 	// Property getters
 	Napi::Value GetSource(const Napi::CallbackInfo& info);
@@ -113,10 +194,98 @@ private:
 
 	// Helpers
 	void BindParams(Napi::Env env, const Napi::CallbackInfo& info, int startIdx = 0);
+	void BindParams(Napi::Env env, Napi::Value params);
+	void BindNamed(Napi::Env env, Napi::Object obj);
 	void BindValue(Napi::Env env, int index, Napi::Value val);
 	Napi::Value ColumnToJS(Napi::Env env, int col);
+	bool IsJsonColumn(int col) const {
+		return jsonMode_ && static_cast<size_t>(col) < jsonColumns_.size() && jsonColumns_[col];
+	}
 	Napi::Object RowToObject(Napi::Env env);
 	Napi::Array RowToArray(Napi::Env env);
+	Napi::Value JsonResult(Napi::Env env, const std::string& json);
+	void CheckFullScan(uint32_t runs = 1);
+	int64_t Budget() const;
+	// What one execution returns: run() info, one row, every row, or JSON text
+	enum class Mode { Run, Get, All, GetJSON, AllJSON };
+	Napi::Value Execute(Napi::Env env, Mode mode, int64_t budget);
+	Napi::Object RunResult(Napi::Env env, int changes);
+	bool DedupKey(const Napi::CallbackInfo& info, DedupFilter::Key& key);
+};
+
+/**
+ * BlobWrapper - N-API class wrapping an incremental BLOB handle
+ *
+ * Reads and writes go straight between the caller's Buffer and the row's
+ * pages (sqlite3_blob_read/write), so large values never have to be
+ * materialized as a whole. The handle can be moved to another row of the
+ * same column with reopen().
+ */
+class BlobWrapper : public Napi::ObjectWrap<BlobWrapper> {
+public:
+	static Napi::Object Init(Napi::Env env, Napi::Object exports);
+	BlobWrapper(const Napi::CallbackInfo& info);
+	~BlobWrapper();
+
+	void Finalize(Napi::Env env);
+	void CloseBlob();
+
+private:
+	sqlite3_blob* blob_;
+	DatabaseWrapper* db_;
+	bool readonly_;
+
+	static Napi::FunctionReference constructor;
+	friend class DatabaseWrapper;
+
+	// Methods exposed to JS
+	Napi::Value Read(const Napi::CallbackInfo& info);
+	Napi::Value Write(const Napi::CallbackInfo& info);
+	Napi::Value Reopen(const Napi::CallbackInfo& info);
+	Napi::Value Close(const Napi::CallbackInfo& info);
+
+	// Property getters
+	Napi::Value GetLength(const Napi::CallbackInfo& info);
+	Napi::Value GetReadonly(const Napi::CallbackInfo& info);
+	Napi::Value GetOpen(const Napi::CallbackInfo& info);
+
+	bool CheckOpen(Napi::Env env);
+};
+
+/**
+ * SessionWrapper - N-API class wrapping a session extension object
+ *
+ * Records row changes to the attached tables (all tables when none are
+ * given) and serializes them as changesets or patchsets that another
+ * database can apply with applyChangeset().
+ */
+class SessionWrapper : public Napi::ObjectWrap<SessionWrapper> {
+public:
+	static Napi::Object Init(Napi::Env env, Napi::Object exports);
+	SessionWrapper(const Napi::CallbackInfo& info);
+	~SessionWrapper();
+
+	void Finalize(Napi::Env env);
+	void DeleteSession();
+
+private:
+	sqlite3_session* session_;
+	DatabaseWrapper* db_;
+
+	static Napi::FunctionReference constructor;
+	friend class DatabaseWrapper;
+
+	// Methods exposed to JS
+	Napi::Value Changeset(const Napi::CallbackInfo& info);
+	Napi::Value Patchset(const Napi::CallbackInfo& info);
+	Napi::Value Enable(const Napi::CallbackInfo& info);
+	Napi::Value Close(const Napi::CallbackInfo& info);
+
+	// Property getters
+	Napi::Value GetEmpty(const Napi::CallbackInfo& info);
+	Napi::Value GetOpen(const Napi::CallbackInfo& info);
+
+	bool CheckOpen(Napi::Env env);
 };
 
 #endif // SQLITE3_WRAPPER_H
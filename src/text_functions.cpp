@@ -0,0 +1,516 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Text Normalization Functions Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "text_functions.h"
+#include "unicode_case_table.h"
+#include <new>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEX_TEXT_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define HEX_TEXT_NEON 1
+#include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Worst-case UTF-8 growth of one code point (U+0390 folds to three 2-byte ones)
+const size_t kMaxGrowth = 3;
+// Bytes the block lowering may write past the current output position
+const size_t kBlock = 16;
+
+inline unsigned char LowerAscii(unsigned char c) {
+	return c >= 'A' && c <= 'Z' ? c | 0x20 : c;
+}
+
+inline bool IsAlpha(unsigned char c) {
+	return (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+}
+
+inline bool IsDigit(unsigned char c) {
+	return c >= '0' && c <= '9';
+}
+
+inline int HexValue(unsigned char c) {
+	if (IsDigit(c)) return c - '0';
+	c |= 0x20;
+	return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+#ifdef HEX_TEXT_SSE2
+inline unsigned CountTrailingZeros(unsigned x) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, x);
+	return index;
+#else
+	return __builtin_ctz(x);
+#endif
+}
+#endif
+
+// Lowercases one 16-byte block into out (all 16 bytes are written) and
+// returns the length of its leading ASCII run; only that much is valid
+inline size_t LowerAsciiBlock(const unsigned char* in, unsigned char* out) {
+#if defined(HEX_TEXT_SSE2)
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+	// 'A'..'Z' + 0x3F lands on -128..-103, the bottom of the signed range
+	__m128i shifted = _mm_add_epi8(v, _mm_set1_epi8(0x3F));
+	__m128i upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(-102));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20))));
+	unsigned nonAscii = static_cast<unsigned>(_mm_movemask_epi8(v));
+	return nonAscii ? CountTrailingZeros(nonAscii) : kBlock;
+#elif defined(HEX_TEXT_NEON)
+	uint8x16_t v = vld1q_u8(in);
+	uint8x16_t upper = vcltq_u8(vsubq_u8(v, vdupq_n_u8('A')), vdupq_n_u8(26));
+	vst1q_u8(out, vorrq_u8(v, vandq_u8(upper, vdupq_n_u8(0x20))));
+	if (vmaxvq_u8(v) < 0x80) return kBlock;
+	size_t i = 0;
+	while (in[i] < 0x80) i++;
+	return i;
+#else
+	size_t i = 0;
+	while (i < kBlock && in[i] < 0x80) {
+		out[i] = LowerAscii(in[i]);
+		i++;
+	}
+	return i;
+#endif
+}
+
+// Decodes one code point; returns its length, or 0 for an invalid sequence
+size_t DecodeUtf8(const unsigned char* p, size_t avail, uint32_t& cp) {
+	unsigned char c = p[0];
+	size_t length;
+	uint32_t min;
+	if (c >= 0xC2 && c <= 0xDF) { length = 2; cp = c & 0x1F; min = 0x80; }
+	else if (c >= 0xE0 && c <= 0xEF) { length = 3; cp = c & 0x0F; min = 0x800; }
+	else if (c >= 0xF0 && c <= 0xF4) { length = 4; cp = c & 0x07; min = 0x10000; }
+	else return 0;
+	if (avail < length) return 0;
+	for (size_t i = 1; i < length; i++) {
+		if ((p[i] & 0xC0) != 0x80) return 0;
+		cp = (cp << 6) | (p[i] & 0x3F);
+	}
+	if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000)) return 0;
+	return length;
+}
+
+size_t EncodeUtf8(uint32_t cp, unsigned char* out) {
+	if (cp < 0x80) {
+		out[0] = static_cast<unsigned char>(cp);
+		return 1;
+	}
+	if (cp < 0x800) {
+		out[0] = static_cast<unsigned char>(0xC0 | (cp >> 6));
+		out[1] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+		return 2;
+	}
+	if (cp < 0x10000) {
+		out[0] = static_cast<unsigned char>(0xE0 | (cp >> 12));
+		out[1] = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+		out[2] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+		return 3;
+	}
+	out[0] = static_cast<unsigned char>(0xF0 | (cp >> 18));
+	out[1] = static_cast<unsigned char>(0x80 | ((cp >> 12) & 0x3F));
+	out[2] = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+	out[3] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+	return 4;
+}
+
+template <size_t N>
+uint32_t MapCodePoint(const CaseRange (&table)[N], uint32_t cp) {
+	// Last run starting at or before cp
+	size_t lo = 0;
+	size_t hi = N;
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (table[mid].first <= cp) lo = mid + 1;
+		else hi = mid;
+	}
+	if (lo == 0) return cp;
+	const CaseRange& range = table[lo - 1];
+	uint32_t offset = cp - range.first;
+	if (offset < static_cast<uint32_t>(range.count) * range.stride && offset % range.stride == 0) {
+		return static_cast<uint32_t>(static_cast<int32_t>(cp) + range.delta);
+	}
+	return cp;
+}
+
+struct LowerMapping {
+	size_t operator()(uint32_t cp, unsigned char* out) const {
+		return EncodeUtf8(MapCodePoint(kLowerRanges, cp), out);
+	}
+};
+
+struct FoldMapping {
+	size_t operator()(uint32_t cp, unsigned char* out) const {
+		const size_t count = sizeof(kFoldExpansions) / sizeof(kFoldExpansions[0]);
+		size_t lo = 0;
+		size_t hi = count;
+		while (lo < hi) {
+			size_t mid = (lo + hi) / 2;
+			if (kFoldExpansions[mid].cp < cp) lo = mid + 1;
+			else hi = mid;
+		}
+		if (lo < count && kFoldExpansions[lo].cp == cp) {
+			size_t length = 0;
+			for (uint32_t to : kFoldExpansions[lo].to) {
+				if (to) length += EncodeUtf8(to, out + length);
+			}
+			return length;
+		}
+		return EncodeUtf8(MapCodePoint(kFoldRanges, cp), out);
+	}
+};
+
+// Case-maps text into out, which must hold length * kMaxGrowth + kBlock
+// bytes; returns the output length
+template <typename Mapping>
+size_t MapCase(const unsigned char* in, size_t length, unsigned char* out, Mapping map) {
+	size_t i = 0;
+	size_t o = 0;
+	while (i < length) {
+		if (length - i >= kBlock) {
+			size_t ascii = LowerAsciiBlock(in + i, out + o);
+			i += ascii;
+			o += ascii;
+			if (ascii == kBlock) continue;
+		} else if (in[i] < 0x80) {
+			out[o++] = LowerAscii(in[i++]);
+			continue;
+		}
+		uint32_t cp;
+		size_t n = DecodeUtf8(in + i, length - i, cp);
+		if (n == 0) {
+			out[o++] = in[i++];
+			continue;
+		}
+		i += n;
+		o += map(cp, out + o);
+	}
+	return o;
+}
+
+template <typename Mapping>
+std::string MapCase(const char* text, size_t length, Mapping map) {
+	std::string out(length * kMaxGrowth + kBlock, '\0');
+	out.resize(MapCase(reinterpret_cast<const unsigned char*>(text), length,
+		reinterpret_cast<unsigned char*>(&out[0]), map));
+	return out;
+}
+
+// Uppercases %xx escapes and decodes the ones that stand for unreserved
+// characters (RFC 3986 6.2.2.2)
+std::string NormalizePercent(const std::string& s) {
+	std::string out;
+	out.reserve(s.size());
+	for (size_t i = 0; i < s.size(); i++) {
+		int hi, lo;
+		if (s[i] != '%' || i + 2 >= s.size() || (hi = HexValue(s[i + 1])) < 0 || (lo = HexValue(s[i + 2])) < 0) {
+			out += s[i];
+			continue;
+		}
+		unsigned char c = static_cast<unsigned char>(hi * 16 + lo);
+		if (IsAlpha(c) || IsDigit(c) || c == '-' || c == '.' || c == '_' || c == '~') {
+			out += static_cast<char>(c);
+		} else {
+			out += '%';
+			out += "0123456789ABCDEF"[hi];
+			out += "0123456789ABCDEF"[lo];
+		}
+		i += 2;
+	}
+	return out;
+}
+
+// RFC 3986 5.2.4
+std::string RemoveDotSegments(const std::string& path) {
+	bool absolute = !path.empty() && path[0] == '/';
+	std::vector<std::string> segments;
+	size_t start = absolute ? 1 : 0;
+	for (;;) {
+		size_t end = path.find('/', start);
+		bool last = end == std::string::npos;
+		std::string segment = path.substr(start, last ? std::string::npos : end - start);
+		if (segment == "." || segment == "..") {
+			if (segment == ".." && !segments.empty()) segments.pop_back();
+			// "/a/b/.." keeps its trailing slash
+			if (last) segments.emplace_back();
+		} else {
+			segments.push_back(segment);
+		}
+		if (last) break;
+		start = end + 1;
+	}
+	std::string out = absolute ? "/" : "";
+	for (size_t i = 0; i < segments.size(); i++) {
+		if (i) out += '/';
+		out += segments[i];
+	}
+	return out;
+}
+
+int DefaultPort(const std::string& scheme) {
+	if (scheme == "http" || scheme == "ws") return 80;
+	if (scheme == "https" || scheme == "wss") return 443;
+	if (scheme == "ftp") return 21;
+	return -1;
+}
+
+std::string NormalizeAuthority(const std::string& authority, const std::string& scheme) {
+	std::string out;
+	size_t at = authority.rfind('@');
+	size_t hostStart = 0;
+	if (at != std::string::npos) {
+		out = NormalizePercent(authority.substr(0, at + 1));
+		hostStart = at + 1;
+	}
+
+	// Host ends at the port colon; IPv6 literals are bracketed
+	size_t hostEnd = authority.size();
+	if (hostStart < authority.size() && authority[hostStart] == '[') {
+		size_t close = authority.find(']', hostStart);
+		if (close != std::string::npos) hostEnd = close + 1;
+	}
+	size_t colon = authority.find(':', hostEnd == authority.size() ? hostStart : hostEnd);
+	if (colon != std::string::npos && colon < hostEnd) hostEnd = colon;
+
+	std::string host = NormalizePercent(authority.substr(hostStart, hostEnd - hostStart));
+	host = TextFunctions::Lower(host.data(), host.size());
+	// "example.com." is the same fully qualified name
+	if (host.size() > 1 && host.back() == '.') host.pop_back();
+	out += host;
+
+	if (hostEnd < authority.size() && authority[hostEnd] == ':') {
+		std::string port = authority.substr(hostEnd + 1);
+		bool numeric = port.size() <= 5;
+		for (char c : port) numeric = numeric && IsDigit(c);
+		if (!numeric) {
+			out += ':' + port;
+		} else if (!port.empty() && std::stoi(port) != DefaultPort(scheme)) {
+			out += ':' + std::to_string(std::stoi(port));
+		}
+	}
+	return out;
+}
+
+// Windows resolves "cmd.exe." and "cmd.exe " to cmd.exe
+void TrimWin32Segment(std::string& segment) {
+	if (segment == "." || segment == "..") return;
+	while (!segment.empty() && (segment.back() == '.' || segment.back() == ' ')) segment.pop_back();
+}
+
+std::string NormalizeWindowsPath(std::string path) {
+	for (char& c : path) {
+		if (c == '/') c = '\\';
+	}
+	// Extended-length prefixes name the same file as the plain form
+	if (path.compare(0, 8, "\\\\?\\UNC\\") == 0) {
+		path = "\\\\" + path.substr(8);
+	} else if (path.compare(0, 4, "\\\\?\\") == 0 || path.compare(0, 4, "\\??\\") == 0) {
+		path = path.substr(4);
+	}
+
+	std::string root;
+	size_t i = 0;
+	size_t pinned = 0; // leading segments ".." cannot remove (UNC server and share)
+	if (path.size() >= 2 && IsAlpha(path[0]) && path[1] == ':') {
+		root = path.substr(0, 2);
+		i = 2;
+		if (i < path.size() && path[i] == '\\') root += '\\';
+	} else if (path.compare(0, 4, "\\\\.\\") == 0) {
+		root = "\\\\.\\";
+		i = 4;
+	} else if (path.compare(0, 2, "\\\\") == 0) {
+		root = "\\\\";
+		i = 2;
+		pinned = 2;
+	} else if (!path.empty() && path[0] == '\\') {
+		root = "\\";
+	}
+
+	std::vector<std::string> segments;
+	while (i <= path.size()) {
+		size_t end = path.find('\\', i);
+		if (end == std::string::npos) end = path.size();
+		std::string segment = path.substr(i, end - i);
+		i = end + 1;
+		TrimWin32Segment(segment);
+		if (segment.empty() || segment == ".") continue;
+		if (segment == "..") {
+			if (segments.size() > pinned && segments.back() != "..") {
+				segments.pop_back();
+				continue;
+			}
+			// Relative paths keep leading "..", rooted ones stop at the root
+			if (!root.empty()) continue;
+		}
+		segments.push_back(segment);
+	}
+
+	std::string out = root;
+	for (size_t s = 0; s < segments.size(); s++) {
+		if (s) out += '\\';
+		out += segments[s];
+	}
+	// NTFS compares names through its uppercase table: simple mappings only
+	return TextFunctions::Lower(out.data(), out.size());
+}
+
+std::string NormalizePosixPath(const std::string& path) {
+	bool absolute = !path.empty() && path[0] == '/';
+	std::vector<std::string> segments;
+	size_t i = 0;
+	while (i <= path.size()) {
+		size_t end = path.find('/', i);
+		if (end == std::string::npos) end = path.size();
+		std::string segment = path.substr(i, end - i);
+		i = end + 1;
+		if (segment.empty() || segment == ".") continue;
+		if (segment == "..") {
+			if (!segments.empty() && segments.back() != "..") {
+				segments.pop_back();
+				continue;
+			}
+			if (absolute) continue;
+		}
+		segments.push_back(segment);
+	}
+
+	std::string out = absolute ? "/" : "";
+	for (size_t s = 0; s < segments.size(); s++) {
+		if (s) out += '/';
+		out += segments[s];
+	}
+	return out.empty() ? "." : out;
+}
+
+template <typename Mapping>
+void CaseFunction(sqlite3_context* ctx, int, sqlite3_value** argv) {
+	if (sqlite3_value_type(argv[0]) != SQLITE_TEXT) {
+		sqlite3_result_value(ctx, argv[0]);
+		return;
+	}
+	const unsigned char* text = sqlite3_value_text(argv[0]);
+	size_t length = static_cast<size_t>(sqlite3_value_bytes(argv[0]));
+	unsigned char* out = text
+		? static_cast<unsigned char*>(sqlite3_malloc64(length * kMaxGrowth + kBlock))
+		: nullptr;
+	if (!out) {
+		sqlite3_result_error_nomem(ctx);
+		return;
+	}
+	size_t outLength = MapCase(text, length, out, Mapping());
+	sqlite3_result_text64(ctx, reinterpret_cast<char*>(out), outLength, sqlite3_free, SQLITE_UTF8);
+}
+
+template <std::string (*Normalize)(const char*, size_t)>
+void NormalizeFunction(sqlite3_context* ctx, int, sqlite3_value** argv) {
+	if (sqlite3_value_type(argv[0]) != SQLITE_TEXT) {
+		sqlite3_result_value(ctx, argv[0]);
+		return;
+	}
+	const char* text = reinterpret_cast<const char*>(sqlite3_value_text(argv[0]));
+	if (!text) {
+		sqlite3_result_error_nomem(ctx);
+		return;
+	}
+	try {
+		std::string out = Normalize(text, static_cast<size_t>(sqlite3_value_bytes(argv[0])));
+		sqlite3_result_text64(ctx, out.data(), out.size(), SQLITE_TRANSIENT, SQLITE_UTF8);
+	} catch (const std::bad_alloc&) {
+		sqlite3_result_error_nomem(ctx);
+	}
+}
+
+} // namespace
+
+int TextFunctions::Register(sqlite3* db) {
+	struct Entry {
+		const char* name;
+		void (*fn)(sqlite3_context*, int, sqlite3_value**);
+	};
+	static const Entry entries[] = {
+		{ "hex_lower", CaseFunction<LowerMapping> },
+		{ "hex_casefold", CaseFunction<FoldMapping> },
+		{ "hex_normalize_url", NormalizeFunction<TextFunctions::NormalizeUrl> },
+		{ "hex_normalize_path", NormalizeFunction<TextFunctions::NormalizePath> },
+	};
+	// Deterministic + innocuous: usable in generated columns, expression
+	// indexes and CHECK constraints, and safe under trusted_schema=OFF
+	const int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC | SQLITE_INNOCUOUS;
+	for (const Entry& entry : entries) {
+		int rc = sqlite3_create_function_v2(db, entry.name, 1, flags, nullptr, entry.fn, nullptr, nullptr, nullptr);
+		if (rc != SQLITE_OK) return rc;
+	}
+	return SQLITE_OK;
+}
+
+std::string TextFunctions::Lower(const char* text, size_t length) {
+	return MapCase(text, length, LowerMapping());
+}
+
+std::string TextFunctions::CaseFold(const char* text, size_t length) {
+	return MapCase(text, length, FoldMapping());
+}
+
+std::string TextFunctions::NormalizeUrl(const char* text, size_t length) {
+	std::string url(text, length);
+
+	// scheme ":" must be followed by "//" to start an authority; "host:8080"
+	// and bare "host/path" (common in extracted indicators) have no scheme
+	size_t colon = 0;
+	if (!url.empty() && IsAlpha(url[0])) {
+		colon = 1;
+		while (colon < url.size() && (IsAlpha(url[colon]) || IsDigit(url[colon]) ||
+			url[colon] == '+' || url[colon] == '-' || url[colon] == '.')) colon++;
+		if (colon >= url.size() || url[colon] != ':') colon = 0;
+	}
+	std::string scheme;
+	std::string out;
+	size_t i = 0;
+	if (colon && url.compare(colon + 1, 2, "//") == 0) {
+		scheme = Lower(url.data(), colon);
+		out = scheme + "://";
+		i = colon + 3;
+	} else if (colon && colon + 1 < url.size() && !IsDigit(url[colon + 1])) {
+		// Opaque URI (mailto:, urn:, data:): only the scheme and escapes
+		scheme = Lower(url.data(), colon);
+		return scheme + ":" + NormalizePercent(url.substr(colon + 1));
+	} else if (url.compare(0, 2, "//") == 0) {
+		out = "//";
+		i = 2;
+	}
+
+	size_t authorityEnd = url.find_first_of("/?#", i);
+	if (authorityEnd == std::string::npos) authorityEnd = url.size();
+	out += NormalizeAuthority(url.substr(i, authorityEnd - i), scheme);
+
+	size_t pathEnd = url.find_first_of("?#", authorityEnd);
+	if (pathEnd == std::string::npos) pathEnd = url.size();
+	std::string path = RemoveDotSegments(NormalizePercent(url.substr(authorityEnd, pathEnd - authorityEnd)));
+	out += path.empty() ? "/" : path;
+
+	// Query and fragment keep their case and order
+	out += NormalizePercent(url.substr(pathEnd));
+	return out;
+}
+
+std::string TextFunctions::NormalizePath(const char* text, size_t length) {
+	std::string path(text, length);
+	bool windows = (length >= 2 && IsAlpha(path[0]) && path[1] == ':') ||
+		path.find('\\') != std::string::npos;
+	return windows ? NormalizeWindowsPath(path) : NormalizePosixPath(path);
+}
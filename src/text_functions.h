@@ -0,0 +1,42 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Text Normalization Functions Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef TEXT_FUNCTIONS_H
+#define TEXT_FUNCTIONS_H
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <string>
+
+/**
+ * TextFunctions - deterministic SQL functions for case-insensitive keys
+ *
+ *   hex_lower(x)           simple Unicode lowercase
+ *   hex_casefold(x)        full Unicode case folding ("Straße" = "strasse")
+ *   hex_normalize_url(x)   RFC 3986 normalization (scheme/host case, percent
+ *                          escapes, dot segments, default ports)
+ *   hex_normalize_path(x)  Windows paths: one separator, dot segments
+ *                          resolved, case folded; POSIX paths keep their case
+ *
+ * ASCII runs are processed 16 bytes at a time (SSE2 / NEON) and only the
+ * non-ASCII code points in between go through the table lookup, so the
+ * functions are cheap enough for generated columns and expression indexes.
+ * Non-text arguments are returned unchanged.
+ */
+class TextFunctions {
+public:
+	// Registers the functions on a connection; returns an SQLite result code
+	static int Register(sqlite3* db);
+
+	// UTF-8 in, UTF-8 out. Invalid sequences are copied through byte by byte.
+	static std::string Lower(const char* text, size_t length);
+	static std::string CaseFold(const char* text, size_t length);
+	static std::string NormalizeUrl(const char* text, size_t length);
+	static std::string NormalizePath(const char* text, size_t length);
+};
+
+#endif // TEXT_FUNCTIONS_H
@@ -0,0 +1,105 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Verbose Trace Hook Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "trace_hook.h"
+
+TraceHook::TraceHook(uint32_t sampleRate)
+	: sampleRate_(sampleRate ? sampleRate : 1)
+	, counter_(0)
+	, dropped_(0)
+	, flushScheduled_(false)
+{
+}
+
+TraceHook* TraceHook::Create(Napi::Env env, Napi::Function callback, uint32_t sampleRate) {
+	TraceHook* hook = new TraceHook(sampleRate);
+	hook->tsfn_ = Napi::ThreadSafeFunction::New(
+		env, callback, "hexcore_sqlite3_verbose", 0, 1, hook,
+		[](Napi::Env, TraceHook* self) { delete self; });
+	// Pending trace output must not keep the process alive
+	hook->tsfn_.Unref(env);
+	return hook;
+}
+
+void TraceHook::Attach(sqlite3* db) {
+	sqlite3_trace_v2(db, SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE, &TraceHook::OnTrace, this);
+}
+
+void TraceHook::Release(sqlite3* db) {
+	if (db) {
+		sqlite3_trace_v2(db, 0, nullptr, nullptr);
+	}
+	inFlight_.clear();
+	// Queued flushes still run; the finalizer deletes the hook afterwards
+	tsfn_.Release();
+}
+
+int TraceHook::OnTrace(unsigned type, void* ctx, void* p, void* x) {
+	TraceHook* self = static_cast<TraceHook*>(ctx);
+	sqlite3_stmt* stmt = static_cast<sqlite3_stmt*>(p);
+
+	if (type == SQLITE_TRACE_STMT) {
+		// Trigger sub-programs report "-- TRIGGER name"; only sample top-level runs
+		const char* sql = static_cast<const char*>(x);
+		if (sql && sql[0] == '-' && sql[1] == '-') return 0;
+		if (self->counter_++ % self->sampleRate_ != 0) return 0;
+
+		char* expanded = sqlite3_expanded_sql(stmt);
+		self->inFlight_[stmt] = expanded ? expanded : (sql ? sql : "");
+		if (expanded) sqlite3_free(expanded);
+		return 0;
+	}
+
+	if (type == SQLITE_TRACE_PROFILE) {
+		if (self->inFlight_.empty()) return 0;
+		auto it = self->inFlight_.find(stmt);
+		if (it == self->inFlight_.end()) return 0;
+
+		Event event{ std::move(it->second), *static_cast<sqlite3_uint64*>(x) };
+		self->inFlight_.erase(it);
+
+		bool schedule = false;
+		{
+			std::lock_guard<std::mutex> lock(self->mutex_);
+			if (self->events_.size() < kMaxBuffered) {
+				self->events_.push_back(std::move(event));
+			} else {
+				self->dropped_++;
+			}
+			if (!self->flushScheduled_) {
+				self->flushScheduled_ = true;
+				schedule = true;
+			}
+		}
+		if (schedule) {
+			self->tsfn_.NonBlockingCall(self, &TraceHook::OnFlush);
+		}
+	}
+	return 0;
+}
+
+void TraceHook::OnFlush(Napi::Env env, Napi::Function callback, TraceHook* hook) {
+	std::vector<Event> batch;
+	uint64_t dropped;
+	{
+		std::lock_guard<std::mutex> lock(hook->mutex_);
+		batch.swap(hook->events_);
+		dropped = hook->dropped_;
+		hook->dropped_ = 0;
+		hook->flushScheduled_ = false;
+	}
+	if (!env || !callback) return;
+
+	for (size_t i = 0; i < batch.size(); i++) {
+		Napi::Object details = Napi::Object::New(env);
+		details.Set("durationNs", Napi::Number::New(env, static_cast<double>(batch[i].durationNs)));
+		if (i == 0 && dropped) {
+			details.Set("dropped", Napi::Number::New(env, static_cast<double>(dropped)));
+		}
+		callback.Call({ Napi::String::New(env, batch[i].sql), details });
+	}
+}
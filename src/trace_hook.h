@@ -0,0 +1,63 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Verbose Trace Hook Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef TRACE_HOOK_H
+#define TRACE_HOOK_H
+
+#include <napi.h>
+#include <sqlite3.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * TraceHook - sampled sqlite3_trace_v2 hook backing the `verbose` option
+ *
+ * SQLITE_TRACE_STMT decides (1-in-N) whether an execution is sampled and
+ * captures its expanded SQL; SQLITE_TRACE_PROFILE completes the event with
+ * the nanosecond duration. Events are buffered natively and delivered to
+ * the JS callback in one batch per event-loop turn through a
+ * ThreadSafeFunction, so sqlite3_step never calls into JS synchronously.
+ *
+ * The hook owns itself once attached: it is deleted by the TSFN finalizer
+ * after Release(), which guarantees queued flushes have drained.
+ */
+class TraceHook {
+public:
+	static TraceHook* Create(Napi::Env env, Napi::Function callback, uint32_t sampleRate);
+
+	void Attach(sqlite3* db);
+	void Release(sqlite3* db);
+
+private:
+	struct Event {
+		std::string sql;
+		uint64_t durationNs;
+	};
+
+	// Upper bound on undelivered events; older ones are kept, newer dropped
+	static constexpr size_t kMaxBuffered = 10000;
+
+	TraceHook(uint32_t sampleRate);
+
+	static int OnTrace(unsigned type, void* ctx, void* p, void* x);
+	static void OnFlush(Napi::Env env, Napi::Function callback, TraceHook* hook);
+
+	Napi::ThreadSafeFunction tsfn_;
+	uint32_t sampleRate_;
+	uint64_t counter_;
+	std::unordered_map<sqlite3_stmt*, std::string> inFlight_;
+
+	std::mutex mutex_;
+	std::vector<Event> events_;
+	uint64_t dropped_;
+	bool flushScheduled_;
+};
+
+#endif // TRACE_HOOK_H
@@ -0,0 +1,706 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * io_uring VFS Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "uring_vfs.h"
+#include <sqlite3.h>
+
+#ifndef __linux__
+
+bool UringVfs::Register() {
+	return false;
+}
+
+#else
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <map>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr unsigned kRingEntries = 64;
+constexpr size_t kStagingSize = 256 * 1024;
+
+// ---------------------------------------------------------------------------
+// Minimal io_uring (no liburing dependency)
+// ---------------------------------------------------------------------------
+
+class Ring {
+public:
+	~Ring() {
+		if (sqes_) munmap(sqes_, sqesSize_);
+		if (cqPtr_ && cqPtr_ != sqPtr_) munmap(cqPtr_, cqSize_);
+		if (sqPtr_) munmap(sqPtr_, sqSize_);
+		if (fd_ >= 0) close(fd_);
+	}
+
+	bool Init(unsigned entries) {
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+		if (fd_ < 0) return false;
+
+		sqSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cqSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (single) sqSize_ = cqSize_ = sqSize_ > cqSize_ ? sqSize_ : cqSize_;
+
+		sqPtr_ = Map(sqSize_, IORING_OFF_SQ_RING);
+		if (!sqPtr_) return false;
+		cqPtr_ = single ? sqPtr_ : Map(cqSize_, IORING_OFF_CQ_RING);
+		if (!cqPtr_) return false;
+		sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+		sqes_ = static_cast<io_uring_sqe*>(Map(sqesSize_, IORING_OFF_SQES));
+		if (!sqes_) return false;
+
+		char* sq = static_cast<char*>(sqPtr_);
+		sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+		sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+		sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+		sqEntries_ = params.sq_entries;
+
+		char* cq = static_cast<char*>(cqPtr_);
+		cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+		cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+		cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+		cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+		return true;
+	}
+
+	bool RegisterBuffer(void* data, size_t size) {
+		iovec iov = { data, size };
+		return syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+	}
+
+	unsigned Capacity() const { return sqEntries_; }
+
+	// Queues one SQE; the caller submits at most Capacity() before Submit()
+	io_uring_sqe* Next() {
+		unsigned tail = *sqTail_ + pending_;
+		unsigned idx = tail & sqMask_;
+		io_uring_sqe* sqe = &sqes_[idx];
+		memset(sqe, 0, sizeof(*sqe));
+		sqArray_[idx] = idx;
+		pending_++;
+		return sqe;
+	}
+
+	// Submits the queued SQEs and waits for all of them; results[user_data]
+	// receives each cqe->res. Returns false if the ring itself failed.
+	bool Submit(int* results) {
+		unsigned count = pending_;
+		pending_ = 0;
+		__atomic_store_n(sqTail_, *sqTail_ + count, __ATOMIC_RELEASE);
+
+		unsigned toSubmit = count;
+		unsigned done = 0;
+		while (done < count) {
+			int rc = static_cast<int>(syscall(__NR_io_uring_enter, fd_, toSubmit, count - done,
+				IORING_ENTER_GETEVENTS, nullptr, 0));
+			if (rc < 0) {
+				if (errno == EINTR) continue;
+				return false;
+			}
+			toSubmit -= static_cast<unsigned>(rc) < toSubmit ? static_cast<unsigned>(rc) : toSubmit;
+
+			unsigned head = *cqHead_;
+			unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+			for (; head != tail; head++) {
+				const io_uring_cqe& cqe = cqes_[head & cqMask_];
+				results[cqe.user_data] = cqe.res;
+				done++;
+			}
+			__atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+		}
+		return true;
+	}
+
+private:
+	void* Map(size_t size, off_t offset) {
+		void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+		return p == MAP_FAILED ? nullptr : p;
+	}
+
+	int fd_ = -1;
+	void* sqPtr_ = nullptr;
+	void* cqPtr_ = nullptr;
+	size_t sqSize_ = 0;
+	size_t cqSize_ = 0;
+	io_uring_sqe* sqes_ = nullptr;
+	size_t sqesSize_ = 0;
+	unsigned* sqTail_ = nullptr;
+	unsigned sqMask_ = 0;
+	unsigned* sqArray_ = nullptr;
+	unsigned sqEntries_ = 0;
+	unsigned pending_ = 0;
+	unsigned* cqHead_ = nullptr;
+	unsigned* cqTail_ = nullptr;
+	unsigned cqMask_ = 0;
+	io_uring_cqe* cqes_ = nullptr;
+};
+
+// ---------------------------------------------------------------------------
+// File state
+// ---------------------------------------------------------------------------
+
+struct Extent {
+	sqlite3_int64 offset;
+	size_t staged;   // position in the staging buffer
+	size_t length;
+};
+
+struct UringState {
+	Ring ring;
+	int fd = -1;                // our own descriptor, see ReleaseFd()
+	dev_t dev = 0;
+	ino_t ino = 0;
+	bool fixed = false;         // staging buffer registered with the ring
+	bool broken = false;        // ring failed: staged writes use pwrite()
+	bool deferWrites = false;   // WAL: always; database: during a checkpoint
+	char* staging = nullptr;
+	size_t used = 0;
+	std::vector<Extent> extents;
+	int deferredError = SQLITE_OK;
+	UringState* wal = nullptr;  // database file: its open WAL
+	UringState* db = nullptr;   // WAL file: its database
+	const char* dbName = nullptr;
+
+	~UringState() { free(staging); }
+};
+
+struct UringFile {
+	sqlite3_file base;
+	sqlite3_file* real;          // unix VFS file, stored right after this struct
+	UringState* state;           // null: plain pass-through
+	bool isWal;
+};
+
+constexpr size_t kFileHeader = (sizeof(UringFile) + 7) & ~static_cast<size_t>(7);
+
+sqlite3_vfs g_vfs;
+sqlite3_vfs* g_parent = nullptr;
+bool g_registered = false;
+
+// Database files by the filename pointer SQLite hands to xOpen; the WAL
+// finds its database through sqlite3_filename_database()
+std::mutex g_filesMutex;
+std::unordered_map<const char*, UringState*> g_databases;
+
+// Closing any descriptor of a file drops every POSIX lock the process holds
+// on it, the unix VFS's included. Our descriptors are therefore only closed
+// once the last hexcore-uring file on that inode has closed (after the unix
+// VFS released its locks). Connections opening the same file through
+// another VFS in the same process are not tracked.
+struct InodeFds {
+	int open = 0;
+	std::vector<int> closing;
+};
+std::map<std::pair<dev_t, ino_t>, InodeFds> g_inodes;
+
+sqlite3_vfs* Parent(sqlite3_vfs*) { return g_parent; }
+UringFile* File(sqlite3_file* file) { return reinterpret_cast<UringFile*>(file); }
+sqlite3_file* Real(sqlite3_file* file) { return File(file)->real; }
+
+// A failed deferred write is reported once, by the next call that flushes
+int TakeDeferredError(UringState* state) {
+	int rc = state->deferredError;
+	state->deferredError = SQLITE_OK;
+	return rc;
+}
+
+// Writes any staged extents; falls back to pwrite() for short or failed
+// ring writes so a ring problem never loses data
+int Flush(UringState* state) {
+	if (state->extents.empty()) return TakeDeferredError(state);
+
+	int results[kRingEntries];
+	size_t first = 0;
+	while (first < state->extents.size()) {
+		size_t count = state->extents.size() - first;
+		if (count > state->ring.Capacity()) count = state->ring.Capacity();
+		for (size_t i = 0; i < count && !state->broken; i++) {
+			const Extent& ext = state->extents[first + i];
+			io_uring_sqe* sqe = state->ring.Next();
+			sqe->opcode = state->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+			sqe->fd = state->fd;
+			sqe->addr = reinterpret_cast<uint64_t>(state->staging + ext.staged);
+			sqe->len = static_cast<uint32_t>(ext.length);
+			sqe->off = static_cast<uint64_t>(ext.offset);
+			sqe->buf_index = 0;
+			sqe->user_data = i;
+			results[i] = -EIO;
+		}
+		if (state->broken || !state->ring.Submit(results)) {
+			state->broken = true;
+			for (size_t i = 0; i < count; i++) results[i] = 0;
+		}
+		for (size_t i = 0; i < count; i++) {
+			const Extent& ext = state->extents[first + i];
+			size_t written = results[i] > 0 ? static_cast<size_t>(results[i]) : 0;
+			while (written < ext.length) {
+				ssize_t n = pwrite(state->fd, state->staging + ext.staged + written,
+					ext.length - written, ext.offset + static_cast<sqlite3_int64>(written));
+				if (n < 0 && errno == EINTR) continue;
+				if (n <= 0) {
+					state->deferredError = SQLITE_IOERR_WRITE;
+					break;
+				}
+				written += static_cast<size_t>(n);
+			}
+		}
+		first += count;
+	}
+	state->extents.clear();
+	state->used = 0;
+	return TakeDeferredError(state);
+}
+
+// Opens our own descriptor for a database or WAL file the unix VFS has
+// opened, and counts it against the inode
+int AcquireFd(const char* name, bool readOnly, dev_t& dev, ino_t& ino) {
+	int fd;
+	do {
+		fd = open(name, (readOnly ? O_RDONLY : O_RDWR) | O_CLOEXEC);
+	} while (fd < 0 && errno == EINTR);
+	if (fd < 0) return -1;
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return -1;
+	}
+	dev = st.st_dev;
+	ino = st.st_ino;
+	std::lock_guard<std::mutex> lock(g_filesMutex);
+	g_inodes[{ dev, ino }].open++;
+	return fd;
+}
+
+// Call only after the unix file was closed: it may still hold locks
+void ReleaseFd(int fd, dev_t dev, ino_t ino) {
+	std::vector<int> closing;
+	{
+		std::lock_guard<std::mutex> lock(g_filesMutex);
+		auto it = g_inodes.find({ dev, ino });
+		if (it == g_inodes.end()) return;
+		it->second.closing.push_back(fd);
+		if (--it->second.open > 0) return;
+		closing.swap(it->second.closing);
+		g_inodes.erase(it);
+	}
+	for (int pending : closing) close(pending);
+}
+
+// Unlinks the file from its database/WAL partner and frees the ring; the
+// descriptor is left to ReleaseFd()
+void DetachState(UringFile* f) {
+	UringState* state = f->state;
+	if (!state) return;
+	{
+		std::lock_guard<std::mutex> lock(g_filesMutex);
+		if (f->isWal) {
+			if (state->db) state->db->wal = nullptr;
+		} else {
+			if (state->wal) state->wal->db = nullptr;
+			g_databases.erase(state->dbName);
+		}
+	}
+	delete state;
+	f->state = nullptr;
+}
+
+int FlushFile(sqlite3_file* file) {
+	UringState* state = File(file)->state;
+	return state ? Flush(state) : SQLITE_OK;
+}
+
+// ---------------------------------------------------------------------------
+// sqlite3_io_methods
+// ---------------------------------------------------------------------------
+
+int FileClose(sqlite3_file* file) {
+	UringFile* f = File(file);
+	int rc = FlushFile(file);
+	int fd = -1;
+	dev_t dev = 0;
+	ino_t ino = 0;
+	if (f->state) {
+		fd = f->state->fd;
+		dev = f->state->dev;
+		ino = f->state->ino;
+	}
+	DetachState(f);
+	int closeRc = f->real->pMethods->xClose(f->real);
+	if (fd >= 0) ReleaseFd(fd, dev, ino);
+	return rc != SQLITE_OK ? rc : closeRc;
+}
+
+int FileRead(sqlite3_file* file, void* buf, int amt, sqlite3_int64 offset) {
+	UringFile* f = File(file);
+	UringState* state = f->state;
+	if (!state) return f->real->pMethods->xRead(f->real, buf, amt, offset);
+
+	int rc = Flush(state);
+	if (rc != SQLITE_OK) return rc;
+	if (state->broken) return f->real->pMethods->xRead(f->real, buf, amt, offset);
+
+	size_t got = 0;
+	size_t want = static_cast<size_t>(amt);
+	while (got < want) {
+		int result = -EIO;
+		io_uring_sqe* sqe = state->ring.Next();
+		sqe->opcode = IORING_OP_READ;
+		sqe->fd = state->fd;
+		sqe->addr = reinterpret_cast<uint64_t>(static_cast<char*>(buf) + got);
+		sqe->len = static_cast<uint32_t>(want - got);
+		sqe->off = static_cast<uint64_t>(offset) + got;
+		sqe->user_data = 0;
+		if (!state->ring.Submit(&result) || result == -EINVAL || result == -EOPNOTSUPP) {
+			// Kernel without IORING_OP_READ: stay on plain unix I/O from now on
+			state->broken = true;
+			return f->real->pMethods->xRead(f->real, buf, amt, offset);
+		}
+		if (result == -EINTR || result == -EAGAIN) continue;
+		if (result < 0) return SQLITE_IOERR_READ;
+		if (result == 0) {
+			memset(static_cast<char*>(buf) + got, 0, want - got);
+			return SQLITE_IOERR_SHORT_READ;
+		}
+		got += static_cast<size_t>(result);
+	}
+	return SQLITE_OK;
+}
+
+int FileWrite(sqlite3_file* file, const void* buf, int amt, sqlite3_int64 offset) {
+	UringFile* f = File(file);
+	UringState* state = f->state;
+	if (!state || !state->deferWrites || static_cast<size_t>(amt) > kStagingSize) {
+		int rc = FlushFile(file);
+		if (rc != SQLITE_OK) return rc;
+		return f->real->pMethods->xWrite(f->real, buf, amt, offset);
+	}
+	if (state->deferredError != SQLITE_OK) return TakeDeferredError(state);
+
+	size_t length = static_cast<size_t>(amt);
+	sqlite3_int64 end = offset + amt;
+	bool adjacent = false;
+	if (!state->extents.empty()) {
+		Extent& last = state->extents.back();
+		adjacent = last.offset + static_cast<sqlite3_int64>(last.length) == offset &&
+			last.staged + last.length == state->used;
+		// Overlapping a staged write would reorder them: flush first
+		for (const Extent& ext : state->extents) {
+			if (offset < ext.offset + static_cast<sqlite3_int64>(ext.length) && ext.offset < end) {
+				adjacent = false;
+				int rc = Flush(state);
+				if (rc != SQLITE_OK) return rc;
+				break;
+			}
+		}
+	}
+	if (state->used + length > kStagingSize ||
+		(!adjacent && state->extents.size() >= state->ring.Capacity())) {
+		int rc = Flush(state);
+		if (rc != SQLITE_OK) return rc;
+		adjacent = false;
+	}
+
+	memcpy(state->staging + state->used, buf, length);
+	if (adjacent) {
+		state->extents.back().length += length;
+	} else {
+		state->extents.push_back({ offset, state->used, length });
+	}
+	state->used += length;
+	return SQLITE_OK;
+}
+
+int FileTruncate(sqlite3_file* file, sqlite3_int64 size) {
+	int rc = FlushFile(file);
+	if (rc != SQLITE_OK) return rc;
+	return Real(file)->pMethods->xTruncate(Real(file), size);
+}
+
+int FileSync(sqlite3_file* file, int flags) {
+	int rc = FlushFile(file);
+	if (rc != SQLITE_OK) return rc;
+	return Real(file)->pMethods->xSync(Real(file), flags);
+}
+
+int FileSize(sqlite3_file* file, sqlite3_int64* size) {
+	int rc = FlushFile(file);
+	if (rc != SQLITE_OK) return rc;
+	return Real(file)->pMethods->xFileSize(Real(file), size);
+}
+
+int FileLock(sqlite3_file* file, int level) {
+	return Real(file)->pMethods->xLock(Real(file), level);
+}
+
+int FileUnlock(sqlite3_file* file, int level) {
+	int rc = FlushFile(file);
+	if (rc != SQLITE_OK) return rc;
+	return Real(file)->pMethods->xUnlock(Real(file), level);
+}
+
+int FileCheckReservedLock(sqlite3_file* file, int* out) {
+	return Real(file)->pMethods->xCheckReservedLock(Real(file), out);
+}
+
+int FileControl(sqlite3_file* file, int op, void* arg) {
+	UringFile* f = File(file);
+	if (f->state && !f->isWal) {
+		if (op == SQLITE_FCNTL_CKPT_START) {
+			f->state->deferWrites = true;
+		} else if (op == SQLITE_FCNTL_CKPT_DONE) {
+			f->state->deferWrites = false;
+			int rc = Flush(f->state);
+			if (rc != SQLITE_OK) return rc;
+		}
+	}
+	if (op == SQLITE_FCNTL_VFSNAME && arg) {
+		char** name = static_cast<char**>(arg);
+		sqlite3_free(*name);
+		*name = sqlite3_mprintf("%s", UringVfs::kName);
+		return SQLITE_OK;
+	}
+	return f->real->pMethods->xFileControl(f->real, op, arg);
+}
+
+int FileSectorSize(sqlite3_file* file) {
+	return Real(file)->pMethods->xSectorSize(Real(file));
+}
+
+int FileDeviceCharacteristics(sqlite3_file* file) {
+	return Real(file)->pMethods->xDeviceCharacteristics(Real(file));
+}
+
+int FileShmMap(sqlite3_file* file, int page, int size, int extend, void volatile** out) {
+	return Real(file)->pMethods->xShmMap(Real(file), page, size, extend, out);
+}
+
+// WAL frames must be on disk before the wal-index points at them
+void FlushWalOf(sqlite3_file* file) {
+	UringState* state = File(file)->state;
+	if (state && state->wal) Flush(state->wal);
+}
+
+int FileShmLock(sqlite3_file* file, int offset, int n, int flags) {
+	FlushWalOf(file);
+	return Real(file)->pMethods->xShmLock(Real(file), offset, n, flags);
+}
+
+void FileShmBarrier(sqlite3_file* file) {
+	FlushWalOf(file);
+	Real(file)->pMethods->xShmBarrier(Real(file));
+}
+
+int FileShmUnmap(sqlite3_file* file, int deleteFlag) {
+	return Real(file)->pMethods->xShmUnmap(Real(file), deleteFlag);
+}
+
+int FileFetch(sqlite3_file* file, sqlite3_int64 offset, int amt, void** out) {
+	sqlite3_file* real = Real(file);
+	if (real->pMethods->iVersion < 3) {
+		*out = nullptr;
+		return SQLITE_OK;
+	}
+	return real->pMethods->xFetch(real, offset, amt, out);
+}
+
+int FileUnfetch(sqlite3_file* file, sqlite3_int64 offset, void* p) {
+	sqlite3_file* real = Real(file);
+	if (real->pMethods->iVersion < 3) return SQLITE_OK;
+	return real->pMethods->xUnfetch(real, offset, p);
+}
+
+const sqlite3_io_methods kFileMethods = {
+	3,
+	FileClose,
+	FileRead,
+	FileWrite,
+	FileTruncate,
+	FileSync,
+	FileSize,
+	FileLock,
+	FileUnlock,
+	FileCheckReservedLock,
+	FileControl,
+	FileSectorSize,
+	FileDeviceCharacteristics,
+	FileShmMap,
+	FileShmLock,
+	FileShmBarrier,
+	FileShmUnmap,
+	FileFetch,
+	FileUnfetch,
+};
+
+UringState* CreateState(const char* name, bool readOnly) {
+	UringState* state = new (std::nothrow) UringState();
+	if (!state) return nullptr;
+	state->fd = AcquireFd(name, readOnly, state->dev, state->ino);
+	if (state->fd < 0) {
+		delete state;
+		return nullptr;
+	}
+	state->staging = static_cast<char*>(aligned_alloc(4096, kStagingSize));
+	if (!state->staging || !state->ring.Init(kRingEntries)) {
+		ReleaseFd(state->fd, state->dev, state->ino);
+		delete state;
+		return nullptr;
+	}
+	// Fixed buffers skip per-I/O page pinning; RLIMIT_MEMLOCK may refuse them
+	state->fixed = state->ring.RegisterBuffer(state->staging, kStagingSize);
+	return state;
+}
+
+// ---------------------------------------------------------------------------
+// sqlite3_vfs
+// ---------------------------------------------------------------------------
+
+int VfsOpen(sqlite3_vfs* vfs, sqlite3_filename name, sqlite3_file* file, int flags, int* outFlags) {
+	UringFile* f = File(file);
+	f->base.pMethods = nullptr;
+	f->real = reinterpret_cast<sqlite3_file*>(reinterpret_cast<char*>(file) + kFileHeader);
+	f->state = nullptr;
+	f->isWal = (flags & SQLITE_OPEN_WAL) != 0;
+
+	int rc = Parent(vfs)->xOpen(Parent(vfs), name, f->real, flags, outFlags);
+	if (rc != SQLITE_OK) {
+		if (f->real->pMethods) f->real->pMethods->xClose(f->real);
+		return rc;
+	}
+	f->base.pMethods = &kFileMethods;
+
+	if (!name || !(flags & (SQLITE_OPEN_MAIN_DB | SQLITE_OPEN_WAL))) return SQLITE_OK;
+	bool readOnly = (flags & SQLITE_OPEN_READONLY) || (outFlags && (*outFlags & SQLITE_OPEN_READONLY));
+	f->state = CreateState(name, readOnly);
+	if (!f->state) return SQLITE_OK;
+
+	std::lock_guard<std::mutex> lock(g_filesMutex);
+	if (f->isWal) {
+		f->state->deferWrites = true;
+		auto it = g_databases.find(sqlite3_filename_database(name));
+		if (it != g_databases.end()) {
+			f->state->db = it->second;
+			it->second->wal = f->state;
+		}
+	} else {
+		f->state->dbName = name;
+		g_databases[name] = f->state;
+	}
+	return SQLITE_OK;
+}
+
+int VfsDelete(sqlite3_vfs* vfs, const char* name, int syncDir) {
+	return Parent(vfs)->xDelete(Parent(vfs), name, syncDir);
+}
+
+int VfsAccess(sqlite3_vfs* vfs, const char* name, int flags, int* out) {
+	return Parent(vfs)->xAccess(Parent(vfs), name, flags, out);
+}
+
+int VfsFullPathname(sqlite3_vfs* vfs, const char* name, int size, char* out) {
+	return Parent(vfs)->xFullPathname(Parent(vfs), name, size, out);
+}
+
+void* VfsDlOpen(sqlite3_vfs* vfs, const char* name) {
+	return Parent(vfs)->xDlOpen(Parent(vfs), name);
+}
+
+void VfsDlError(sqlite3_vfs* vfs, int size, char* out) {
+	Parent(vfs)->xDlError(Parent(vfs), size, out);
+}
+
+void (*VfsDlSym(sqlite3_vfs* vfs, void* handle, const char* symbol))(void) {
+	return Parent(vfs)->xDlSym(Parent(vfs), handle, symbol);
+}
+
+void VfsDlClose(sqlite3_vfs* vfs, void* handle) {
+	Parent(vfs)->xDlClose(Parent(vfs), handle);
+}
+
+int VfsRandomness(sqlite3_vfs* vfs, int size, char* out) {
+	return Parent(vfs)->xRandomness(Parent(vfs), size, out);
+}
+
+int VfsSleep(sqlite3_vfs* vfs, int micros) {
+	return Parent(vfs)->xSleep(Parent(vfs), micros);
+}
+
+int VfsCurrentTime(sqlite3_vfs* vfs, double* out) {
+	return Parent(vfs)->xCurrentTime(Parent(vfs), out);
+}
+
+int VfsGetLastError(sqlite3_vfs* vfs, int size, char* out) {
+	return Parent(vfs)->xGetLastError(Parent(vfs), size, out);
+}
+
+int VfsCurrentTimeInt64(sqlite3_vfs* vfs, sqlite3_int64* out) {
+	return Parent(vfs)->xCurrentTimeInt64(Parent(vfs), out);
+}
+
+// Probes io_uring once: containers often block it with seccomp
+bool RingAvailable() {
+	Ring probe;
+	return probe.Init(4);
+}
+
+} // namespace
+
+// ============================================================================
+// UringVfs
+// ============================================================================
+
+bool UringVfs::Register() {
+	static std::once_flag once;
+	std::call_once(once, [] {
+		const char* mode = getenv("HEXCORE_SQLITE_IO_URING");
+		if (mode && strcmp(mode, "off") == 0) return;
+
+		sqlite3_vfs* parent = sqlite3_vfs_find(nullptr);
+		if (!parent || strncmp(parent->zName, "unix", 4) != 0 || parent->iVersion < 2) return;
+		if (!RingAvailable()) return;
+
+		g_parent = parent;
+		memset(&g_vfs, 0, sizeof(g_vfs));
+		g_vfs.iVersion = 2;
+		g_vfs.szOsFile = static_cast<int>(kFileHeader) + parent->szOsFile;
+		g_vfs.mxPathname = parent->mxPathname;
+		g_vfs.zName = kName;
+		g_vfs.xOpen = VfsOpen;
+		g_vfs.xDelete = VfsDelete;
+		g_vfs.xAccess = VfsAccess;
+		g_vfs.xFullPathname = VfsFullPathname;
+		g_vfs.xDlOpen = VfsDlOpen;
+		g_vfs.xDlError = VfsDlError;
+		g_vfs.xDlSym = VfsDlSym;
+		g_vfs.xDlClose = VfsDlClose;
+		g_vfs.xRandomness = VfsRandomness;
+		g_vfs.xSleep = VfsSleep;
+		g_vfs.xCurrentTime = VfsCurrentTime;
+		g_vfs.xGetLastError = VfsGetLastError;
+		g_vfs.xCurrentTimeInt64 = VfsCurrentTimeInt64;
+		g_registered = sqlite3_vfs_register(&g_vfs, 0) == SQLITE_OK;
+	});
+	return g_registered;
+}
+
+#endif // __linux__
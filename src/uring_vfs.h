@@ -0,0 +1,39 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * io_uring VFS Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef URING_VFS_H
+#define URING_VFS_H
+
+/**
+ * UringVfs - "hexcore-uring", a shim over the default unix VFS that moves
+ * database and WAL page I/O onto a per-file io_uring (Linux only)
+ *
+ * - WAL appends are staged in a registered buffer, coalesced when adjacent,
+ *   and submitted together with IORING_OP_WRITE_FIXED before anything can
+ *   observe them: a read, sync, size query, or the shm barrier SQLite issues
+ *   on the database file before publishing a new WAL header.
+ * - Checkpoint page writes (between SQLITE_FCNTL_CKPT_START and _DONE) are
+ *   batched the same way, so a backfill is one deep submission instead of
+ *   one pwrite per page.
+ * - Reads go through the ring directly into SQLite's buffer, one at a time:
+ *   xRead is synchronous, so only writes gain queue depth.
+ *
+ * The ring uses a descriptor this VFS opens itself next to the unix VFS's
+ * one. Locking, shared memory, mmap and all other files (journals, temp
+ * files) are handled by the unix VFS unchanged. Any ring failure drops the
+ * file back to plain unix I/O.
+ */
+class UringVfs {
+public:
+	static constexpr const char* kName = "hexcore-uring";
+
+	// Registers the VFS (not as default) if io_uring works in this process;
+	// returns false when the kernel, seccomp policy or platform refuses it
+	static bool Register();
+};
+
+#endif // URING_VFS_H
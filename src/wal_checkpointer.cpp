@@ -0,0 +1,149 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Background WAL Checkpointer Implementation
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#include "wal_checkpointer.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+WalCheckpointer* WalCheckpointer::Start(sqlite3* writer, int threshold, int mode, int escalateAfter,
+	int busyTimeout, std::string& error) {
+	const char* filename = sqlite3_db_filename(writer, "main");
+	if (!filename || !filename[0]) {
+		error = "The checkpointer requires an on-disk database";
+		return nullptr;
+	}
+
+	// Same file and VFS as the writer, so both share one WAL and wal-index
+	sqlite3_vfs* vfs = nullptr;
+	sqlite3_file_control(writer, "main", SQLITE_FCNTL_VFS_POINTER, &vfs);
+
+	sqlite3* conn = nullptr;
+	int rc = sqlite3_open_v2(filename, &conn, SQLITE_OPEN_READWRITE, vfs ? vfs->zName : nullptr);
+	if (rc != SQLITE_OK) {
+		error = conn ? sqlite3_errmsg(conn) : "Failed to open the checkpoint connection";
+		sqlite3_close(conn);
+		return nullptr;
+	}
+	// RESTART/TRUNCATE wait for readers through the busy handler
+	sqlite3_busy_timeout(conn, busyTimeout);
+
+	WalCheckpointer* checkpointer = new WalCheckpointer(conn, threshold, mode, escalateAfter);
+	const char* wal = sqlite3_filename_wal(sqlite3_db_filename(conn, "main"));
+	checkpointer->walPath_ = wal ? wal : "";
+	checkpointer->thread_ = std::thread(&WalCheckpointer::Run, checkpointer);
+	return checkpointer;
+}
+
+WalCheckpointer::WalCheckpointer(sqlite3* conn, int threshold, int mode, int escalateAfter)
+	: conn_(conn)
+	, threshold_(threshold)
+	, mode_(mode)
+	, escalateAfter_(escalateAfter)
+	, incomplete_(0)
+	, pending_(false)
+	, stopping_(false)
+	, stats_()
+{}
+
+WalCheckpointer::~WalCheckpointer() {
+	if (thread_.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		wake_.notify_one();
+		thread_.join();
+	}
+	sqlite3_close(conn_);
+}
+
+void WalCheckpointer::Attach(sqlite3* writer) {
+	sqlite3_wal_hook(writer, OnWal, this);
+}
+
+void WalCheckpointer::Stop(sqlite3* writer) {
+	sqlite3_wal_hook(writer, nullptr, nullptr);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	wake_.notify_one();
+	if (thread_.joinable()) thread_.join();
+}
+
+WalCheckpointer::Stats WalCheckpointer::GetStats() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return stats_;
+}
+
+// Runs on the writer's thread after every commit: record and signal only
+int WalCheckpointer::OnWal(void* ctx, sqlite3* /*db*/, const char* dbName, int frames) {
+	if (strcmp(dbName, "main") != 0) return SQLITE_OK;
+	WalCheckpointer* self = static_cast<WalCheckpointer*>(ctx);
+	bool wake = false;
+	{
+		std::lock_guard<std::mutex> lock(self->mutex_);
+		self->stats_.walFrames = frames;
+		if (frames >= self->threshold_ && !self->pending_) {
+			self->pending_ = true;
+			wake = true;
+		}
+	}
+	if (wake) self->wake_.notify_one();
+	return SQLITE_OK;
+}
+
+void WalCheckpointer::Run() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	for (;;) {
+		wake_.wait(lock, [this] { return pending_ || stopping_; });
+		if (stopping_) break;
+		lock.unlock();
+		Checkpoint();
+		lock.lock();
+		pending_ = false;
+	}
+}
+
+void WalCheckpointer::Checkpoint() {
+	int mode = SQLITE_CHECKPOINT_PASSIVE;
+	if (mode_ != SQLITE_CHECKPOINT_PASSIVE && incomplete_ >= escalateAfter_) {
+		mode = mode_;
+	}
+
+	int logFrames = 0;
+	int backfilled = 0;
+	auto start = std::chrono::steady_clock::now();
+	int rc = sqlite3_wal_checkpoint_v2(conn_, "main", mode, &logFrames, &backfilled);
+	if (rc == SQLITE_OK && logFrames < 0) {
+		// The pager only notices WAL mode when it reads the header; a fresh
+		// connection (or one that predates PRAGMA journal_mode) must read first
+		sqlite3_exec(conn_, "PRAGMA schema_version", nullptr, nullptr, nullptr);
+		rc = sqlite3_wal_checkpoint_v2(conn_, "main", mode, &logFrames, &backfilled);
+	}
+	uint64_t durationNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count());
+
+	// A complete pass resets the escalation count (both counts are -1 when
+	// the database is not in WAL mode)
+	bool complete = rc == SQLITE_OK && backfilled >= logFrames;
+	incomplete_ = complete ? 0 : incomplete_ + 1;
+
+	std::error_code ec;
+	uintmax_t walBytes = walPath_.empty() ? 0 : std::filesystem::file_size(walPath_, ec);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	stats_.checkpoints++;
+	if (mode != SQLITE_CHECKPOINT_PASSIVE) stats_.escalations++;
+	if (rc == SQLITE_BUSY) stats_.busy++;
+	stats_.lastDurationNs = durationNs;
+	if (durationNs > stats_.maxDurationNs) stats_.maxDurationNs = durationNs;
+	stats_.totalDurationNs += durationNs;
+	stats_.backfilledFrames = backfilled > 0 ? backfilled : 0;
+	stats_.walBytes = ec ? 0 : static_cast<int64_t>(walBytes);
+}
@@ -0,0 +1,83 @@
+/*
+ * HexCore SQLite3 - Native Node.js Bindings
+ * Background WAL Checkpointer Header
+ * Copyright (c) HikariSystem. All rights reserved.
+ * Licensed under MIT License.
+ */
+
+#ifndef WAL_CHECKPOINTER_H
+#define WAL_CHECKPOINTER_H
+
+#include <sqlite3.h>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * WalCheckpointer - checkpoints a WAL database from a native thread that owns
+ * its own connection, instead of inline in the sqlite3_step that commits past
+ * the auto-checkpoint threshold
+ *
+ * Attach() replaces the writer connection's auto-checkpoint with a
+ * sqlite3_wal_hook that only wakes the thread once the WAL holds `threshold`
+ * frames. The thread runs PASSIVE checkpoints, which never block readers or
+ * writers; after `escalateAfter` consecutive passes that could not backfill
+ * the whole log (readers pinning old frames) it escalates to the configured
+ * RESTART or TRUNCATE mode so the WAL cannot grow without bound.
+ *
+ * Setting PRAGMA wal_autocheckpoint on the writer connection replaces the
+ * hook and returns checkpointing to SQLite.
+ */
+class WalCheckpointer {
+public:
+	struct Stats {
+		uint64_t checkpoints;
+		uint64_t escalations;
+		uint64_t busy;           // checkpoints that returned SQLITE_BUSY
+		uint64_t lastDurationNs;
+		uint64_t maxDurationNs;
+		uint64_t totalDurationNs;
+		int walFrames;           // frames in the WAL at the last commit
+		int backfilledFrames;    // frames copied back by the last checkpoint
+		int64_t walBytes;        // WAL file size after the last checkpoint
+	};
+
+	// mode is SQLITE_CHECKPOINT_PASSIVE (never escalate), _RESTART or _TRUNCATE.
+	// Opens the checkpoint connection on the writer's file and VFS; returns
+	// nullptr and fills error on failure.
+	static WalCheckpointer* Start(sqlite3* writer, int threshold, int mode, int escalateAfter,
+		int busyTimeout, std::string& error);
+	~WalCheckpointer();
+
+	// Installs the wal hook on the writer connection
+	void Attach(sqlite3* writer);
+	// Removes the hook, waits for a running checkpoint and joins the thread
+	void Stop(sqlite3* writer);
+
+	Stats GetStats();
+
+private:
+	WalCheckpointer(sqlite3* conn, int threshold, int mode, int escalateAfter);
+
+	static int OnWal(void* ctx, sqlite3* db, const char* dbName, int frames);
+	void Run();
+	void Checkpoint();
+
+	sqlite3* conn_;
+	std::string walPath_;
+	const int threshold_;
+	const int mode_;
+	const int escalateAfter_;
+	int incomplete_;             // consecutive checkpoints that left frames behind
+
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	bool pending_;
+	bool stopping_;
+	Stats stats_;
+	std::thread thread_;
+};
+
+#endif // WAL_CHECKPOINTER_H
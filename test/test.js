@@ -5,6 +5,10 @@
 
 'use strict';
 
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
 let sqlite;
 try {
 	sqlite = require('..');
@@ -14,10 +18,13 @@ try {
 	process.exit(0);
 }
 
-const { Database, openDatabase, SqliteError } = sqlite;
+const { Database, openDatabase, SqliteError, allocatorStats, pageCacheStats, setPageCacheBudget } = sqlite;
 
 console.log('=== HexCore Better-SQLite3 Test Suite ===\n');
 
+// Async tests register their promise here; the summary waits for all of them
+const asyncTests = [];
+
 // Test openDatabase
 console.log('Testing openDatabase()...');
 const db = openDatabase(':memory:');
@@ -75,6 +82,545 @@ const journalMode = db.pragma('journal_mode', { simple: true });
 console.log(`  Journal mode: ${journalMode}`);
 console.log('  [PASS] pragma works\n');
 
+// Test adviseIndexes
+console.log('Testing adviseIndexes...');
+db.exec('CREATE TABLE hits (id INTEGER PRIMARY KEY, sample TEXT, ts INTEGER)');
+const advice = db.adviseIndexes(['SELECT * FROM hits WHERE sample = ? AND ts > ?']);
+console.assert(advice.indexes.length === 1, 'Should propose one index');
+console.assert(/ON "hits"\("sample", "ts"\)/.test(advice.indexes[0]), 'Index should cover sample, ts');
+console.assert(advice.queries[0].after.some(r => r.detail.includes('USING INDEX')), 'New plan should use the index');
+console.log(`  Proposed: ${advice.indexes[0]}`);
+console.log('  [PASS] adviseIndexes works\n');
+
+// Test profile
+console.log('Testing profile...');
+const profile = db.prepare('SELECT value FROM kv WHERE id > ?').profile(2);
+console.assert(profile.rows === 4, `Expected 4 profiled rows, got ${profile.rows}`);
+console.assert(profile.plan.length > 0 && profile.plan[0].loops === 1, 'Plan should report loop counts');
+console.log(`  ${profile.plan[0].detail}: visited ${profile.plan[0].rowsVisited}, est ${profile.plan[0].estimatedRows}`);
+console.log('  [PASS] profile works\n');
+
+// Test lookaside / hugePages options
+console.log('Testing memory options...');
+const lookasideDb = openDatabase(':memory:', { lookaside: { slotSize: 512, slots: 256 }, hugePages: true });
+lookasideDb.exec('CREATE TABLE t (x); INSERT INTO t VALUES (1), (2), (3)');
+console.assert(lookasideDb.prepare('SELECT sum(x) AS s FROM t').get().s === 6, 'Lookaside connection should work');
+lookasideDb.close();
+const noLookasideDb = openDatabase(':memory:', { lookaside: { slotSize: 512, slots: 0 } });
+console.assert(noLookasideDb.prepare('SELECT 1 AS x').get().x === 1, 'Zero lookaside slots should disable lookaside');
+noLookasideDb.close();
+let memoryOptionError = null;
+try { openDatabase(':memory:', { lookaside: { slotSize: 4, slots: 10 } }); } catch (e) { memoryOptionError = e; }
+console.assert(memoryOptionError instanceof RangeError, 'Should reject a too-small lookaside slot');
+console.log('  [PASS] memory options work\n');
+
+// Test mmapSize with WAL
+console.log('Testing mmapSize...');
+const mmapDbPath = path.join(os.tmpdir(), `hexcore-mmap-${process.pid}.db`);
+const mmapDb = openDatabase(mmapDbPath, { mmapSize: 64 * 1024 * 1024 });
+mmapDb.pragma('journal_mode = WAL');
+console.assert(mmapDb.pragma('mmap_size', { simple: true }) === 64 * 1024 * 1024, 'mmap_size should be applied at open');
+mmapDb.exec('CREATE TABLE b (id INTEGER PRIMARY KEY, data BLOB, body TEXT)');
+const mmapBlob = Buffer.alloc(300000, 0x5a);
+mmapDb.prepare('INSERT INTO b VALUES (1, ?, ?)').run(mmapBlob, 'a\u0000b');
+mmapDb.pragma('wal_checkpoint(TRUNCATE)');
+const mmapRow = mmapDb.prepare('SELECT data, body FROM b WHERE id = 1').get();
+console.assert(mmapRow.data.equals(mmapBlob), 'Blob should round-trip through the mapping');
+console.assert(mmapRow.body === 'a\u0000b', 'Text with an embedded NUL should not be truncated');
+mmapDb.close();
+for (const suffix of ['', '-wal', '-shm']) fs.rmSync(mmapDbPath + suffix, { force: true });
+console.log('  [PASS] mmapSize works\n');
+
+// Test incremental blob I/O
+console.log('Testing openBlob...');
+const blobDb = openDatabase(':memory:');
+blobDb.exec('CREATE TABLE files (id INTEGER PRIMARY KEY, data BLOB)');
+blobDb.prepare('INSERT INTO files (id, data) VALUES (1, zeroblob(?))').run(300000);
+const blobSource = Buffer.alloc(300000);
+for (let i = 0; i < blobSource.length; i++) blobSource[i] = i % 251;
+const writable = blobDb.openBlob('files', 'data', 1, { readonly: false });
+writable.write(0, blobSource.subarray(0, 100000));
+asyncTests.push(new Promise((resolve) => {
+	writable.createWriteStream({ start: 100000 }).end(blobSource.subarray(100000), () => {
+		const readable = blobDb.openBlob('files', 'data', 1);
+		console.assert(readable.length === 300000, 'Blob length should match');
+		console.assert(readable.read(1000, 10).equals(blobSource.subarray(1000, 1010)), 'Partial read should match');
+		const hash = require('crypto').createHash('sha256');
+		readable.createReadStream({ highWaterMark: 16384 }).on('data', (chunk) => hash.update(chunk)).on('end', () => {
+			const expected = require('crypto').createHash('sha256').update(blobSource).digest('hex');
+			console.assert(hash.digest('hex') === expected, 'Streamed blob should hash like the source');
+			let blobError = null;
+			try { readable.write(0, Buffer.alloc(1)); } catch (e) { blobError = e; }
+			console.assert(blobError !== null, 'Readonly blob should reject writes');
+			blobDb.close();
+			console.assert(!readable.open, 'Closing the database should close blob handles');
+			console.log('  [PASS] openBlob works (async)\n');
+			resolve();
+		});
+	});
+}));
+
+// Test io_uring VFS (falls back to the default VFS where unsupported)
+console.log('Testing ioUring...');
+const uringDbPath = path.join(os.tmpdir(), `hexcore-uring-${process.pid}.db`);
+const uringDb = openDatabase(uringDbPath, { ioUring: true });
+uringDb.pragma('journal_mode = WAL');
+uringDb.exec('CREATE TABLE t (id INTEGER PRIMARY KEY, v TEXT)');
+const uringInsert = uringDb.prepare('INSERT INTO t (v) VALUES (?)');
+uringDb.transaction(() => { for (let i = 0; i < 5000; i++) uringInsert.run(`row-${i}`); })();
+uringDb.pragma('wal_checkpoint(TRUNCATE)');
+console.assert(uringDb.pragma('integrity_check', { simple: true }) === 'ok', 'io_uring database should pass integrity_check');
+uringDb.close();
+const uringCheck = openDatabase(uringDbPath, { readonly: true });
+console.assert(uringCheck.prepare('SELECT count(*) AS n FROM t').get().n === 5000, 'Rows written through io_uring should be readable by the default VFS');
+uringCheck.close();
+for (const suffix of ['', '-wal', '-shm']) fs.rmSync(uringDbPath + suffix, { force: true });
+console.log('  [PASS] ioUring works\n');
+
+// Test shared page cache
+console.log('Testing page cache budget...');
+const cacheDbPath = path.join(os.tmpdir(), `hexcore-pcache-${process.pid}.db`);
+const cacheDb = openDatabase(cacheDbPath);
+cacheDb.exec("CREATE TABLE t (id INTEGER PRIMARY KEY, v TEXT); WITH RECURSIVE c(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM c WHERE i < 20000) INSERT INTO t (v) SELECT hex(randomblob(64)) FROM c");
+const installed = setPageCacheBudget(256 * 1024);
+cacheDb.prepare('SELECT count(*) AS n FROM t WHERE v LIKE ?').get('A%');
+const globalCache = pageCacheStats();
+if (installed) {
+	console.assert(globalCache.bytes <= 256 * 1024, 'Budget should bound cached bytes');
+	console.assert(globalCache.evictions > 0, 'Scan should evict pages under a small budget');
+}
+const connCache = cacheDb.cacheStats({ reset: true });
+console.assert(connCache.misses > 0, 'Scan should record cache misses');
+console.assert(cacheDb.cacheStats().misses === 0, 'reset should zero the counters');
+setPageCacheBudget(0);
+cacheDb.close();
+fs.unlinkSync(cacheDbPath);
+const memCacheDb = openDatabase(':memory:');
+memCacheDb.exec("CREATE TABLE t (id INTEGER PRIMARY KEY, v TEXT); WITH RECURSIVE c(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM c WHERE i < 5000) INSERT INTO t (v) SELECT hex(randomblob(64)) FROM c");
+memCacheDb.exec('PRAGMA shrink_memory');
+const memRows = memCacheDb.prepare('SELECT count(*) AS n, sum(length(v)) AS bytes FROM t').get();
+console.assert(memRows.n === 5000 && memRows.bytes === 5000 * 128, 'shrink_memory must not drop in-memory pages');
+memCacheDb.close();
+console.log(`  ${globalCache.pageCache} cache, ${globalCache.evictions} evictions`);
+console.log('  [PASS] page cache budget works\n');
+
+// Test sessions
+console.log('Testing sessions...');
+const primary = openDatabase(':memory:');
+const replica = openDatabase(':memory:');
+for (const conn of [primary, replica]) conn.exec('CREATE TABLE kv (k TEXT PRIMARY KEY, v INTEGER)');
+replica.prepare('INSERT INTO kv VALUES (?, ?)').run('b', 0);
+const session = primary.createSession(['kv']);
+console.assert(session.empty, 'New session should be empty');
+primary.prepare('INSERT INTO kv VALUES (?, ?)').run('a', 1);
+primary.prepare('INSERT INTO kv VALUES (?, ?)').run('b', 2);
+const changeset = session.changeset();
+console.assert(Buffer.isBuffer(changeset) && changeset.length > 0, 'changeset should be a non-empty Buffer');
+console.assert(session.patchset().length <= changeset.length, 'patchset should not be larger than the changeset');
+session.close();
+let seen = [];
+const applied = replica.applyChangeset(changeset, { onConflict: (c) => { seen.push(c); return 'replace'; } });
+console.assert(applied.conflicts === 1 && seen[0].type === 'conflict' && seen[0].table === 'kv', 'Conflicting insert should reach the handler');
+console.assert(replica.prepare('SELECT sum(v) AS s FROM kv').get().s === 3, 'Replica should converge');
+try {
+	replica.applyChangeset(changeset);
+	console.assert(false, 'Default policy should abort on conflict');
+} catch (e) {
+	console.assert(replica.prepare('SELECT count(*) AS n FROM kv').get().n === 2, 'Aborted changeset should be rolled back');
+}
+primary.close();
+replica.close();
+console.log(`  Changeset: ${changeset.length} bytes, ${applied.conflicts} conflict`);
+console.log('  [PASS] sessions work\n');
+
+// Test background checkpointer
+console.log('Testing checkpointer...');
+const walDbPath = path.join(os.tmpdir(), `hexcore-checkpoint-${process.pid}.db`);
+const walDb = openDatabase(walDbPath, { checkpointer: { threshold: 50, mode: 'truncate', escalateAfter: 1 } });
+walDb.pragma('journal_mode = WAL');
+walDb.exec('CREATE TABLE t (id INTEGER PRIMARY KEY, v BLOB)');
+const walInsert = walDb.prepare('INSERT INTO t (v) VALUES (randomblob(4000))');
+const checkpointDeadline = Date.now() + 5000;
+for (let i = 0; i < 2000; i++) walInsert.run();
+let walStats = walDb.checkpointStats();
+while (walStats.checkpoints === 0 && Date.now() < checkpointDeadline) walStats = walDb.checkpointStats();
+console.assert(walStats.checkpoints > 0, 'Checkpoints should run in the background');
+console.assert(walStats.maxDurationNs >= walStats.lastDurationNs, 'Max duration should bound the last one');
+console.assert(openDatabase(':memory:').checkpointStats() === null, 'Stats should be null without the option');
+walDb.close();
+for (const suffix of ['', '-wal', '-shm']) fs.rmSync(walDbPath + suffix, { force: true });
+console.log(`  ${walStats.checkpoints} checkpoints, max ${walStats.maxDurationNs} ns, WAL ${walStats.walBytes} bytes`);
+console.log('  [PASS] checkpointer works\n');
+
+// Test query deadlines
+console.log('Testing query deadlines...');
+const slowDb = openDatabase(':memory:');
+const runaway = slowDb.prepare('WITH RECURSIVE c(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM c) SELECT count(*) AS n FROM c').timeout(50);
+const deadlineStart = Date.now();
+try {
+	runaway.get();
+	console.assert(false, 'Runaway query should be interrupted');
+} catch (e) {
+	console.assert(e.code === 'SQLITE_INTERRUPT', `Expected SQLITE_INTERRUPT, got ${e.code}`);
+}
+const deadlineElapsed = Date.now() - deadlineStart;
+console.assert(deadlineElapsed < 2000, 'Interrupt should fire near the deadline');
+console.assert(slowDb.prepare('SELECT 1 AS x').get().x === 1, 'Connection should stay usable after an interrupt');
+runaway.timeout(null);
+try {
+	slowDb.withDeadline(30, () => runaway.get());
+	console.assert(false, 'Scoped deadline should interrupt');
+} catch (e) {
+	console.assert(e.code === 'SQLITE_INTERRUPT', 'Scoped deadline should surface SQLITE_INTERRUPT');
+}
+const controller = new AbortController();
+const aborted = slowDb.withDeadline({ signal: controller.signal }, async () => {
+	await new Promise(resolve => setImmediate(resolve));
+	return slowDb.prepare('SELECT 1').get();
+});
+controller.abort();
+asyncTests.push(aborted.then(() => console.assert(false, 'Aborted scope should reject'), (e) => {
+	console.assert(e.code === 'SQLITE_INTERRUPT', 'Abort should surface SQLITE_INTERRUPT');
+	console.assert(slowDb.prepare('SELECT 1 AS x').get().x === 1, 'Deadline should be restored after the scope');
+	slowDb.close();
+	console.log(`  Interrupted after ${deadlineElapsed} ms`);
+	console.log('  [PASS] query deadlines work (async)\n');
+}));
+
+// Overlapping async scopes: the short one ends first, the long one after the
+// short deadline has passed; neither may leave an expired deadline behind
+const scopeDb = openDatabase(':memory:');
+const sleep = (ms) => new Promise(resolve => setTimeout(resolve, ms));
+const shortScope = scopeDb.withDeadline(30, () => sleep(5));
+const longScope = scopeDb.withDeadline(10000, () => sleep(80));
+asyncTests.push(Promise.all([shortScope, longScope]).then(() => {
+	console.assert(scopeDb.prepare('SELECT 1 AS x').get().x === 1, 'Out-of-order scopes should not leave an expired deadline');
+	scopeDb.close();
+	console.log('  [PASS] overlapping deadline scopes work (async)\n');
+}));
+
+// Test non-blocking busy mode
+console.log('Testing busyMode...');
+const busyPath = path.join(os.tmpdir(), `hexcore-busy-${process.pid}.db`);
+const holder = openDatabase(busyPath);
+holder.exec('CREATE TABLE t (id INTEGER PRIMARY KEY)');
+const contender = openDatabase(busyPath, { busyMode: 'immediate', timeout: 2000 });
+const busyInsert = contender.prepare('INSERT INTO t DEFAULT VALUES');
+holder.exec('BEGIN IMMEDIATE');
+const busyStart = Date.now();
+try {
+	busyInsert.run();
+	console.assert(false, 'Write should fail while the lock is held');
+} catch (e) {
+	console.assert(e.code === 'SQLITE_BUSY', `Expected SQLITE_BUSY, got ${e.code}`);
+}
+console.assert(Date.now() - busyStart < 500, 'Immediate mode should not sleep in sqlite3_step');
+let loopTurns = 0;
+const ticker = setInterval(() => loopTurns++, 5);
+setTimeout(() => holder.exec('COMMIT'), 50);
+asyncTests.push(contender.retryOnBusy(() => busyInsert.run()).then((result) => {
+	clearInterval(ticker);
+	console.assert(result.changes === 1, 'Retried write should succeed');
+	console.assert(loopTurns > 0, 'Event loop should keep running while retrying');
+	holder.close();
+	contender.close();
+	fs.rmSync(busyPath, { force: true });
+	console.log(`  Write succeeded after ${Date.now() - busyStart} ms, ${loopTurns} loop turns`);
+	console.log('  [PASS] busyMode works (async)\n');
+}));
+
+// Test dedup filter
+console.log('Testing dedupFilter...');
+const dedupDb = openDatabase(':memory:');
+dedupDb.exec('CREATE TABLE ioc (id INTEGER PRIMARY KEY, category TEXT NOT NULL, value_lower TEXT NOT NULL, context TEXT, UNIQUE(category, value_lower))');
+dedupDb.prepare("INSERT INTO ioc (category, value_lower, context) VALUES ('url', 'http://a.example', '')").run();
+const dedupInsert = dedupDb.prepare('INSERT OR IGNORE INTO ioc (category, value_lower, context) VALUES (?, ?, ?)')
+	.dedupFilter({ columns: ['category', 'value_lower'] });
+console.assert(dedupInsert.dedupStats().keys === 1, 'Filter should load existing keys');
+console.assert(dedupInsert.run('url', 'http://a.example', 'dup').changes === 0, 'Existing key should be skipped');
+console.assert(dedupInsert.run('url', 'http://b.example', 'new').changes === 1, 'New key should be inserted');
+console.assert(dedupInsert.run('url', 'http://b.example', 'dup').changes === 0, 'Inserted key should be remembered');
+console.assert(dedupInsert.run('ip', 'http://b.example', 'new').changes === 1, 'Key is the column pair');
+dedupDb.prepare('DELETE FROM ioc WHERE value_lower = ?').run('http://a.example');
+console.assert(dedupInsert.run('url', 'http://a.example', 'again').changes === 1, 'Deleted keys must be insertable again');
+for (const [sql, columns] of [
+	['INSERT INTO ioc (category, value_lower, context) VALUES (?, ?, ?)', ['category', 'value_lower']],
+	['INSERT OR IGNORE INTO ioc (category, value_lower, context) VALUES (?, ?, ?)', ['value_lower']],
+]) {
+	try {
+		dedupDb.prepare(sql).dedupFilter({ columns });
+		console.assert(false, `dedupFilter() should reject ${sql} on ${columns}`);
+	} catch (e) {
+		console.assert(e instanceof TypeError, 'Expected a TypeError');
+	}
+}
+const dedup = dedupInsert.dedupStats();
+console.assert(dedup.rejected === 2 && dedup.falsePositives === 1, `Unexpected stats ${JSON.stringify(dedup)}`);
+console.assert(dedupDb.prepare('SELECT count(*) AS n FROM ioc').get().n === 3, 'Table should hold three keys');
+dedupDb.close();
+console.log(`  ${dedup.rejected} rejected, ${dedup.falsePositives} stale hits re-checked`);
+console.log('  [PASS] dedupFilter works\n');
+
+// Test normalization functions
+console.log('Testing hex_lower / hex_casefold / hex_normalize_*...');
+const textDb = openDatabase(':memory:');
+textDb.exec('CREATE TABLE ioc (category TEXT NOT NULL, value TEXT NOT NULL, value_lower TEXT AS (hex_casefold(value)) STORED, UNIQUE(category, value_lower))');
+const textInsert = textDb.prepare('INSERT OR IGNORE INTO ioc (category, value) VALUES (?, ?)');
+console.assert(textInsert.run('domain', 'Straße.EXAMPLE').changes === 1, 'First key should be inserted');
+console.assert(textInsert.run('domain', 'STRASSE.example').changes === 0, 'Case-folded key should collide');
+const textFn = (sql, ...params) => textDb.prepare(`SELECT ${sql} AS v`).get(...params).v;
+console.assert(textFn('hex_lower(?)', 'HELLO, WORLD! ÀÉÎ İ') === 'hello, world! àéî i', 'hex_lower mismatch');
+console.assert(textFn('hex_lower(?)', 'x'.repeat(40) + 'ABC') === 'x'.repeat(40) + 'abc', 'hex_lower long input mismatch');
+console.assert(textFn('hex_lower(42)') === 42 && textFn('hex_lower(NULL)') === null, 'Non-text values pass through');
+console.assert(textFn('hex_normalize_url(?)', 'HTTP://Evil.COM:80/a/./b/../%7ex?Q=%2f') === 'http://evil.com/a/~x?Q=%2F', 'hex_normalize_url mismatch');
+console.assert(textFn('hex_normalize_path(?)', 'C:/Windows\\System32\\..\\CMD.EXE') === 'c:\\windows\\cmd.exe', 'Windows path mismatch');
+console.assert(textFn('hex_normalize_path(?)', '/usr/./Local/../bin/') === '/usr/bin', 'POSIX path mismatch');
+textDb.exec('CREATE INDEX idx_ioc_url ON ioc (hex_normalize_url(value))');
+textDb.close();
+console.log('  [PASS] normalization functions work\n');
+
+// Test IOC tokenizer
+console.log('Testing registerTokenizer...');
+const ftsDb = openDatabase(':memory:');
+console.assert(ftsDb.registerTokenizer() === ftsDb, 'registerTokenizer should return the database');
+ftsDb.exec("CREATE VIRTUAL TABLE ioc_fts USING fts5(context, tokenize = 'hexioc suffix 3', prefix = '3')");
+const ftsInsert = ftsDb.prepare('INSERT INTO ioc_fts (context) VALUES (?)');
+ftsInsert.run('GET https://C2.Evil.net/beacon?id=%2Fx HTTP/1.1');
+ftsInsert.run('RegSetValue HKLM\\Software\\Microsoft\\Windows\\CurrentVersion\\Run');
+ftsInsert.run('connect 192.168.1.100:443 from 0x401000');
+const ftsQuery = ftsDb.prepare('SELECT rowid FROM ioc_fts WHERE ioc_fts MATCH ? ORDER BY rowid');
+const ftsMatch = { all: (query) => ftsQuery.all(query).map((row) => row.rowid) };
+console.assert(ftsMatch.all('"evil.net/beacon"').join() === '1', 'URL fragment should match as a phrase');
+console.assert(ftsMatch.all('"hklm\\software\\microsoft"').join() === '2', 'Registry prefix should match');
+console.assert(ftsMatch.all('"192.168.1.100"').join() === '3' && ftsMatch.all('168').length === 0, 'IPv4 should be one token');
+console.assert(ftsMatch.all('401000').join() === '3', 'Hex should match without 0x');
+console.assert(ftsMatch.all('eaco*').join() === '1', 'Suffixes should allow infix prefix queries');
+ftsDb.close();
+console.log('  [PASS] registerTokenizer works\n');
+
+// Test bulk lookups
+console.log('Testing getMany...');
+const lookupDb = openDatabase(':memory:');
+lookupDb.exec("CREATE TABLE ioc (id INTEGER PRIMARY KEY, value TEXT UNIQUE); INSERT INTO ioc (value) VALUES ('a.example'), ('b.example')");
+const lookupKeys = ['b.example', 'missing', 'a.example'];
+const lookupFlags = lookupDb.prepare('SELECT 1 FROM ioc WHERE value = ?').getMany(lookupKeys, { mode: 'exists' });
+console.assert(lookupFlags instanceof Uint8Array && lookupFlags.join() === '1,0,1', 'exists mode should return flags');
+const lookupIds = lookupDb.prepare('SELECT id FROM ioc WHERE value = ?').getMany(lookupKeys, { mode: 'pluck' });
+console.assert(lookupIds.length === 3 && lookupIds[0] === 2 && lookupIds[1] === undefined && 1 in lookupIds, 'pluck mode should align with the keys');
+const lookupRows = lookupDb.prepare('SELECT id, value FROM ioc WHERE value = :v').getMany([{ v: 'a.example' }, { v: 'nope' }]);
+console.assert(lookupRows[0].id === 1 && lookupRows[0].value === 'a.example' && lookupRows[1] === undefined, 'row mode should return row objects');
+try {
+	lookupDb.prepare('SELECT id FROM ioc WHERE value = ?').getMany(['a.example', {}, Symbol('x')]);
+	console.assert(false, 'Unbindable keys should throw');
+} catch (e) {
+	console.assert(e instanceof TypeError && e.index === 2, `Unexpected getMany error index ${e.index}`);
+}
+lookupDb.close();
+// The full-scan threshold applies per key, not to the whole batch
+const scanDb = openDatabase(':memory:', { fullScanThreshold: 10 });
+scanDb.exec("CREATE TABLE tags (name TEXT); INSERT INTO tags VALUES ('a'), ('b'), ('c'), ('d'), ('e'), ('f'), ('g'), ('h')");
+scanDb.prepare('SELECT 1 FROM tags WHERE name = ?').getMany(Array.from({ length: 50 }, (_, i) => `k${i}`), { mode: 'exists' });
+console.assert(scanDb.adviseIndexes().queries.length === 0, 'A batch of small scans should not be recorded');
+scanDb.prepare('SELECT count(*) FROM tags a, tags b').get();
+console.assert(scanDb.adviseIndexes().queries.length === 1, 'A large scan should be recorded');
+scanDb.close();
+console.log('  [PASS] getMany works\n');
+
+// Test pipelines
+console.log('Testing pipeline...');
+const pipeDb = openDatabase(':memory:');
+pipeDb.exec('CREATE TABLE ioc (id INTEGER PRIMARY KEY, value TEXT UNIQUE, hits INTEGER DEFAULT 0)');
+const pipeInsert = pipeDb.prepare('INSERT INTO ioc (value) VALUES (?)');
+const pipeTouch = pipeDb.prepare('UPDATE ioc SET hits = hits + 1 WHERE value = :value');
+const pipeGet = pipeDb.prepare('SELECT id, hits FROM ioc WHERE value = ?');
+const pipeAll = pipeDb.prepare('SELECT value FROM ioc ORDER BY id');
+const [inserted, touched, pipeRow, pipeRows, pipeJson] = pipeDb.pipeline([
+	[pipeInsert, ['a.example']],
+	[pipeTouch, { value: 'a.example' }, 'run'],
+	[pipeGet, ['a.example'], 'get'],
+	[pipeAll],
+	[pipeAll, null, 'allJSON'],
+]);
+console.assert(inserted.changes === 1 && touched.changes === 1, 'run steps should return run() info');
+console.assert(pipeRow.hits === 1 && pipeRows.length === 1 && pipeJson === '[{"value":"a.example"}]', 'Steps should see earlier steps');
+try {
+	pipeDb.pipeline([[pipeInsert, ['b.example']], [pipeInsert, ['a.example']], [pipeInsert, ['c.example']]], { transaction: true });
+	console.assert(false, 'A failing step should throw');
+} catch (e) {
+	console.assert(e.code === 'SQLITE_CONSTRAINT_UNIQUE' && e.index === 1, `Unexpected pipeline error ${e.code} ${e.index}`);
+}
+console.assert(pipeAll.all().length === 1 && !pipeDb.inTransaction, 'A failed pipeline transaction should roll back');
+const otherDb = openDatabase(':memory:');
+try {
+	pipeDb.pipeline([[pipeInsert, ['b.example']], [otherDb.prepare('SELECT 1')]]);
+	console.assert(false, 'Foreign statements should be rejected');
+} catch (e) {
+	console.assert(e instanceof TypeError && pipeAll.all().length === 1, 'Nothing should run when a step is invalid');
+}
+otherDb.close();
+pipeDb.close();
+console.log('  [PASS] pipeline works\n');
+
+// Test carray() array parameters
+console.log('Testing carray...');
+const carrayDb = openDatabase(':memory:');
+carrayDb.exec("CREATE TABLE ioc (id INTEGER PRIMARY KEY, value TEXT UNIQUE); WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < 5000) INSERT INTO ioc SELECT x, 'host' || x || '.example' FROM n");
+const byValue = carrayDb.prepare('SELECT id FROM ioc WHERE value IN carray(?) ORDER BY id').raw();
+console.assert(JSON.stringify(byValue.all(['host7.example', 'missing', 'host4999.example'])) === '[[7],[4999]]', 'String arrays should bind to carray()');
+const manyIds = Array.from({ length: 40000 }, (_, i) => i * 2);
+console.assert(carrayDb.prepare('SELECT count(*) AS n FROM ioc WHERE id IN carray(?)').get(manyIds).n === 2500, 'Batches beyond the parameter limit should work');
+console.assert(carrayDb.prepare('SELECT sum(value) AS s FROM carray(?)').get(new Float64Array([0.5, 1.5])).s === 2, 'Float64Array should bind to carray()');
+console.assert(carrayDb.prepare('SELECT count(*) AS n FROM ioc JOIN carray(?) k ON ioc.id = k.value').get(new BigInt64Array([1n, 2n, 9999n])).n === 2, 'BigInt64Array should bind to carray()');
+console.assert(carrayDb.prepare('SELECT count(*) AS n FROM carray(?)').get([]).n === 0, 'Empty arrays should have no rows');
+try {
+	carrayDb.prepare('SELECT * FROM carray(?)').all([1, 'two']);
+	console.assert(false, 'Mixed arrays should be rejected');
+} catch (e) {
+	console.assert(e instanceof TypeError, 'Expected a TypeError');
+}
+for (const value of [[1, 2], new Int32Array([1, 2])]) {
+	try {
+		carrayDb.prepare('SELECT ? AS v').get(value);
+		console.assert(false, 'Arrays outside carray() should be rejected');
+	} catch (e) {
+		console.assert(e instanceof TypeError, 'Expected a TypeError');
+	}
+}
+carrayDb.close();
+console.log('  [PASS] carray works\n');
+
+// Test JSON columns
+console.log('Testing json mode...');
+const jsonColDb = openDatabase(':memory:');
+jsonColDb.exec('CREATE TABLE samples (id INTEGER PRIMARY KEY, meta JSONB, doc JSON, raw BLOB)');
+const sampleMeta = { tags: ['upx', 'packed'], size: 4096, entropy: 7.5, signed: false, parent: null, name: 'a"\u00e9\n' };
+jsonColDb.prepare('INSERT INTO samples (id, meta, doc, raw) VALUES (?, ?, ?, ?)').json().run(1, sampleMeta, '{"ok": [1, 2.5, "x"]}', Buffer.from([1, 2]));
+console.assert(jsonColDb.prepare('SELECT json_valid(meta, 8) AS ok FROM samples').get().ok === 1, 'Objects should be stored as JSONB');
+const sampleRow = jsonColDb.prepare('SELECT meta, doc, raw FROM samples').json().get();
+console.assert(JSON.stringify(sampleRow.meta) === JSON.stringify(sampleMeta), `Unexpected JSONB decode ${JSON.stringify(sampleRow.meta)}`);
+console.assert(sampleRow.doc.ok[1] === 2.5 && Buffer.isBuffer(sampleRow.raw), 'JSON text should decode; other columns stay as they are');
+const sampleTags = jsonColDb.prepare("SELECT meta -> '$.tags' AS tags, 'not json' AS note FROM samples").json(['tags', 'note']).get();
+console.assert(sampleTags.tags[1] === 'packed' && sampleTags.note === 'not json', 'Named columns should decode; invalid JSON stays a string');
+console.assert(typeof jsonColDb.prepare('SELECT meta FROM samples').json().safeIntegers().get().meta.size === 'bigint', 'Integers should follow safeIntegers');
+jsonColDb.prepare('INSERT INTO samples (id, meta) VALUES (?, ?)').json().run(2, { big: 2 ** 60, huge: 1e20 });
+console.assert(jsonColDb.prepare('SELECT json_valid(meta, 8) AS ok FROM samples WHERE id = 2').get().ok === 1, 'Integral doubles past 2^53 should be valid JSONB');
+const bigMeta = jsonColDb.prepare('SELECT meta FROM samples WHERE id = 2').json().get().meta;
+console.assert(bigMeta.big === 2 ** 60 && bigMeta.huge === 1e20, `Unexpected large numbers ${JSON.stringify(bigMeta)}`);
+jsonColDb.close();
+console.log('  [PASS] json mode works\n');
+
+// Test JSON results
+console.log('Testing allJSON/getJSON...');
+const jsonDb = openDatabase(':memory:');
+jsonDb.exec('CREATE TABLE ioc (id INTEGER PRIMARY KEY, value TEXT, score REAL, raw BLOB)');
+jsonDb.prepare('INSERT INTO ioc (value, score, raw) VALUES (?, ?, ?)').run('C:\\Temp\n"x"\u0001\u00e9', 0.1, Buffer.from('hex'));
+jsonDb.prepare('INSERT INTO ioc (value, score, raw) VALUES (?, ?, ?)').run('plain', 3, null);
+const jsonStmt = jsonDb.prepare('SELECT id, value, score, raw FROM ioc ORDER BY id');
+const jsonRows = jsonStmt.all().map(row => ({ ...row, raw: row.raw && row.raw.toString('base64') }));
+console.assert(jsonStmt.allJSON() === JSON.stringify(jsonRows), `Unexpected allJSON ${jsonStmt.allJSON()}`);
+console.assert(jsonStmt.getJSON() === JSON.stringify(jsonRows[0]), 'getJSON should serialize the first row');
+console.assert(jsonDb.prepare('SELECT * FROM ioc WHERE id = ?').getJSON(99) === undefined, 'getJSON should return undefined without a row');
+console.assert(jsonStmt.raw().allJSON() === '[[1,"C:\\\\Temp\\n\\"x\\"\\u0001\u00e9",0.1,"aGV4"],[2,"plain",3,null]]', 'Raw mode should produce arrays');
+console.assert(Buffer.isBuffer(jsonStmt.jsonBuffer().allJSON()), 'jsonBuffer() should return Buffers');
+const realStmt = jsonDb.prepare('SELECT ? AS tiny, ? AS large, ? AS huge, ? AS sum');
+const reals = [1e-7, 1e15, 1.5e300, 0.1 + 0.2];
+console.assert(realStmt.getJSON(...reals) === JSON.stringify(realStmt.get(...reals)), `REALs should match JSON.stringify, got ${realStmt.getJSON(...reals)}`);
+jsonDb.close();
+console.log('  [PASS] allJSON/getJSON works\n');
+
+// Test bulk import
+console.log('Testing importFile...');
+const importDbPath = path.join(os.tmpdir(), `hexcore-import-${process.pid}.db`);
+const importFeed = path.join(os.tmpdir(), `hexcore-import-${process.pid}.ndjson`);
+const importCsv = path.join(os.tmpdir(), `hexcore-import-${process.pid}.csv`);
+const feedLines = [];
+for (let i = 0; i < 5000; i++) feedLines.push(JSON.stringify({ category: 'url', value: `http://host${i}.example/\u00e9"`, offset: i }));
+feedLines.splice(10, 0, '{"category": "url", "value": broken}');
+fs.writeFileSync(importFeed, feedLines.join('\n') + '\n');
+fs.writeFileSync(importCsv, 'category,value,offset\nip,"10.0.0.1",1\nip,"multi\nline ""quoted""",2\nip,10.0.0.1,3\n');
+const importDb = openDatabase(importDbPath);
+importDb.exec('CREATE TABLE ioc (category TEXT NOT NULL, value TEXT NOT NULL, offset INTEGER, UNIQUE(category, value))');
+// The worker connection must resolve the tokenizer used by this trigger
+importDb.registerTokenizer();
+importDb.exec("CREATE VIRTUAL TABLE ioc_fts USING fts5(value, tokenize = 'hexioc'); CREATE TRIGGER ioc_ai AFTER INSERT ON ioc BEGIN INSERT INTO ioc_fts (value) VALUES (new.value); END");
+let importProgress = 0;
+asyncTests.push(importDb.importFile(importFeed, { table: 'ioc', batchSize: 1000, onProgress: () => importProgress++ })
+	.then(() => console.assert(false, 'Malformed line should reject without skipErrors'), (e) => {
+		console.assert(e.line === 11, `Expected the error on line 11, got ${e.line}`);
+		return importDb.importFile(importFeed, { table: 'ioc', skipErrors: true, batchSize: 1000, onProgress: () => importProgress++ });
+	})
+	.then((result) => {
+		console.assert(result.rows === 5000 && result.skipped === 1 && result.errors[0].line === 11, `Unexpected result ${JSON.stringify(result)}`);
+		console.assert(importProgress > 0, 'Progress should be reported');
+		const row = importDb.prepare('SELECT value, offset FROM ioc WHERE offset = 42').get();
+		console.assert(row.value === 'http://host42.example/\u00e9"', 'Escaped strings should be decoded');
+		return importDb.importFile(importCsv, { table: 'ioc', onConflict: 'ignore' });
+	})
+	.then((result) => {
+		console.assert(result.rows === 2 && result.lines === 5, `Unexpected CSV result ${JSON.stringify(result)}`);
+		console.assert(importDb.prepare("SELECT count(*) AS n FROM ioc WHERE value = 'multi\nline \"quoted\"'").get().n === 1, 'Quoted CSV fields should be decoded');
+		console.assert(importDb.prepare('SELECT count(*) AS n FROM ioc_fts').get().n === 5002, 'Triggers should index imported rows with the tokenizer');
+		importDb.close();
+		for (const file of [importDbPath, importFeed, importCsv]) fs.rmSync(file, { force: true });
+		console.log('  [PASS] importFile works (async)\n');
+	}));
+
+// Test streaming export
+console.log('Testing exportTo...');
+const exportDbPath = path.join(os.tmpdir(), `hexcore-export-${process.pid}.db`);
+const exportNdjson = path.join(os.tmpdir(), `hexcore-export-${process.pid}.ndjson`);
+const exportCsv = path.join(os.tmpdir(), `hexcore-export-${process.pid}.csv`);
+const exportDb = openDatabase(exportDbPath);
+exportDb.exec('CREATE TABLE ioc (id INTEGER PRIMARY KEY, value TEXT, score REAL, raw BLOB)');
+const exportInsert = exportDb.prepare('INSERT INTO ioc (value, score, raw) VALUES (?, ?, ?)');
+for (let i = 0; i < 1000; i++) exportInsert.run(`line\n"${i}",\u00e9`, i / 4, i % 2 ? Buffer.from([i & 255, 0]) : null);
+exportDb.registerTokenizer();
+exportDb.exec("CREATE VIRTUAL TABLE ioc_fts USING fts5(value, tokenize = 'hexioc'); INSERT INTO ioc_fts (value) SELECT value FROM ioc");
+const exportQuery = exportDb.prepare('SELECT id, value, score, raw FROM ioc WHERE id > ?');
+try {
+	exportDb.prepare('DELETE FROM ioc').exportTo(exportNdjson);
+	console.assert(false, 'Write statements should not be exportable');
+} catch (e) {
+	console.assert(e instanceof TypeError, 'Expected a TypeError');
+}
+asyncTests.push(exportQuery.exportTo(exportNdjson, { params: [10] })
+	.then((result) => {
+		const lines = fs.readFileSync(exportNdjson, 'utf8').split('\n');
+		console.assert(result.rows === 990 && lines.length === 991 && lines[990] === '', `Unexpected NDJSON result ${JSON.stringify(result)}`);
+		console.assert(result.bytes === fs.statSync(exportNdjson).size, 'Byte count should match the file');
+		const first = JSON.parse(lines[0]);
+		const second = JSON.parse(lines[1]);
+		const expected = exportQuery.get(11);
+		console.assert(first.id === 11 && first.raw === null, 'NULL should be written as null');
+		console.assert(second.id === 12 && second.value === expected.value && second.score === expected.score, 'NDJSON row should round-trip');
+		console.assert(second.raw === expected.raw.toString('base64'), 'BLOBs should be base64');
+		exportInsert.run('', 0, null);
+		return exportQuery.exportTo(exportCsv, { params: [998] });
+	})
+	.then((result) => {
+		const csv = fs.readFileSync(exportCsv, 'utf8');
+		console.assert(result.rows === 3, `Unexpected CSV result ${JSON.stringify(result)}`);
+		console.assert(csv === 'id,value,score,raw\n999,"line\n""998"",\u00e9",249.5,\n1000,"line\n""999"",\u00e9",249.75,5wA=\n1001,"",0,\n', `Unexpected CSV ${JSON.stringify(csv)}`);
+		// The worker connection must resolve the FTS table's tokenizer
+		return exportDb.prepare('SELECT count(*) AS n FROM ioc_fts').exportTo(exportNdjson);
+	})
+	.then(() => {
+		console.assert(fs.readFileSync(exportNdjson, 'utf8') === '{"n":1000}\n', 'exportTo should see registered tokenizers');
+		exportDb.close();
+		for (const file of [exportDbPath, exportNdjson, exportCsv]) fs.rmSync(file, { force: true });
+		console.log('  [PASS] exportTo works (async)\n');
+	}));
+
+// Test allocatorStats
+console.log('Testing allocatorStats...');
+const memStats = allocatorStats();
+console.assert(memStats.classes.length > 0, 'Should report size classes');
+if (memStats.allocator === 'pool') {
+	console.assert(memStats.classes.some(c => c.inUse > 0), 'Open database should hold pool blocks');
+}
+console.log(`  Allocator: ${memStats.allocator}, arena: ${memStats.arenaBytes} bytes`);
+console.log('  [PASS] allocatorStats works\n');
+
 // Test close
 console.log('Testing close...');
 db.close();
@@ -92,4 +638,24 @@ try {
 	console.log('  [PASS] error handling works\n');
 }
 
-console.log('=== All tests passed! ===');
+// Test verbose (trace events are delivered asynchronously, in batches)
+console.log('Testing verbose...');
+const traced = [];
+const db3 = openDatabase(':memory:', { verbose: (sql, details) => traced.push({ sql, details }) });
+db3.prepare('SELECT ?').get(42);
+console.assert(traced.length === 0, 'Verbose should not be called synchronously');
+asyncTests.push(new Promise(resolve => setImmediate(resolve)).then(() => {
+	console.assert(traced.length === 1, `Expected 1 trace event, got ${traced.length}`);
+	console.assert(traced[0].sql === 'SELECT 42', 'Trace should contain expanded SQL');
+	console.assert(typeof traced[0].details.durationNs === 'number', 'Trace should contain durationNs');
+	console.log(`  Traced: ${traced[0].sql} (${traced[0].details.durationNs} ns)`);
+	db3.close();
+	console.log('  [PASS] verbose works\n');
+}));
+
+Promise.all(asyncTests).then(() => {
+	console.log('=== All tests passed! ===');
+}, (e) => {
+	console.error(e);
+	process.exitCode = 1;
+});